@@ -1,5 +1,18 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <float.h>
+#include <math.h>
 #include "Platform.h"
+#include "Renderer.h"
+
+/* a frame's share of the counts, whatever the iteration count */
+#define APP_SLICE_TARGET_MS 12.0
+#define APP_MIN_ITERATION_SLICE 64
+#define APP_MAX_ITERATION_SLICE (1 << 30)
+/* a moving view goes down to one pixel in 8x8 */
+#define APP_MAX_SAMPLE_SHIFT 3
+/* see Renderer_Supersample() */
+#define APP_SUPERSAMPLE_THRESHOLD 2
 
 static bool CompileShader(GLenum ShaderType, const char *ShaderProgram, GLuint *OutShaderID)
 {
@@ -18,6 +31,12 @@ static void ShaderSetVec3(GLint Program, const char *UniformName, const void *Va
     glUniform3fv(Location, Count, Values);
 }
 
+static void ShaderSetVec2(GLint Program, const char *UniformName, const void *Values, int Count)
+{
+    GLint Location = glGetUniformLocation(Program, UniformName);
+    glUniform2fv(Location, Count, Values);
+}
+
 static void ShaderSetFloat(GLint Program, const char *UniformName, const float *Values, int Count)
 {
     GLint Location = glGetUniformLocation(Program, UniformName);
@@ -91,6 +110,22 @@ Out:
     return ShaderProgramID;
 }
 
+/* the uniforms of SupersampleFragmentShader.glsl that stay the same */
+static void SetSupersampleConstants(GLuint Program, const float *ColorPalette, int ColorCount)
+{
+    float SampleOffsets[RENDERER_SUPERSAMPLE_COUNT][2];
+    for (int i = 0; i < RENDERER_SUPERSAMPLE_COUNT; i++)
+    {
+        double OffsetX, OffsetY;
+        Renderer_GetSampleOffset(i, &OffsetX, &OffsetY);
+        SampleOffsets[i][0] = OffsetX;
+        SampleOffsets[i][1] = OffsetY;
+    }
+    glUseProgram(Program);
+    ShaderSetVec2(Program, "u_SampleOffsets", SampleOffsets, RENDERER_SUPERSAMPLE_COUNT);
+    ShaderSetVec3(Program, "u_ColorPalette", ColorPalette, ColorCount);
+}
+
 app_state App_OnEntry(void)
 {
     static float ColorPalette[16][3] = {
@@ -119,20 +154,40 @@ app_state App_OnEntry(void)
     Platform_SetScreenBufferDimensions(Width, Height);
     Platform_SetVSync(false);
     app_state App = { 
-        .WorldLeft = -2.0f,
-        .WorldBottom = -1.0f, 
+        .WorldLeft = BigFix_FromDouble(-2.0),
+        .WorldBottom = BigFix_FromDouble(-1.0), 
         .WorldHeight = 2.0f,
         .WorldWidth = 3.0f,
         .IterationCount = 1024,
+        .SkipsInterior = true,
+        .PeriodicityTolerance = 4.0f,
+        .Supersamples = true,
+        .SupersampleThreshold = APP_SUPERSAMPLE_THRESHOLD,
+        .NeedsRedraw = true,
+        .CpuIterationSlice = 256,
+        .GpuIterationSlice = 16384,
 
         .VertexShaderFileName = "VertexShader.glsl",
         .FragmentShaderFileName = "FragmentShader.glsl",
+        .ColorFragmentShaderFileName = "ColorFragmentShader.glsl",
+        .SupersampleFragmentShaderFileName = "SupersampleFragmentShader.glsl",
         .ColorPalette = (float *)ColorPalette,
         /* TODO: do this dynamically */
         .ColorPaletteCount = STATIC_ARRAY_SIZE(ColorPalette)*3,
     };
     App.ScreenToWorldScaleFactor = App.WorldWidth / Width;
+    App.ZoomBaseScale = App.ScreenToWorldScaleFactor;
+    App.TileCache.BudgetBytes = (size_t)TILE_CACHE_DEFAULT_BUDGET_MB * MB;
+    /* no OpenGL context to speak of, the CPU renderer draws straight into the platform's framebuffer */
+    if (Platform_GetSoftwareFramebuffer().Pixels)
+    {
+        App.IsSoftwareRendered = true;
+        return App;
+    }
     App.ShaderProgramID = LoadShader(App.FragmentShaderFileName, App.VertexShaderFileName);
+    App.ColorShaderProgramID = LoadShader(App.ColorFragmentShaderFileName, App.VertexShaderFileName);
+    App.SupersampleShaderProgramID = LoadShader(App.SupersampleFragmentShaderFileName, App.VertexShaderFileName);
+    SetSupersampleConstants(App.SupersampleShaderProgramID, App.ColorPalette, App.ColorPaletteCount/3);
 
     /* VAO, VBO, EBO */
     float VertexBuffer[] = {
@@ -163,21 +218,44 @@ app_state App_OnEntry(void)
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof Indices, Indices, GL_STATIC_DRAW);
 
         /* data to the gpu */
-        glUseProgram(App.ShaderProgramID);
+        glUseProgram(App.ColorShaderProgramID);
         {
             GLint VertexLocationInVertexShader = 0;
             glVertexAttribPointer(VertexLocationInVertexShader, 3, GL_FLOAT, GL_FALSE, 3*sizeof(float), NULL);
             glEnableVertexAttribArray(VertexLocationInVertexShader);
-            ShaderSetVec3(App.ShaderProgramID, "u_ColorPalette", ColorPalette, STATIC_ARRAY_SIZE(ColorPalette));
+            ShaderSetVec3(App.ColorShaderProgramID, "u_ColorPalette", ColorPalette, STATIC_ARRAY_SIZE(ColorPalette));
         }
     }
     glBindVertexArray(0);
 
+    /* integer textures can't be filtered, and z and the sums must not be either, sized by the first frame */
+    glGenTextures(2, App.IterationTextures);
+    glGenTextures(2, App.StateTextures);
+    glGenTextures(2, App.SumTextures);
+    for (int i = 0; i < 2; i++)
+    {
+        GLuint Textures[3] = { App.IterationTextures[i], App.StateTextures[i], App.SumTextures[i] };
+        for (int k = 0; k < 3; k++)
+        {
+            glBindTexture(GL_TEXTURE_2D, Textures[k]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glGenFramebuffers(2, App.IterationFramebuffers);
+    glGenFramebuffers(2, App.SumFramebuffers);
+    glGenQueries(1, &App.SliceQuery);
+
     return App;
 }
 
 void App_OnExit(app_state *State)
 {
+    Renderer_FreeBuffer(&State->IterationBuffer);
+    TileCache_Free(&State->TileCache);
+    Renderer_FreeSupersampleBuffer(&State->SupersampleBuffer);
+    free(State->SupersamplePixels);
 }
 
 
@@ -187,33 +265,87 @@ const char *App_GetName(app_state *State)
     return "GPUdbrot";
 }
 
+bool8 App_IsIdle(app_state *State)
+{
+    /* held arrows keep changing the iteration count without any new event */
+    return !State->NeedsRedraw
+        && !Platform_IsKeyDown(PLATFORM_KEY_UP_ARROW)
+        && !Platform_IsKeyDown(PLATFORM_KEY_DOWN_ARROW);
+}
+
 
 void App_OnLoop(app_state *State)
 {
-    if (Platform_IsKeyPressed(PLATFORM_KEY_LEFT_SHIFT))
+    if (Platform_IsKeyPressed(PLATFORM_KEY_LEFT_SHIFT) 
+    && !State->IsSoftwareRendered)
     /* reload shader */
     {
         glUseProgram(0);
         glDeleteProgram(State->ShaderProgramID);
-
         State->ShaderProgramID = LoadShader(State->FragmentShaderFileName, State->VertexShaderFileName);
-        glUseProgram(State->ShaderProgramID);
+        /* the iteration shader may have changed, the CPU's counts are still good */
+        if (State->IterationView.Precision == RENDER_PRECISION_FLOAT)
+        {
+            State->HasIterations = false;
+        }
+
+        glDeleteProgram(State->ColorShaderProgramID);
+        State->ColorShaderProgramID = LoadShader(State->ColorFragmentShaderFileName, State->VertexShaderFileName);
+        glUseProgram(State->ColorShaderProgramID);
         /* TODO: do this dynamically */
-        ShaderSetVec3(State->ShaderProgramID, "u_ColorPalette", State->ColorPalette, State->ColorPaletteCount/3);
+        ShaderSetVec3(State->ColorShaderProgramID, "u_ColorPalette", State->ColorPalette, State->ColorPaletteCount/3);
+
+        glDeleteProgram(State->SupersampleShaderProgramID);
+        State->SupersampleShaderProgramID = LoadShader(State->SupersampleFragmentShaderFileName, State->VertexShaderFileName);
+        SetSupersampleConstants(State->SupersampleShaderProgramID, State->ColorPalette, State->ColorPaletteCount/3);
+        State->HasSums = false;
+        State->NeedsRedraw = true;
+    }
+
+    if (Platform_IsKeyPressed(PLATFORM_KEY_I))
+    {
+        State->SkipsInterior = !State->SkipsInterior;
+        State->NeedsRedraw = true;
+    }
+    if (Platform_IsKeyPressed(PLATFORM_KEY_M))
+    {
+        State->RenderMethod = (State->RenderMethod + 1) % RENDER_METHOD_COUNT;
+        State->NeedsRedraw = true;
+    }
+    if (Platform_IsKeyPressed(PLATFORM_KEY_A))
+    {
+        State->Supersamples = !State->Supersamples;
+        State->NeedsRedraw = true;
+    }
+    /* the platform's trace of the last frames, for chrome://tracing */
+    if (Platform_IsKeyPressed(PLATFORM_KEY_T) && !Platform_WriteTrace("trace.json"))
+    {
+        fprintf(stderr, "\nUnable to write 'trace.json'\n");
     }
 
     int NewIterationCount = State->IterationCount + Platform_IsKeyDown(PLATFORM_KEY_UP_ARROW);
     NewIterationCount -= (Platform_IsKeyDown(PLATFORM_KEY_DOWN_ARROW) && State->IterationCount > 0);
     /* can only modify iteration count every 20ms */
-    bool8 CanModifyIterationCount = Platform_GetElapsedTimeMs() - State->TimeSinceLastIterationCountChange > 20.0/1000.0;
+    bool8 CanModifyIterationCount = Platform_GetElapsedTimeMs() - State->TimeSinceLastIterationCountChange > 20.0;
     if (CanModifyIterationCount 
     && NewIterationCount != State->IterationCount)
     {
         State->IterationCount = NewIterationCount;
         State->TimeSinceLastIterationCountChange = Platform_GetElapsedTimeMs();
+        State->NeedsRedraw = true;
+    }
+
+    platform_window_dimensions Window = Platform_GetWindowDimensions();
+    if (Window.Width != State->RedrawWidth || Window.Height != State->RedrawHeight)
+    {
+        State->NeedsRedraw = true;
     }
 
-    Platform_RequestRedraw();
+    /* a still view costs nothing */
+    if (State->NeedsRedraw)
+    {
+        Platform_RequestRedraw();
+    }
 }
 
 
@@ -228,10 +360,29 @@ void App_OnMouseEvent(app_state *State, const mouse_data *Mouse)
         float MouseY = Mouse->Status.Move.Y;
         if (Mouse->Status.Move.IsLeftClicking)
         {
-            float Dx = (MouseX - State->MouseX) * State->ScreenToWorldScaleFactor;
-            float Dy = -(MouseY - State->MouseY) * State->ScreenToWorldScaleFactor;
-            State->WorldLeft -= Dx;
-            State->WorldBottom -= Dy;
+            if (!State->HasPanOrigin)
+            {
+                State->HasPanOrigin = true;
+                State->PanOriginLeft = State->WorldLeft;
+                State->PanOriginBottom = State->WorldBottom;
+                State->PanPixelX = 0;
+                State->PanPixelY = 0;
+            }
+            float Dx = MouseX - State->MouseX + State->PanRemainderX;
+            float Dy = MouseY - State->MouseY + State->PanRemainderY;
+            int PixelDx = floorf(Dx + 0.5f);
+            int PixelDy = floorf(Dy + 0.5f);
+            State->PanRemainderX = Dx - PixelDx;
+            State->PanRemainderY = Dy - PixelDy;
+
+            /* the world moves against the mouse, and the mouse's y goes down */
+            State->PanPixelX -= PixelDx;
+            State->PanPixelY += PixelDy;
+            State->WorldLeft = State->PanOriginLeft;
+            State->WorldBottom = State->PanOriginBottom;
+            BigFix_AddDouble(&State->WorldLeft, State->PanPixelX * State->ScreenToWorldScaleFactor);
+            BigFix_AddDouble(&State->WorldBottom, State->PanPixelY * State->ScreenToWorldScaleFactor);
+            State->NeedsRedraw = State->NeedsRedraw || PixelDx || PixelDy;
         }
         State->MouseX = MouseX;
         State->MouseY = MouseY;
@@ -239,42 +390,479 @@ void App_OnMouseEvent(app_state *State, const mouse_data *Mouse)
     case MOUSE_WHEEL:
     {
         platform_window_dimensions Window = Platform_GetWindowDimensions();
-        float WindowWidth = Window.Width;
-        float WindowHeight = Window.Height;
-
-        float Scale = 1.1;
-        if (!Mouse->Status.Wheel.ScrollTowardUser)
-            Scale = 1.0 / Scale; 
-
-        float MouseX = State->MouseX * State->WorldWidth / WindowWidth + State->WorldLeft;
-        float MouseY = State->WorldHeight - State->MouseY * State->WorldHeight / WindowHeight + State->WorldBottom;
-
-        float ScaledLeft = (State->WorldLeft - MouseX)*Scale + MouseX;
-        float ScaledBottom = (State->WorldBottom - MouseY)*Scale + MouseY;
-        float ScaledWidth = State->WorldWidth * Scale;
-        float ScaledHeight = State->WorldHeight * Scale;
-
-        State->WorldLeft = ScaledLeft;
-        State->WorldBottom = ScaledBottom;
-        State->WorldWidth = ScaledWidth;
-        State->WorldHeight = ScaledHeight;
-        State->ScreenToWorldScaleFactor = State->WorldWidth / WindowWidth;
+        double WindowHeight = Window.Height;
+
+        /* from the zoom level rather than the last scale, so that the tile cache sees the exact same one again */
+        State->ZoomLevel += Mouse->Status.Wheel.ScrollTowardUser? -1 : 1;
+        double NewScreenToWorldScaleFactor = State->ZoomBaseScale * pow(1.1, -State->ZoomLevel);
+        double Scale = NewScreenToWorldScaleFactor / State->ScreenToWorldScaleFactor;
+
+        /* 
+            mouse position relative to the bottom left corner, small enough for a double at any depth,
+            at the scale the view renders at like panning, which WorldWidth/WindowWidth no longer is after a resize
+        */
+        double MouseX = State->MouseX * State->ScreenToWorldScaleFactor;
+        double MouseY = (WindowHeight - State->MouseY) * State->ScreenToWorldScaleFactor;
+
+        /* (Left - Mouse)*Scale + Mouse, with Mouse = Left + MouseX */
+        BigFix_AddDouble(&State->WorldLeft, MouseX*(1.0 - Scale));
+        BigFix_AddDouble(&State->WorldBottom, MouseY*(1.0 - Scale));
+        State->WorldWidth *= Scale;
+        State->WorldHeight *= Scale;
+        State->ScreenToWorldScaleFactor = NewScreenToWorldScaleFactor;
+        /* pixels of the old zoom level are no use to the new one */
+        State->HasPanOrigin = false;
+        State->NeedsRedraw = true;
     } break;
     }
 }
 
+static render_view App_GetRenderView(const app_state *State, int Width, int Height)
+{
+    render_view View = {
+        .ScreenToWorldScaleFactor = State->ScreenToWorldScaleFactor,
+        .WorldLeft = BigFix_ToDouble(&State->WorldLeft),
+        .WorldBottom = BigFix_ToDouble(&State->WorldBottom),
+        .ExactWorldLeft = State->WorldLeft,
+        .ExactWorldBottom = State->WorldBottom,
+        .IterationCount = State->IterationCount,
+        .Width = Width,
+        .Height = Height,
+        .SkipsInterior = State->SkipsInterior,
+        .PeriodicityTolerance = State->PeriodicityTolerance,
+        .Method = State->RenderMethod,
+    };
+    /* counted from the pan origin, every pixel keeps the exact same coordinates while dragging */
+    if (State->HasPanOrigin)
+    {
+        View.WorldLeft = BigFix_ToDouble(&State->PanOriginLeft);
+        View.WorldBottom = BigFix_ToDouble(&State->PanOriginBottom);
+        View.ExactWorldLeft = State->PanOriginLeft;
+        View.ExactWorldBottom = State->PanOriginBottom;
+        View.PixelOffsetX = State->PanPixelX;
+        View.PixelOffsetY = State->PanPixelY;
+    }
+    return View;
+}
+
+/* whether the iteration texture already has every count View needs */
+static bool8 App_HasIterations(const app_state *State, const render_view *View)
+{
+    const render_view *Computed = &State->IterationView;
+    return State->HasIterations
+        && Renderer_IsSameView(Computed, View)
+        && Computed->PixelOffsetX == View->PixelOffsetX
+        && Computed->PixelOffsetY == View->PixelOffsetY
+        && Computed->IterationCount >= View->IterationCount
+        && Computed->SampleShift <= View->SampleShift;
+}
+
+/* the costs the tier is chosen by keep moving, a view still being sliced keeps the one it started with */
+static render_precision App_GetSlicedPrecision(const app_state *State, const render_view *View)
+{
+    render_view Kept = *View;
+    Kept.Precision = State->IterationView.Precision;
+    bool8 IsSlicing = State->HasIterations 
+        && Renderer_IsSameView(&State->IterationView, &Kept)
+        && State->IterationView.IterationCount < View->IterationCount;
+    return IsSlicing? Kept.Precision : View->Precision;
+}
+
+/* View up to Slice iterations past the count its pixels already have, from StartIteration */
+static render_view App_GetSliceView(const render_view *View, int StartIteration, int Slice)
+{
+    render_view SliceView = *View;
+    SliceView.IterationCount = MIN((i64)View->IterationCount, (i64)StartIteration + Slice);
+    return SliceView;
+}
+
+/* toward APP_SLICE_TARGET_MS, by at most a factor of 2 so that one odd frame doesn't throw it off */
+static int App_AdaptIterationSlice(int Slice, double SliceMs)
+{
+    double Factor = MIN(MAX(APP_SLICE_TARGET_MS / MAX(SliceMs, 0.01), 0.5), 2.0);
+    return MIN(MAX(Slice * Factor, APP_MIN_ITERATION_SLICE), APP_MAX_ITERATION_SLICE);
+}
+
+/* the CPU's counts pick up from the buffer's or the tiles', panned or not */
+static int App_GetCpuStartIteration(const app_state *State, const render_view *View)
+{
+    return State->HasIterations && Renderer_IsSameView(&State->IterationView, View)? State->IterationView.IterationCount : 0;
+}
+
+/* zoomed, panned or resized since the last counts, as opposed to only wanting more of them */
+static bool8 App_IsMoving(const app_state *State, const render_view *View)
+{
+    return !State->HasIterations 
+        || !Renderer_IsSameView(&State->IterationView, View)
+        || State->IterationView.PixelOffsetX != View->PixelOffsetX
+        || State->IterationView.PixelOffsetY != View->PixelOffsetY;
+}
+
+/* 
+    The finest samples that still get a moving view to its iteration count within APP_SLICE_TARGET_MS: 
+    coarser when a frame ran out of slice or time before that, finer when 4 times the samples would still take less than half of it.
+*/
+static int App_AdaptSampleShift(int SampleShift, bool8 IsDone, double FrameMs)
+{
+    if (!IsDone || FrameMs > APP_SLICE_TARGET_MS)
+        return MIN(SampleShift + 1, APP_MAX_SAMPLE_SHIFT);
+    if (4.0 * FrameMs < 0.5 * APP_SLICE_TARGET_MS)
+        return MAX(SampleShift - 1, 0);
+    return SampleShift;
+}
+
+/* 
+    Dynamic resolution of the CPU frames: a moving view only iterates the samples of MovingSampleShift, 
+    a still one gets one shift finer every frame, keeping the samples it has, 
+    down to every pixel before it goes any further into the iteration count.
+*/
+static render_view App_GetCpuSliceView(const app_state *State, const render_view *View)
+{
+    render_view SampleView = *View;
+    int StartIteration = App_GetCpuStartIteration(State, View);
+    if (App_IsMoving(State, View))
+    {
+        SampleView.SampleShift = State->MovingSampleShift;
+    }
+    else if (State->IterationView.SampleShift > 0)
+    {
+        /* the new samples only catch up with the others */
+        SampleView.SampleShift = State->IterationView.SampleShift - 1;
+        return App_GetSliceView(&SampleView, StartIteration, 0);
+    }
+    /* the slice is for every pixel, 4 times fewer samples a shift afford 4 times the iterations */
+    i64 Slice = MIN((i64)State->CpuIterationSlice << 2*SampleView.SampleShift, APP_MAX_ITERATION_SLICE);
+    return App_GetSliceView(&SampleView, StartIteration, Slice);
+}
+
+/* 
+    The tile cache goes from the tile under the mouse outward for at most a slice's time, 
+    the tiles it has no time left for keep the last frame's counts reprojected, so that a zoom shows right away.
+*/
+static render_stats App_RenderTiles(app_state *State, const render_view *Slice)
+{
+    platform_window_dimensions Window = Platform_GetWindowDimensions();
+    int FocusX = State->MouseX * Slice->Width / MAX(Window.Width, 1);
+    int FocusY = Slice->Height - 1 - (int)(State->MouseY * Slice->Height / MAX(Window.Height, 1));
+    return TileCache_Render(&State->TileCache, Slice, FocusX, FocusY, APP_SLICE_TARGET_MS);
+}
+
+/* after the CPU frame of Slice, before it becomes IterationView */
+static void App_AdaptCpuSlice(app_state *State, const render_view *View, const render_view *Slice)
+{
+    bool8 IsMoving = App_IsMoving(State, View);
+    /* samples catching up say nothing about the slice */
+    bool8 IsRefining = !IsMoving && Slice->SampleShift < State->IterationView.SampleShift;
+    if (State->RenderStats.IterationCount && !IsRefining)
+    {
+        State->CpuIterationSlice = App_AdaptIterationSlice(State->CpuIterationSlice, State->RenderStats.TimeMs);
+    }
+    /* the tiles the cache already had don't tell what a new view costs */
+    if (IsMoving && State->RenderStats.IterationCount)
+    {
+        bool8 IsDone = Slice->IterationCount >= View->IterationCount && !State->RenderStats.TileSkipCount;
+        State->MovingSampleShift = App_AdaptSampleShift(State->MovingSampleShift, IsDone, State->RenderStats.TimeMs);
+    }
+}
+
+/* the counts of IterationView the CPU computed, bottom row first */
+static const u32 *App_GetCpuIterations(const app_state *State)
+{
+    return TileCache_CanRender(&State->IterationView)? State->TileCache.Iterations : State->IterationBuffer.Iterations;
+}
+
+/* whether SumTextures are the samples of View, as far as they got */
+static bool8 App_HasSums(const app_state *State, const render_view *View)
+{
+    const render_view *Summed = &State->SumView;
+    return State->HasSums
+        && Renderer_IsSameView(Summed, View)
+        && Summed->PixelOffsetX == View->PixelOffsetX
+        && Summed->PixelOffsetY == View->PixelOffsetY
+        && Summed->IterationCount == View->IterationCount;
+}
+
+/* 
+    More samples of the pixels at the edges of a view that has all its counts, for about a slice's time: 
+    the shader takes the float views' a few samples a pass, the CPU the others' into SupersampleBuffer.
+*/
+static void App_Supersample(app_state *State, const render_view *View)
+{
+    if (!App_HasSums(State, View))
+    {
+        State->HasSums = true;
+        State->SumView = *View;
+        State->SumSampleIndex = 0;
+    }
+    if (View->Precision == RENDER_PRECISION_FLOAT)
+    {
+        /* every sample of a refined pixel costs up to the iteration count, a pass takes about a slice of them */
+        GLint FirstSample = State->SumSampleIndex;
+        GLint SampleCount = MAX(State->GpuIterationSlice / MAX(View->IterationCount, 1), 1);
+        GLint IterationCount = View->IterationCount;
+        GLint Threshold = State->SupersampleThreshold;
+        GLint SkipsInterior = View->SkipsInterior;
+        float PeriodicityTolerance = View->PeriodicityTolerance * FLT_EPSILON;
+        float ScreenToWorldScaleFactor = View->ScreenToWorldScaleFactor;
+        float WorldBottom = View->WorldBottom + View->PixelOffsetY * View->ScreenToWorldScaleFactor;
+        float WorldLeft = View->WorldLeft + View->PixelOffsetX * View->ScreenToWorldScaleFactor;
+        int LastIndex = State->SumTextureIndex;
+        int NextIndex = !LastIndex;
+        State->RenderStats = (render_stats) {
+            .Precision = RENDER_PRECISION_FLOAT,
+            .OnGpu = true,
+        };
+        glBindFramebuffer(GL_FRAMEBUFFER, State->SumFramebuffers[NextIndex]);
+        glUseProgram(State->SupersampleShaderProgramID);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, State->IterationTextures[State->IterationTextureIndex]);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, State->SumTextures[LastIndex]);
+        GLint TextureUnits[2] = { 0, 1 };
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_Iterations", &TextureUnits[0], 1);
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_LastSums", &TextureUnits[1], 1);
+        ShaderSetFloat(State->SupersampleShaderProgramID, "u_ScreenToWorldScaleFactor", &ScreenToWorldScaleFactor, 1);
+        ShaderSetFloat(State->SupersampleShaderProgramID, "u_WorldBottom", &WorldBottom, 1);
+        ShaderSetFloat(State->SupersampleShaderProgramID, "u_WorldLeft", &WorldLeft, 1);
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_IterationCount", &IterationCount, 1);
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_SkipsInterior", &SkipsInterior, 1);
+        ShaderSetFloat(State->SupersampleShaderProgramID, "u_PeriodicityTolerance", &PeriodicityTolerance, 1);
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_FirstSample", &FirstSample, 1);
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_SampleCount", &SampleCount, 1);
+        ShaderSetInt(State->SupersampleShaderProgramID, "u_Threshold", &Threshold, 1);
+        glDrawElements(GL_TRIANGLES, 2*3, GL_UNSIGNED_INT, NULL);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glActiveTexture(GL_TEXTURE0);
+        State->SumTextureIndex = NextIndex;
+        State->SumSampleIndex = MIN(FirstSample + SampleCount, RENDERER_SUPERSAMPLE_COUNT);
+    }
+    else
+    {
+        size_t PixelCount = (size_t)View->Width * View->Height;
+        State->SupersamplePixels = realloc(State->SupersamplePixels, PixelCount * sizeof(u32));
+        ASSERT(State->SupersamplePixels, "Out of memory");
+        bool8 IsDone = Renderer_Supersample(&State->SupersampleBuffer, App_GetCpuIterations(State), View, State->SupersampleThreshold, 
+            State->ColorPalette, State->ColorPaletteCount/3, State->SupersamplePixels, APP_SLICE_TARGET_MS);
+        State->RenderStats = Renderer_GetStats();
+        State->SumSampleIndex = IsDone? RENDERER_SUPERSAMPLE_COUNT : State->SupersampleBuffer.SampleIndex;
+
+        /* straight into the float sums, an alpha of 1 being a count of 1, the framebuffer's row 0 being the top one */
+        glBindTexture(GL_TEXTURE_2D, State->SumTextures[State->SumTextureIndex]);
+        for (int y = 0; y < View->Height; y++)
+        {
+            const u32 *Row = State->SupersamplePixels + (size_t)(View->Height - 1 - y) * View->Width;
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, View->Width, 1, GL_RGBA, GL_UNSIGNED_BYTE, Row);
+        }
+    }
+}
+
 void App_OnRedrawRequest(app_state *State, int Width, int Height)
 {
-    glUseProgram(State->ShaderProgramID);
+    State->NeedsRedraw = false;
+    State->RedrawWidth = Width;
+    State->RedrawHeight = Height;
+    render_view View = App_GetRenderView(State, Width, Height);
+    if (State->IsSoftwareRendered)
+    {
+        platform_framebuffer Framebuffer = Platform_GetSoftwareFramebuffer();
+        View.Width = Framebuffer.Width;
+        View.Height = Framebuffer.Height;
+        View.Precision = Renderer_ChoosePrecision(&View, RENDER_PRECISION_FLOAT);
+        View.Precision = App_GetSlicedPrecision(State, &View);
+        /* a view with every count only takes more samples, or only gets colored once it has them */
+        if (State->Supersamples && App_HasIterations(State, &View))
+        {
+            Platform_BeginScope("samples");
+            bool8 IsDone = Renderer_Supersample(&State->SupersampleBuffer, App_GetCpuIterations(State), &View, State->SupersampleThreshold, 
+                State->ColorPalette, State->ColorPaletteCount/3, Framebuffer.Pixels, APP_SLICE_TARGET_MS);
+            State->RenderStats = Renderer_GetStats();
+            Platform_EndScope();
+            State->NeedsRedraw = !IsDone;
+            return;
+        }
+        render_view Slice = App_GetCpuSliceView(State, &View);
+        Platform_BeginScope("software render");
+        if (TileCache_CanRender(&Slice))
+        {
+            State->RenderStats = App_RenderTiles(State, &Slice);
+            Renderer_ColorIterations(State->TileCache.Iterations, &Slice, State->ColorPalette, State->ColorPaletteCount/3, Framebuffer.Pixels);
+        }
+        else
+        {
+            Renderer_Render(&State->IterationBuffer, &Slice, State->ColorPalette, State->ColorPaletteCount/3, Framebuffer.Pixels);
+            State->RenderStats = Renderer_GetStats();
+        }
+        Platform_EndScope();
+        App_AdaptCpuSlice(State, &View, &Slice);
+        State->IterationView = Slice;
+        /* skipped tiles only had placeholders, the next frame takes the view again */
+        State->HasIterations = !State->RenderStats.TileSkipCount;
+        State->NeedsRedraw = Slice.IterationCount < View.IterationCount || Slice.SampleShift > 0 || !State->HasIterations
+            || State->Supersamples;
+        return;
+    }
+
+    if (State->IterationTextureWidth != Width || State->IterationTextureHeight != Height)
+    {
+        GLenum DrawBuffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        for (int i = 0; i < 2; i++)
+        {
+            glBindTexture(GL_TEXTURE_2D, State->IterationTextures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, Width, Height, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, NULL);
+            glBindTexture(GL_TEXTURE_2D, State->StateTextures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, Width, Height, 0, GL_RGBA, GL_FLOAT, NULL);
+            glBindFramebuffer(GL_FRAMEBUFFER, State->IterationFramebuffers[i]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, State->IterationTextures[i], 0);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, State->StateTextures[i], 0);
+            glDrawBuffers(2, DrawBuffers);
+
+            glBindTexture(GL_TEXTURE_2D, State->SumTextures[i]);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32F, Width, Height, 0, GL_RGBA, GL_FLOAT, NULL);
+            glBindFramebuffer(GL_FRAMEBUFFER, State->SumFramebuffers[i]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, State->SumTextures[i], 0);
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        State->IterationTextureWidth = Width;
+        State->IterationTextureHeight = Height;
+        State->HasIterations = false;
+        State->HasSums = false;
+    }
     glViewport(0, 0, Width, Height);
     glBindVertexArray(State->VAO);
 
-    ShaderSetFloat(State->ShaderProgramID, "u_ScreenToWorldScaleFactor", &State->ScreenToWorldScaleFactor, 1);
-    ShaderSetFloat(State->ShaderProgramID, "u_WorldBottom", &State->WorldBottom, 1);
-    ShaderSetFloat(State->ShaderProgramID, "u_WorldLeft", &State->WorldLeft, 1);
-    ShaderSetInt(State->ShaderProgramID, "u_IterationCount", &State->IterationCount, 1);
+    /* the shader is the cheapest float there is, only pay for the CPU when it can't resolve the view */
+    View.Precision = Renderer_ChoosePrecision(&View, RENDER_PRECISION_FLOAT);
+    if (View.Precision != RENDER_PRECISION_FLOAT)
+    {
+        View.Precision = Renderer_ChoosePrecision(&View, RENDER_PRECISION_DOUBLE);
+    }
+    View.Precision = App_GetSlicedPrecision(State, &View);
 
-    glDrawElements(GL_TRIANGLES, 2*3, GL_UNSIGNED_INT, NULL);
-}
+    /* the last slice's time, once the GPU got to it */
+    if (State->IsSliceQueryPending)
+    {
+        GLint IsAvailable = 0;
+        glGetQueryObjectiv(State->SliceQuery, GL_QUERY_RESULT_AVAILABLE, &IsAvailable);
+        if (IsAvailable)
+        {
+            GLuint64 SliceNs = 0;
+            glGetQueryObjectui64v(State->SliceQuery, GL_QUERY_RESULT, &SliceNs);
+            State->GpuIterationSlice = App_AdaptIterationSlice(State->QueriedSlice, SliceNs * 1e-6);
+            State->IsSliceQueryPending = false;
+        }
+    }
 
+    /* stage one: escape counts, a slice of them, only when the view or a higher iteration count needs them */
+    if (!App_HasIterations(State, &View))
+    {
+        Platform_BeginScope("iterations");
+        render_view Slice;
+        if (View.Precision == RENDER_PRECISION_FLOAT)
+        {
+            /* the shader can only pick up where it stopped, it can't scroll its textures */
+            bool8 StartsOver = !State->HasIterations
+                || !Renderer_IsSameView(&State->IterationView, &View)
+                || State->IterationView.PixelOffsetX != View.PixelOffsetX
+                || State->IterationView.PixelOffsetY != View.PixelOffsetY;
+            GLint StartIteration = StartsOver? 0 : State->IterationView.IterationCount;
+            Slice = App_GetSliceView(&View, StartIteration, State->GpuIterationSlice);
+            int LastIndex = State->IterationTextureIndex;
+            int NextIndex = !LastIndex;
+
+            float ScreenToWorldScaleFactor = View.ScreenToWorldScaleFactor;
+            float WorldBottom = View.WorldBottom + View.PixelOffsetY * View.ScreenToWorldScaleFactor;
+            float WorldLeft = View.WorldLeft + View.PixelOffsetX * View.ScreenToWorldScaleFactor;
+            State->RenderStats = (render_stats) {
+                .Precision = RENDER_PRECISION_FLOAT,
+                .OnGpu = true,
+            };
+            glBindFramebuffer(GL_FRAMEBUFFER, State->IterationFramebuffers[NextIndex]);
+            glUseProgram(State->ShaderProgramID);
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, State->IterationTextures[LastIndex]);
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, State->StateTextures[LastIndex]);
+            GLint TextureUnits[2] = { 0, 1 };
+            ShaderSetInt(State->ShaderProgramID, "u_LastIterations", &TextureUnits[0], 1);
+            ShaderSetInt(State->ShaderProgramID, "u_LastState", &TextureUnits[1], 1);
+            ShaderSetFloat(State->ShaderProgramID, "u_ScreenToWorldScaleFactor", &ScreenToWorldScaleFactor, 1);
+            ShaderSetFloat(State->ShaderProgramID, "u_WorldBottom", &WorldBottom, 1);
+            ShaderSetFloat(State->ShaderProgramID, "u_WorldLeft", &WorldLeft, 1);
+            ShaderSetInt(State->ShaderProgramID, "u_StartIteration", &StartIteration, 1);
+            ShaderSetInt(State->ShaderProgramID, "u_IterationCount", &Slice.IterationCount, 1);
+            GLint StartsOverValue = StartsOver;
+            ShaderSetInt(State->ShaderProgramID, "u_StartsOver", &StartsOverValue, 1);
+            GLint SkipsInterior = View.SkipsInterior;
+            ShaderSetInt(State->ShaderProgramID, "u_SkipsInterior", &SkipsInterior, 1);
+            float PeriodicityTolerance = View.PeriodicityTolerance * FLT_EPSILON;
+            ShaderSetFloat(State->ShaderProgramID, "u_PeriodicityTolerance", &PeriodicityTolerance, 1);
+            /* one query at a time, the frames in between keep the slice they have */
+            bool8 IsTimed = !State->IsSliceQueryPending;
+            if (IsTimed)
+            {
+                glBeginQuery(GL_TIME_ELAPSED, State->SliceQuery);
+            }
+            glDrawElements(GL_TRIANGLES, 2*3, GL_UNSIGNED_INT, NULL);
+            if (IsTimed)
+            {
+                glEndQuery(GL_TIME_ELAPSED);
+                State->IsSliceQueryPending = true;
+                State->QueriedSlice = State->GpuIterationSlice;
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            State->IterationTextureIndex = NextIndex;
+        }
+        else
+        {
+            Slice = App_GetCpuSliceView(State, &View);
+            /* same layout as the texture, bottom row first */
+            const u32 *Iterations = State->IterationBuffer.Iterations;
+            if (TileCache_CanRender(&Slice))
+            {
+                State->RenderStats = App_RenderTiles(State, &Slice);
+                Iterations = State->TileCache.Iterations;
+            }
+            else
+            {
+                Renderer_RenderIterations(&State->IterationBuffer, &Slice);
+                State->RenderStats = Renderer_GetStats();
+            }
+            App_AdaptCpuSlice(State, &View, &Slice);
+            glBindTexture(GL_TEXTURE_2D, State->IterationTextures[State->IterationTextureIndex]);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, Width, Height, GL_RED_INTEGER, GL_UNSIGNED_INT, Iterations);
+        }
+        State->IterationView = Slice;
+        State->HasIterations = !State->RenderStats.TileSkipCount;
+        State->NeedsRedraw = Slice.IterationCount < View.IterationCount || Slice.SampleShift > 0 || !State->HasIterations
+            || State->Supersamples;
+        Platform_EndScope();
+    }
+    /* stage one and a half: the edges of a view with every count take more samples, a slice at a time */
+    else if (State->Supersamples 
+    && !(App_HasSums(State, &View) && State->SumSampleIndex == RENDERER_SUPERSAMPLE_COUNT))
+    {
+        Platform_BeginScope("samples");
+        App_Supersample(State, &View);
+        State->NeedsRedraw = State->SumSampleIndex < RENDERER_SUPERSAMPLE_COUNT;
+        Platform_EndScope();
+    }
 
+    /* stage two: colors, cheap enough for every frame, pixels still iterating are as black as the inside */
+    Platform_BeginScope("colors");
+    GLint TextureUnit = 0;
+    GLint SumTextureUnit = 1;
+    GLint ColoredIterationCount = MIN(View.IterationCount, State->IterationView.IterationCount);
+    GLint HasSums = State->Supersamples && App_HasSums(State, &View);
+    glUseProgram(State->ColorShaderProgramID);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, State->IterationTextures[State->IterationTextureIndex]);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, State->SumTextures[State->SumTextureIndex]);
+    glActiveTexture(GL_TEXTURE0);
+    ShaderSetInt(State->ColorShaderProgramID, "u_Iterations", &TextureUnit, 1);
+    ShaderSetInt(State->ColorShaderProgramID, "u_Sums", &SumTextureUnit, 1);
+    ShaderSetInt(State->ColorShaderProgramID, "u_HasSums", &HasSums, 1);
+    ShaderSetInt(State->ColorShaderProgramID, "u_IterationCount", &ColoredIterationCount, 1);
+    glDrawElements(GL_TRIANGLES, 2*3, GL_UNSIGNED_INT, NULL);
+    Platform_EndScope();
+}
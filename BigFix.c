@@ -0,0 +1,432 @@
+
+#include <math.h>
+#include "BigFix.h"
+
+
+typedef void bigfix_mul_fn(u32 *Out, const u32 *A, const u32 *B);
+typedef void bigfix_sqr_fn(u32 *Out, const u32 *A);
+
+static int sBigFix_LimbCount; /* 0 picks by the scale */
+
+
+static bool8 BigFix_IsNegative(const bigfix *A)
+{
+    return A->Limbs[BIGFIX_LIMB_COUNT - 1] >> 31;
+}
+
+static void BigFix_Negate(bigfix *A)
+{
+    /* ~A + 1 */
+    u64 Carry = 1;
+    for (int i = 0; i < BIGFIX_LIMB_COUNT; i++)
+    {
+        u64 Sum = (u64)(u32)~A->Limbs[i] + Carry;
+        A->Limbs[i] = Sum;
+        Carry = Sum >> 32;
+    }
+}
+
+
+bigfix BigFix_FromDouble(double Value)
+{
+    bigfix Result = { 0 };
+    bool8 IsNegative = Value < 0;
+    Value = AbsF(Value);
+    if (Value == 0 || Value != Value)
+        return Result;
+
+    /* Value = Mantissa * 2^(Exponent - 53), place the 53 mantissa bits one by one */
+    int Exponent;
+    double Fraction = frexp(Value, &Exponent);
+    u64 Mantissa = ldexp(Fraction, 53);
+    int LowestBit = Exponent - 53 + 32*BIGFIX_FRACTION_LIMB_COUNT;
+    for (int i = 0; i < 53; i++)
+    {
+        int Bit = LowestBit + i;
+        if ((Mantissa >> i & 1) && IN_RANGE(0, Bit, 32*BIGFIX_LIMB_COUNT - 2))
+        {
+            Result.Limbs[Bit / 32] |= (u32)1 << (Bit % 32);
+        }
+    }
+
+    if (IsNegative)
+        BigFix_Negate(&Result);
+    return Result;
+}
+
+double BigFix_ToDouble(const bigfix *A)
+{
+    bigfix Abs = *A;
+    bool8 IsNegative = BigFix_IsNegative(A);
+    if (IsNegative)
+        BigFix_Negate(&Abs);
+
+    /* only the 3 most significant nonzero limbs can land in the mantissa */
+    double Result = 0;
+    int UsedLimbCount = 0;
+    for (int i = BIGFIX_LIMB_COUNT - 1; i >= 0 && UsedLimbCount < 3; i--)
+    {
+        if (Abs.Limbs[i] || UsedLimbCount)
+        {
+            Result += ldexp(Abs.Limbs[i], 32*(i - BIGFIX_FRACTION_LIMB_COUNT));
+            UsedLimbCount++;
+        }
+    }
+    return IsNegative? -Result : Result;
+}
+
+bool8 BigFix_FromString(bigfix *Out, const char *String)
+{
+    const char *Ptr = String;
+    bool8 IsNegative = *Ptr == '-';
+    if (*Ptr == '-' || *Ptr == '+')
+        Ptr++;
+
+    i64 IntegerPart = 0;
+    int DigitCount = 0;
+    for (; IN_RANGE('0', *Ptr, '9'); Ptr++, DigitCount++)
+    {
+        IntegerPart = IntegerPart*10 + (*Ptr - '0');
+    }
+
+    const char *FractionDigits = NULL;
+    int FractionDigitCount = 0;
+    if (*Ptr == '.')
+    {
+        FractionDigits = ++Ptr;
+        for (; IN_RANGE('0', *Ptr, '9'); Ptr++)
+            FractionDigitCount++;
+    }
+    if (*Ptr != '\0' || DigitCount + FractionDigitCount == 0 || IntegerPart > INT32_MAX)
+        return false;
+
+    /* Fraction = (d0 + (d1 + (d2 + ...)/10)/10)/10, starting from the last digit */
+    bigfix Result = { 0 };
+    for (int k = FractionDigitCount - 1; k >= 0; k--)
+    {
+        Result.Limbs[BIGFIX_LIMB_COUNT - 1] = FractionDigits[k] - '0';
+        u64 Remainder = 0;
+        for (int i = BIGFIX_LIMB_COUNT - 1; i >= 0; i--)
+        {
+            u64 Dividend = Remainder << 32 | Result.Limbs[i];
+            Result.Limbs[i] = Dividend / 10;
+            Remainder = Dividend % 10;
+        }
+    }
+    Result.Limbs[BIGFIX_LIMB_COUNT - 1] = IntegerPart;
+
+    if (IsNegative)
+        BigFix_Negate(&Result);
+    *Out = Result;
+    return true;
+}
+
+
+void BigFix_Add(bigfix *Out, const bigfix *A, const bigfix *B)
+{
+    u64 Carry = 0;
+    for (int i = 0; i < BIGFIX_LIMB_COUNT; i++)
+    {
+        u64 Sum = (u64)A->Limbs[i] + B->Limbs[i] + Carry;
+        Out->Limbs[i] = Sum;
+        Carry = Sum >> 32;
+    }
+}
+
+void BigFix_Sub(bigfix *Out, const bigfix *A, const bigfix *B)
+{
+    u64 Borrow = 0;
+    for (int i = 0; i < BIGFIX_LIMB_COUNT; i++)
+    {
+        u64 Difference = (u64)A->Limbs[i] - B->Limbs[i] - Borrow;
+        Out->Limbs[i] = Difference;
+        Borrow = Difference >> 63;
+    }
+}
+
+void BigFix_AddDouble(bigfix *A, double Value)
+{
+    bigfix B = BigFix_FromDouble(Value);
+    BigFix_Add(A, A, &B);
+}
+
+/* two's complement A of LimbCount limbs into its magnitude, returns its sign */
+static bool8 BigFix_GetLimbsMagnitude(u32 *Out, const u32 *A, int LimbCount)
+{
+    bool8 IsNegative = A[LimbCount - 1] >> 31;
+    u64 Carry = 1;
+    for (int i = 0; i < LimbCount; i++)
+    {
+        u64 Sum = (u64)(u32)~A[i] + Carry;
+        Out[i] = IsNegative? (u32)Sum : A[i];
+        Carry = Sum >> 32;
+    }
+    return IsNegative;
+}
+
+static void BigFix_AddLimbs(u32 *Out, const u32 *A, const u32 *B, int LimbCount)
+{
+    u64 Carry = 0;
+    for (int i = 0; i < LimbCount; i++)
+    {
+        u64 Sum = (u64)A[i] + B[i] + Carry;
+        Out[i] = Sum;
+        Carry = Sum >> 32;
+    }
+}
+
+static void BigFix_SubLimbs(u32 *Out, const u32 *A, const u32 *B, int LimbCount)
+{
+    u64 Borrow = 0;
+    for (int i = 0; i < LimbCount; i++)
+    {
+        u64 Difference = (u64)A[i] - B[i] - Borrow;
+        Out[i] = Difference;
+        Borrow = Difference >> 63;
+    }
+}
+
+/* 
+    Both add up the columns of the product from the least significant one that can still carry into the lowest limb kept.
+    The low halves of a column's products add up in one sum and the high halves, which weigh as much as the next column, 
+    in another: no carries between them to wait on. The low limb of the column goes out, the rest carries on.
+    A and B are magnitudes of LimbCount limbs, the last one the integer limb, Out gets the top LimbCount limbs of the product.
+    With LimbCount a constant the compiler unrolls them, see the specializations below.
+*/
+static inline void BigFix_MulLimbs(u32 *Out, const u32 *A, const u32 *B, int LimbCount)
+{
+    u64 Carry = 0, LastHighSum = 0;
+    for (int Column = LimbCount - 2; Column <= 2*LimbCount - 2; Column++)
+    {
+        u64 LowSum = 0, HighSum = 0;
+        for (int i = MAX(Column - (LimbCount - 1), 0); i <= MIN(Column, LimbCount - 1); i++)
+        {
+            u64 Product = (u64)A[i] * B[Column - i];
+            LowSum += (u32)Product;
+            HighSum += Product >> 32;
+        }
+        u64 Sum = Carry + LowSum + LastHighSum;
+        if (Column >= LimbCount - 1)
+            Out[Column - (LimbCount - 1)] = (u32)Sum;
+        Carry = Sum >> 32;
+        LastHighSum = HighSum;
+    }
+}
+
+/* the same columns as BigFix_MulLimbs(), A[i]*A[k] and A[k]*A[i] counted once and doubled */
+static inline void BigFix_SqrLimbs(u32 *Out, const u32 *A, int LimbCount)
+{
+    u64 Carry = 0, LastHighSum = 0;
+    for (int Column = LimbCount - 2; Column <= 2*LimbCount - 2; Column++)
+    {
+        u64 LowSum = 0, HighSum = 0;
+        for (int i = MAX(Column - (LimbCount - 1), 0); i < Column - i; i++)
+        {
+            u64 Product = (u64)A[i] * A[Column - i];
+            LowSum += (u32)Product;
+            HighSum += Product >> 32;
+        }
+        LowSum *= 2;
+        HighSum *= 2;
+        if (Column % 2 == 0)
+        {
+            u64 Product = (u64)A[Column / 2] * A[Column / 2];
+            LowSum += (u32)Product;
+            HighSum += Product >> 32;
+        }
+
+        u64 Sum = Carry + LowSum + LastHighSum;
+        if (Column >= LimbCount - 1)
+            Out[Column - (LimbCount - 1)] = (u32)Sum;
+        Carry = Sum >> 32;
+        LastHighSum = HighSum;
+    }
+}
+
+static void BigFix_MulLimbs4(u32 *Out, const u32 *A, const u32 *B) { BigFix_MulLimbs(Out, A, B, 4); }
+static void BigFix_MulLimbs8(u32 *Out, const u32 *A, const u32 *B) { BigFix_MulLimbs(Out, A, B, 8); }
+static void BigFix_MulLimbs16(u32 *Out, const u32 *A, const u32 *B) { BigFix_MulLimbs(Out, A, B, 16); }
+static void BigFix_MulLimbs32(u32 *Out, const u32 *A, const u32 *B) { BigFix_MulLimbs(Out, A, B, 32); }
+static void BigFix_SqrLimbs4(u32 *Out, const u32 *A) { BigFix_SqrLimbs(Out, A, 4); }
+static void BigFix_SqrLimbs8(u32 *Out, const u32 *A) { BigFix_SqrLimbs(Out, A, 8); }
+static void BigFix_SqrLimbs16(u32 *Out, const u32 *A) { BigFix_SqrLimbs(Out, A, 16); }
+static void BigFix_SqrLimbs32(u32 *Out, const u32 *A) { BigFix_SqrLimbs(Out, A, 32); }
+
+static bigfix_mul_fn *BigFix_GetMulFunction(int LimbCount)
+{
+    switch (LimbCount)
+    {
+    case 4: return BigFix_MulLimbs4;
+    case 8: return BigFix_MulLimbs8;
+    case 16: return BigFix_MulLimbs16;
+    case 32: return BigFix_MulLimbs32;
+    default: return NULL;
+    }
+}
+
+static bigfix_sqr_fn *BigFix_GetSqrFunction(int LimbCount)
+{
+    switch (LimbCount)
+    {
+    case 4: return BigFix_SqrLimbs4;
+    case 8: return BigFix_SqrLimbs8;
+    case 16: return BigFix_SqrLimbs16;
+    case 32: return BigFix_SqrLimbs32;
+    default: return NULL;
+    }
+}
+
+static void BigFix_SetTopLimbs(bigfix *Out, const u32 *Magnitude, bool8 IsNegative, int LimbCount)
+{
+    u32 *Top = Out->Limbs + BIGFIX_LIMB_COUNT - LimbCount;
+    for (int i = 0; i < BIGFIX_LIMB_COUNT - LimbCount; i++)
+    {
+        Out->Limbs[i] = 0;
+    }
+    /* the limbs below are 0, negating carries the 1 right into the lowest one kept */
+    u64 Carry = 1;
+    for (int i = 0; i < LimbCount; i++)
+    {
+        u64 Sum = (u64)(u32)~Magnitude[i] + Carry;
+        Top[i] = IsNegative? (u32)Sum : Magnitude[i];
+        Carry = Sum >> 32;
+    }
+}
+
+void BigFix_Mul(bigfix *Out, const bigfix *A, const bigfix *B, int LimbCount)
+{
+    ASSERT(IN_RANGE(BIGFIX_MIN_LIMB_COUNT, LimbCount, BIGFIX_LIMB_COUNT), "Invalid limb count");
+    u32 AbsA[BIGFIX_LIMB_COUNT], AbsB[BIGFIX_LIMB_COUNT], Product[BIGFIX_LIMB_COUNT];
+    bool8 IsNegative = BigFix_GetLimbsMagnitude(AbsA, A->Limbs + BIGFIX_LIMB_COUNT - LimbCount, LimbCount) != BigFix_GetLimbsMagnitude(AbsB, B->Limbs + BIGFIX_LIMB_COUNT - LimbCount, LimbCount);
+    bigfix_mul_fn *Mul = BigFix_GetMulFunction(LimbCount);
+    if (Mul)
+        Mul(Product, AbsA, AbsB);
+    else
+        BigFix_MulLimbs(Product, AbsA, AbsB, LimbCount);
+    BigFix_SetTopLimbs(Out, Product, IsNegative, LimbCount);
+}
+
+void BigFix_Sqr(bigfix *Out, const bigfix *A, int LimbCount)
+{
+    ASSERT(IN_RANGE(BIGFIX_MIN_LIMB_COUNT, LimbCount, BIGFIX_LIMB_COUNT), "Invalid limb count");
+    u32 AbsA[BIGFIX_LIMB_COUNT], Product[BIGFIX_LIMB_COUNT];
+    BigFix_GetLimbsMagnitude(AbsA, A->Limbs + BIGFIX_LIMB_COUNT - LimbCount, LimbCount);
+    bigfix_sqr_fn *Sqr = BigFix_GetSqrFunction(LimbCount);
+    if (Sqr)
+        Sqr(Product, AbsA);
+    else
+        BigFix_SqrLimbs(Product, AbsA, LimbCount);
+    BigFix_SetTopLimbs(Out, Product, false, LimbCount);
+}
+
+void BigFix_SquareAdd(bigfix *Zx, bigfix *Zy, const bigfix *Cx, const bigfix *Cy, int LimbCount)
+{
+    ASSERT(IN_RANGE(BIGFIX_MIN_LIMB_COUNT, LimbCount, BIGFIX_LIMB_COUNT), "Invalid limb count");
+    int Low = BIGFIX_LIMB_COUNT - LimbCount;
+    bigfix_sqr_fn *Sqr = BigFix_GetSqrFunction(LimbCount);
+    u32 AbsX[BIGFIX_LIMB_COUNT], AbsY[BIGFIX_LIMB_COUNT], AbsSum[BIGFIX_LIMB_COUNT];
+    u32 X2[BIGFIX_LIMB_COUNT], Y2[BIGFIX_LIMB_COUNT], Sum2[BIGFIX_LIMB_COUNT];
+    BigFix_AddLimbs(AbsSum, Zx->Limbs + Low, Zy->Limbs + Low, LimbCount);
+    BigFix_GetLimbsMagnitude(AbsSum, AbsSum, LimbCount);
+    BigFix_GetLimbsMagnitude(AbsX, Zx->Limbs + Low, LimbCount);
+    BigFix_GetLimbsMagnitude(AbsY, Zy->Limbs + Low, LimbCount);
+    if (Sqr)
+    {
+        Sqr(X2, AbsX);
+        Sqr(Y2, AbsY);
+        Sqr(Sum2, AbsSum);
+    }
+    else
+    {
+        BigFix_SqrLimbs(X2, AbsX, LimbCount);
+        BigFix_SqrLimbs(Y2, AbsY, LimbCount);
+        BigFix_SqrLimbs(Sum2, AbsSum, LimbCount);
+    }
+
+    /* 2*Zx*Zy = (Zx + Zy)^2 - Zx^2 - Zy^2, the limbs below LimbCount stay 0 */
+    BigFix_SubLimbs(Zx->Limbs + Low, X2, Y2, LimbCount);
+    BigFix_AddLimbs(Zx->Limbs + Low, Zx->Limbs + Low, Cx->Limbs + Low, LimbCount);
+    BigFix_SubLimbs(Sum2, Sum2, X2, LimbCount);
+    BigFix_SubLimbs(Sum2, Sum2, Y2, LimbCount);
+    BigFix_AddLimbs(Zy->Limbs + Low, Sum2, Cy->Limbs + Low, LimbCount);
+    for (int i = 0; i < Low; i++)
+    {
+        Zx->Limbs[i] = 0;
+        Zy->Limbs[i] = 0;
+    }
+}
+
+void BigFix_MulExact(bigfix *Out, const bigfix *A, const bigfix *B, int LimbCount)
+{
+    ASSERT(IN_RANGE(BIGFIX_MIN_LIMB_COUNT, LimbCount, BIGFIX_LIMB_COUNT), "Invalid limb count");
+    /* multiply the magnitudes, then fix up the sign */
+    bigfix TopA = *A, TopB = *B;
+    BigFix_RoundDown(&TopA, -32*(LimbCount - 1));
+    BigFix_RoundDown(&TopB, -32*(LimbCount - 1));
+    bool8 IsNegative = BigFix_IsNegative(A) != BigFix_IsNegative(B);
+    if (BigFix_IsNegative(&TopA))
+        BigFix_Negate(&TopA);
+    if (BigFix_IsNegative(&TopB))
+        BigFix_Negate(&TopB);
+
+    const u32 *AbsA = TopA.Limbs + BIGFIX_LIMB_COUNT - LimbCount;
+    const u32 *AbsB = TopB.Limbs + BIGFIX_LIMB_COUNT - LimbCount;
+    u32 Product[2*BIGFIX_LIMB_COUNT] = { 0 };
+    for (int i = 0; i < LimbCount; i++)
+    {
+        u64 Carry = 0;
+        for (int k = 0; k < LimbCount; k++)
+        {
+            u64 Sum = (u64)AbsA[i] * AbsB[k] + Product[i + k] + Carry;
+            Product[i + k] = Sum;
+            Carry = Sum >> 32;
+        }
+        Product[i + LimbCount] = Carry;
+    }
+
+    /* drop the extra fraction limbs */
+    *Out = (bigfix) { 0 };
+    MemCpy(Out->Limbs + BIGFIX_LIMB_COUNT - LimbCount, Product + LimbCount - 1, LimbCount * sizeof(u32));
+    if (IsNegative)
+        BigFix_Negate(Out);
+}
+
+void BigFix_MulBy2(bigfix *A)
+{
+    BigFix_Add(A, A, A);
+}
+
+
+void BigFix_RoundDown(bigfix *A, int Exponent)
+{
+    /* bit k of the limbs weighs 2^(k - 32*BIGFIX_FRACTION_LIMB_COUNT) */
+    int ClearedBitCount = Exponent + 32*BIGFIX_FRACTION_LIMB_COUNT;
+    for (int i = 0; i < BIGFIX_LIMB_COUNT && ClearedBitCount > 32*i; i++)
+    {
+        int BitCount = ClearedBitCount - 32*i;
+        A->Limbs[i] &= BitCount >= 32? 0 : ~((1u << BitCount) - 1);
+    }
+}
+
+int BigFix_GetLimbCount(double Scale)
+{
+    if (sBigFix_LimbCount)
+        return sBigFix_LimbCount;
+
+    int Exponent;
+    frexp(Scale, &Exponent);
+    int FractionBitCount = MAX(-Exponent, 0) + BIGFIX_GUARD_BITS;
+    int LimbCount = 1 + (FractionBitCount + 31) / 32;
+    for (int Specialized = 4; Specialized < BIGFIX_LIMB_COUNT; Specialized *= 2)
+    {
+        if (LimbCount <= Specialized)
+            return Specialized;
+    }
+    return BIGFIX_LIMB_COUNT;
+}
+
+void BigFix_SetLimbCount(int LimbCount)
+{
+    ASSERT(LimbCount == 0 || IN_RANGE(BIGFIX_MIN_LIMB_COUNT, LimbCount, BIGFIX_LIMB_COUNT), "Invalid limb count");
+    sBigFix_LimbCount = LimbCount;
+}
@@ -0,0 +1,62 @@
+#ifndef BIGFIX_H
+#define BIGFIX_H
+
+#include "Common.h"
+
+/* 1 integer limb + 31 fraction limbs, 992 fraction bits is about 1e-298, past the smallest scale a double has */
+#define BIGFIX_LIMB_COUNT 32
+#define BIGFIX_FRACTION_LIMB_COUNT (BIGFIX_LIMB_COUNT - 1)
+#define BIGFIX_MIN_LIMB_COUNT 2
+/* bits past the pixel size that products keep, what a reference orbit loses over its iterations */
+#define BIGFIX_GUARD_BITS 64
+
+
+/* 
+    Fixed-point two's complement number, 
+    Limbs[0] is the least significant fraction limb and 
+    Limbs[BIGFIX_LIMB_COUNT - 1] is the signed integer part.
+    Results that overflow the integer part wrap around.
+*/
+typedef struct bigfix
+{
+    u32 Limbs[BIGFIX_LIMB_COUNT];
+} bigfix;
+
+
+bigfix BigFix_FromDouble(double Value);
+double BigFix_ToDouble(const bigfix *A);
+/* decimal, like "-0.743643887037158704752191506114774", returns false on junk */
+bool8 BigFix_FromString(bigfix *Out, const char *String);
+
+void BigFix_Add(bigfix *Out, const bigfix *A, const bigfix *B);
+void BigFix_Sub(bigfix *Out, const bigfix *A, const bigfix *B);
+void BigFix_AddDouble(bigfix *A, double Value);
+/* 
+    Products only work with the top LimbCount limbs of A and B, the integer limb and LimbCount - 1 fraction limbs, 
+    and leave the limbs below them 0. Truncated toward zero (magnitude truncated, then negated), but for the 
+    carries of the columns below the lowest limb kept (a few units of it at most), the same for every limb count's code.
+    4, 8, 16 and 32 limbs have code of their own, the others go through the generic loops.
+*/
+void BigFix_Mul(bigfix *Out, const bigfix *A, const bigfix *B, int LimbCount);
+/* about half the products of BigFix_Mul(), with the exact same result */
+void BigFix_Sqr(bigfix *Out, const bigfix *A, int LimbCount);
+/* 
+    Z = Z^2 + C in the top LimbCount limbs like the products, what a reference orbit iterates.
+    2*Zx*Zy is (Zx + Zy)^2 - Zx^2 - Zy^2, three squares and no product.
+*/
+void BigFix_SquareAdd(bigfix *Zx, bigfix *Zy, const bigfix *Cx, const bigfix *Cy, int LimbCount);
+/* every limb of the product of the same top limbs, truncated toward zero (magnitude truncated, then negated), the plain schoolbook the ones above are checked against */
+void BigFix_MulExact(bigfix *Out, const bigfix *A, const bigfix *B, int LimbCount);
+void BigFix_MulBy2(bigfix *A);
+/* 
+    LimbCount for products that tell apart points Scale apart with BIGFIX_GUARD_BITS to spare, 
+    rounded up to a limb count with code of its own, or the one BigFix_SetLimbCount() forces
+*/
+int BigFix_GetLimbCount(double Scale);
+/* 0 goes back to picking by the scale */
+void BigFix_SetLimbCount(int LimbCount);
+/* toward minus infinity, to a multiple of 2^Exponent */
+void BigFix_RoundDown(bigfix *A, int Exponent);
+
+#endif /* BIGFIX_H */
+
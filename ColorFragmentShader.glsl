@@ -0,0 +1,36 @@
+#version 400 core
+
+#define COLOR_PALETTE_SIZE 16
+
+/* escape counts from FragmentShader.glsl or the CPU renderer, bottom row first */
+uniform usampler2D u_Iterations;
+uniform vec3 u_ColorPalette[COLOR_PALETTE_SIZE];
+uniform int u_IterationCount;
+/* or the antialiased colors, summed over the samples of every pixel along with their count, see SupersampleFragmentShader.glsl */
+uniform sampler2D u_Sums;
+uniform bool u_HasSums;
+out vec4 FragColor;
+
+void main()
+{
+    if (u_HasSums)
+    {
+        vec4 Sums = texelFetch(u_Sums, ivec2(gl_FragCoord.xy), 0);
+        FragColor = vec4(Sums.rgb / abs(Sums.a), 1.0f);
+        return;
+    }
+
+    uint i = texelFetch(u_Iterations, ivec2(gl_FragCoord.xy), 0).r;
+
+    /* determine the color */
+    vec3 Color;
+    if (i < uint(u_IterationCount))
+    {
+        Color = u_ColorPalette[i & uint(COLOR_PALETTE_SIZE - 1)];
+    }
+    else
+    {
+        Color = vec3(0.0f);
+    }
+    FragColor = vec4(Color, 1.0f);
+}
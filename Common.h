@@ -60,6 +60,56 @@ typedef struct strview
 } strview;
 
 
+#if defined(_MSC_VER)
+#  include <intrin.h>
+/* returns the value before the addition */
+static inline i32 AtomicAddI32(volatile i32 *Dst, i32 Value)
+{
+    return _InterlockedExchangeAdd((volatile long *)Dst, Value);
+}
+static inline bool8 AtomicCompareExchangeI32(volatile i32 *Dst, i32 Expected, i32 New)
+{
+    return _InterlockedCompareExchange((volatile long *)Dst, New, Expected) == Expected;
+}
+static inline i64 AtomicAddI64(volatile i64 *Dst, i64 Value)
+{
+    return _InterlockedExchangeAdd64((volatile long long *)Dst, Value);
+}
+#elif defined(__TINYC__) && defined(__x86_64__)
+/* tcc has none of the __atomic builtins, the lock prefix makes these full barriers like theirs */
+static inline i32 AtomicAddI32(volatile i32 *Dst, i32 Value)
+{
+    __asm__ __volatile__("lock; xaddl %0, %1" : "+r"(Value), "+m"(*Dst) : : "memory");
+    return Value;
+}
+static inline bool8 AtomicCompareExchangeI32(volatile i32 *Dst, i32 Expected, i32 New)
+{
+    i32 Previous;
+    __asm__ __volatile__("lock; cmpxchgl %2, %1" : "=a"(Previous), "+m"(*Dst) : "r"(New), "0"(Expected) : "memory");
+    return Previous == Expected;
+}
+static inline i64 AtomicAddI64(volatile i64 *Dst, i64 Value)
+{
+    __asm__ __volatile__("lock; xaddq %0, %1" : "+r"(Value), "+m"(*Dst) : : "memory");
+    return Value;
+}
+#else
+/* returns the value before the addition */
+static inline i32 AtomicAddI32(volatile i32 *Dst, i32 Value)
+{
+    return __atomic_fetch_add(Dst, Value, __ATOMIC_SEQ_CST);
+}
+static inline bool8 AtomicCompareExchangeI32(volatile i32 *Dst, i32 Expected, i32 New)
+{
+    return __atomic_compare_exchange_n(Dst, &Expected, New, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+static inline i64 AtomicAddI64(volatile i64 *Dst, i64 Value)
+{
+    return __atomic_fetch_add(Dst, Value, __ATOMIC_SEQ_CST);
+}
+#endif /* _MSC_VER */
+
+
 static inline double AbsF(double x)
 {
     union {
@@ -0,0 +1,102 @@
+#ifndef DOUBLE_DOUBLE_H
+#define DOUBLE_DOUBLE_H
+
+#include "Common.h"
+#include "BigFix.h"
+
+/* 
+    Unevaluated sum Hi + Lo with |Lo| <= ulp(Hi)/2, about 106 bits of mantissa.
+    Built on error-free transformations, so it depends on the compiler 
+    not fusing or reordering anything (-ffp-contract=off, no -ffast-math).
+*/
+typedef struct ddouble
+{
+    double Hi, Lo;
+} ddouble;
+
+
+/* A + B exactly, assumes |A| >= |B| */
+static inline ddouble DD_QuickTwoSum(double A, double B)
+{
+    double Sum = A + B;
+    return (ddouble) { Sum, B - (Sum - A) };
+}
+
+/* A + B exactly */
+static inline ddouble DD_TwoSum(double A, double B)
+{
+    double Sum = A + B;
+    double BVirtual = Sum - A;
+    double AVirtual = Sum - BVirtual;
+    return (ddouble) { Sum, (A - AVirtual) + (B - BVirtual) };
+}
+
+/* Dekker's split: A = Hi + Lo with 26 bits each */
+static inline ddouble DD_Split(double A)
+{
+    double T = 134217729.0 * A; /* 2^27 + 1 */
+    double Hi = T - (T - A);
+    return (ddouble) { Hi, A - Hi };
+}
+
+/* A * B exactly */
+static inline ddouble DD_TwoProd(double A, double B)
+{
+    double Product = A * B;
+    ddouble SplitA = DD_Split(A);
+    ddouble SplitB = DD_Split(B);
+    double Error = ((SplitA.Hi*SplitB.Hi - Product) + SplitA.Hi*SplitB.Lo + SplitA.Lo*SplitB.Hi) + SplitA.Lo*SplitB.Lo;
+    return (ddouble) { Product, Error };
+}
+
+
+static inline ddouble DD_FromDouble(double A)
+{
+    return (ddouble) { A, 0 };
+}
+
+static inline ddouble DD_FromBigFix(const bigfix *A)
+{
+    double Hi = BigFix_ToDouble(A);
+    bigfix Rest = BigFix_FromDouble(-Hi);
+    BigFix_Add(&Rest, &Rest, A);
+    return DD_QuickTwoSum(Hi, BigFix_ToDouble(&Rest));
+}
+
+static inline ddouble DD_Add(ddouble A, ddouble B)
+{
+    ddouble S = DD_TwoSum(A.Hi, B.Hi);
+    ddouble T = DD_TwoSum(A.Lo, B.Lo);
+    S.Lo += T.Hi;
+    S = DD_QuickTwoSum(S.Hi, S.Lo);
+    S.Lo += T.Lo;
+    return DD_QuickTwoSum(S.Hi, S.Lo);
+}
+
+static inline ddouble DD_Sub(ddouble A, ddouble B)
+{
+    return DD_Add(A, (ddouble) { -B.Hi, -B.Lo });
+}
+
+static inline ddouble DD_Mul(ddouble A, ddouble B)
+{
+    ddouble P = DD_TwoProd(A.Hi, B.Hi);
+    P.Lo += A.Hi*B.Lo + A.Lo*B.Hi;
+    return DD_QuickTwoSum(P.Hi, P.Lo);
+}
+
+static inline ddouble DD_Sqr(ddouble A)
+{
+    ddouble P = DD_TwoProd(A.Hi, A.Hi);
+    P.Lo += 2.0*A.Hi*A.Lo;
+    return DD_QuickTwoSum(P.Hi, P.Lo);
+}
+
+/* exact, powers of 2 don't round */
+static inline ddouble DD_MulBy2(ddouble A)
+{
+    return (ddouble) { 2.0*A.Hi, 2.0*A.Lo };
+}
+
+#endif /* DOUBLE_DOUBLE_H */
+
@@ -0,0 +1,332 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Platform.h"
+#include "ExpMap.h"
+#include "Kernel.h"
+#include "Perturbation.h"
+
+
+typedef struct exp_map_job
+{
+    exp_map *Map;
+    const render_precision *Precisions; /* of every ring */
+    kernel_row_fn *RowFunctions[RENDER_PRECISION_COUNT];
+    const reference_orbit *Orbit; /* when a ring needs perturbation */
+    volatile i32 NextRing;
+    volatile i64 IterationCount;
+    volatile i64 PixelCount;
+    volatile i64 EarlyExitCount;
+} exp_map_job;
+
+typedef struct exp_map_resample_job
+{
+    const exp_map *Map;
+    double Scale;
+    int Width, Height;
+    u32 *Iterations;
+    volatile i32 NextRow;
+} exp_map_resample_job;
+
+/* a copy of part of a ring for the kernels, padded like renderer_row */
+typedef struct exp_map_chunk
+{
+    u32 Iterations[EXP_MAP_CHUNK_SIZE];
+    double Zx[EXP_MAP_CHUNK_SIZE], Zy[EXP_MAP_CHUNK_SIZE];
+    double SavedZx[EXP_MAP_CHUNK_SIZE], SavedZy[EXP_MAP_CHUNK_SIZE];
+    double ZxLo[EXP_MAP_CHUNK_SIZE], ZyLo[EXP_MAP_CHUNK_SIZE];
+    i32 OrbitIndex[EXP_MAP_CHUNK_SIZE];
+} exp_map_chunk;
+
+
+static int ExpMap_GetRingLength(const exp_map *Map)
+{
+    return 4*Map->Size + 4;
+}
+
+/* the view ring Ring is the border of, centered like the core */
+static render_view ExpMap_GetRingView(const exp_map *Map, int Ring, render_precision Precision)
+{
+    render_view RingView = Map->View;
+    int Size = Map->Size + 2;
+    double Scale = Map->RingScales[Ring];
+    RingView.ScreenToWorldScaleFactor = Scale;
+    RingView.PixelOffsetX = 0;
+    RingView.PixelOffsetY = 0;
+    RingView.Width = Size;
+    RingView.Height = Size;
+    RingView.Precision = Precision;
+    RingView.Method = RENDER_METHOD_BRUTE_FORCE;
+    /* the reference orbit adds back the very same double, every ring has it at the exact center */
+    RingView.ExactWorldLeft = Map->CenterX;
+    RingView.ExactWorldBottom = Map->CenterY;
+    BigFix_AddDouble(&RingView.ExactWorldLeft, -(double)(Size / 2) * Scale);
+    BigFix_AddDouble(&RingView.ExactWorldBottom, -(double)(Size / 2) * Scale);
+    RingView.WorldLeft = BigFix_ToDouble(&RingView.ExactWorldLeft);
+    RingView.WorldBottom = BigFix_ToDouble(&RingView.ExactWorldBottom);
+    return RingView;
+}
+
+static void ExpMap_RenderRing(exp_map_job *Job, int Ring)
+{
+    exp_map *Map = Job->Map;
+    render_precision Precision = Job->Precisions[Ring];
+    render_view RingView = ExpMap_GetRingView(Map, Ring, Precision);
+    u32 *Counts = Map->Rings + (size_t)Ring * ExpMap_GetRingLength(Map);
+    int Size = Map->Size;
+
+    /* bottom row, top row, left column, right column, the rows have the corners */
+    struct { int StartX, Y, Count; bool8 IsColumn; } Sides[4] = {
+        { 0, 0, Size + 2, false },
+        { 0, Size + 1, Size + 2, false },
+        { 0, 1, Size, true },
+        { Size + 1, 1, Size, true },
+    };
+    i64 IterationCount = 0, PixelCount = 0, EarlyExitCount = 0;
+    exp_map_chunk Chunk;
+    for (int Side = 0; Side < 4; Side++)
+    {
+        for (int Done = 0; Done < Sides[Side].Count; Done += EXP_MAP_CHUNK_SIZE)
+        {
+            int Count = MIN(EXP_MAP_CHUNK_SIZE, Sides[Side].Count - Done);
+            int PaddedCount = (Count + KERNEL_MAX_LANE_COUNT - 1) / KERNEL_MAX_LANE_COUNT * KERNEL_MAX_LANE_COUNT;
+            memset(&Chunk, 0, sizeof Chunk);
+            for (int x = Count; x < PaddedCount; x++)
+            {
+                Chunk.Iterations[x] = UINT32_MAX;
+            }
+            kernel_row KernelRow = {
+                .StartX = Sides[Side].StartX + (Sides[Side].IsColumn? 0 : Done),
+                .Y = Sides[Side].Y + (Sides[Side].IsColumn? Done : 0),
+                .Count = PaddedCount,
+                .IsColumn = Sides[Side].IsColumn,
+                .Iterations = Chunk.Iterations,
+                .Zx = Chunk.Zx,
+                .Zy = Chunk.Zy,
+                .ZxLo = Chunk.ZxLo,
+                .ZyLo = Chunk.ZyLo,
+                .OrbitIndex = Chunk.OrbitIndex,
+                .SavedZx = Chunk.SavedZx,
+                .SavedZy = Chunk.SavedZy,
+            };
+            if (Precision == RENDER_PRECISION_PERTURBATION)
+            {
+                Perturbation_Row(&RingView, Job->Orbit, &KernelRow);
+            }
+            else
+            {
+                Job->RowFunctions[Precision](&RingView, &KernelRow);
+            }
+
+            for (int x = 0; x < Count; x++)
+            {
+                IterationCount += Chunk.Iterations[x];
+            }
+            IterationCount -= KernelRow.SkippedIterationCount;
+            PixelCount += Count;
+            EarlyExitCount += KernelRow.EarlyExitCount;
+            memcpy(Counts, Chunk.Iterations, Count * sizeof(u32));
+            Counts += Count;
+        }
+    }
+    AtomicAddI64(&Job->IterationCount, IterationCount);
+    AtomicAddI64(&Job->PixelCount, PixelCount);
+    AtomicAddI64(&Job->EarlyExitCount, EarlyExitCount);
+}
+
+static void ExpMap_RingWorker(void *Data)
+{
+    exp_map_job *Job = Data;
+    i32 Ring;
+    while ((Ring = AtomicAddI32(&Job->NextRing, 1)) < Job->Map->RingCount)
+    {
+        ExpMap_RenderRing(Job, Ring);
+    }
+}
+
+render_stats ExpMap_Render(exp_map *Map, const render_view *View, int Size, double InnerScale, double Zoom)
+{
+    ASSERT(Size > 0 && Size % 2 == 0, "The size of an exponential map must be even");
+    double StartTimeMs = Platform_GetElapsedTimeMs();
+    ExpMap_Free(Map);
+    double Scale = View->ScreenToWorldScaleFactor;
+    Map->CenterX = View->ExactWorldLeft;
+    Map->CenterY = View->ExactWorldBottom;
+    BigFix_AddDouble(&Map->CenterX, (View->PixelOffsetX + 0.5 * View->Width) * Scale);
+    BigFix_AddDouble(&Map->CenterY, (View->PixelOffsetY + 0.5 * View->Height) * Scale);
+    Map->Size = Size;
+    Map->InnerScale = InnerScale;
+    Map->View = *View;
+    /* the outermost ring reaches Size/2 * InnerScale * q^RingCount */
+    double LogQ = log((double)(Size + 2) / Size);
+    Map->RingCount = MAX((int)ceil(log(MAX(Zoom, 1.0)) / LogQ), 1);
+    Map->RingScales = malloc(Map->RingCount * sizeof(double));
+    Map->Rings = malloc((size_t)Map->RingCount * ExpMap_GetRingLength(Map) * sizeof(u32));
+    Map->Core = malloc((size_t)Size * Size * sizeof(u32));
+    render_precision *Precisions = malloc(Map->RingCount * sizeof(render_precision));
+    ASSERT(Map->RingScales && Map->Rings && Map->Core && Precisions, "Out of memory");
+
+    /* the core is a view like any other */
+    render_view CoreView = *View;
+    CoreView.ScreenToWorldScaleFactor = InnerScale;
+    CoreView.PixelOffsetX = 0;
+    CoreView.PixelOffsetY = 0;
+    CoreView.Width = Size;
+    CoreView.Height = Size;
+    CoreView.ExactWorldLeft = Map->CenterX;
+    CoreView.ExactWorldBottom = Map->CenterY;
+    BigFix_AddDouble(&CoreView.ExactWorldLeft, -0.5 * Size * InnerScale);
+    BigFix_AddDouble(&CoreView.ExactWorldBottom, -0.5 * Size * InnerScale);
+    CoreView.WorldLeft = BigFix_ToDouble(&CoreView.ExactWorldLeft);
+    CoreView.WorldBottom = BigFix_ToDouble(&CoreView.ExactWorldBottom);
+    CoreView.Precision = Renderer_ChoosePrecision(&CoreView, RENDER_PRECISION_FLOAT);
+    iteration_buffer Buffer = { 0 };
+    Renderer_RenderIterations(&Buffer, &CoreView);
+    memcpy(Map->Core, Buffer.Iterations, (size_t)Size * Size * sizeof(u32));
+    Renderer_FreeBuffer(&Buffer);
+    render_stats Stats = Renderer_GetStats();
+    Map->MinPrecision = CoreView.Precision;
+    Map->MaxPrecision = CoreView.Precision;
+
+    exp_map_job Job = { .Map = Map, .Precisions = Precisions };
+    reference_orbit Orbit = { 0 };
+    for (int Ring = 0; Ring < Map->RingCount; Ring++)
+    {
+        Map->RingScales[Ring] = InnerScale * exp(Ring * LogQ);
+        render_view RingView = ExpMap_GetRingView(Map, Ring, RENDER_PRECISION_FLOAT);
+        Precisions[Ring] = Renderer_ChoosePrecision(&RingView, RENDER_PRECISION_FLOAT);
+        Map->MinPrecision = MIN(Map->MinPrecision, Precisions[Ring]);
+        Map->MaxPrecision = MAX(Map->MaxPrecision, Precisions[Ring]);
+        /* one reference orbit at the center for every ring that needs it */
+        if (Precisions[Ring] == RENDER_PRECISION_PERTURBATION && !Job.Orbit)
+        {
+            Perturbation_ComputeReference(&Orbit, &RingView);
+            Job.Orbit = &Orbit;
+        }
+    }
+    for (render_precision Precision = 0; Precision < RENDER_PRECISION_PERTURBATION; Precision++)
+    {
+        Job.RowFunctions[Precision] = Kernel_GetRowFunction(Kernel_GetIsa(), Precision);
+    }
+
+    int ThreadCount = Platform_GetThreadCount();
+    for (int i = 0; i < ThreadCount; i++)
+    {
+        Platform_PushWork(ExpMap_RingWorker, &Job);
+    }
+    Platform_CompleteAllWork();
+    Perturbation_FreeReference(&Orbit);
+    free(Precisions);
+
+    Stats.Precision = Map->MaxPrecision;
+    Stats.IterationCount += Job.IterationCount;
+    Stats.PixelCount += Job.PixelCount;
+    Stats.EarlyExitCount += Job.EarlyExitCount;
+    Stats.TimeMs = Platform_GetElapsedTimeMs() - StartTimeMs;
+    Stats.NsPerIteration = Stats.IterationCount? Stats.TimeMs * 1e6 / Stats.IterationCount : 0;
+    return Stats;
+}
+
+u32 ExpMap_GetIterations(const exp_map *Map, double Dx, double Dy)
+{
+    int Size = Map->Size;
+    double HalfSize = 0.5 * Size * Map->InnerScale;
+    double Radius = MAX(AbsF(Dx), AbsF(Dy));
+    int Ring = -1;
+    if (Radius >= HalfSize)
+    {
+        Ring = MIN((int)(log(Radius / HalfSize) / log((double)(Size + 2) / Size)), Map->RingCount - 1);
+    }
+
+    /* the log can be a ring off right at the edges, the ring's own pixels have the last word */
+    int x = 0, y = 0;
+    int Step = 0;
+    while (Ring >= 0)
+    {
+        double Scale = Map->RingScales[Ring];
+        x = (int)floor(Dx / Scale + 0.5 * (Size + 2));
+        y = (int)floor(Dy / Scale + 0.5 * (Size + 2));
+        bool8 IsOutside = x < 0 || y < 0 || x > Size + 1 || y > Size + 1;
+        bool8 IsInside = x > 0 && y > 0 && x < Size + 1 && y < Size + 1;
+        if (IsOutside && Step >= 0 && Ring < Map->RingCount - 1)
+        {
+            Ring++;
+            Step = 1;
+        }
+        else if (IsInside && Step <= 0)
+        {
+            Ring--;
+            Step = -1;
+        }
+        else
+        {
+            break;
+        }
+    }
+    if (Ring < 0)
+    {
+        x = MIN(MAX((int)floor(Dx / Map->InnerScale + 0.5 * Size), 0), Size - 1);
+        y = MIN(MAX((int)floor(Dy / Map->InnerScale + 0.5 * Size), 0), Size - 1);
+        return Map->Core[(size_t)y * Size + x];
+    }
+
+    /* off the border after all, snap to the nearest side */
+    x = MIN(MAX(x, 0), Size + 1);
+    y = MIN(MAX(y, 0), Size + 1);
+    if (x > 0 && y > 0 && x < Size + 1 && y < Size + 1)
+    {
+        if (ABSI(2*x - (Size + 1)) >= ABSI(2*y - (Size + 1)))
+            x = 2*x > Size + 1? Size + 1 : 0;
+        else
+            y = 2*y > Size + 1? Size + 1 : 0;
+    }
+
+    const u32 *Counts = Map->Rings + (size_t)Ring * ExpMap_GetRingLength(Map);
+    if (y == 0)
+        return Counts[x];
+    if (y == Size + 1)
+        return Counts[Size + 2 + x];
+    if (x == 0)
+        return Counts[2*(Size + 2) + y - 1];
+    return Counts[2*(Size + 2) + Size + y - 1];
+}
+
+static void ExpMap_ResampleWorker(void *Data)
+{
+    exp_map_resample_job *Job = Data;
+    i32 y;
+    while ((y = AtomicAddI32(&Job->NextRow, 1)) < Job->Height)
+    {
+        double Dy = (y + 0.5 - 0.5 * Job->Height) * Job->Scale;
+        u32 *Row = Job->Iterations + (size_t)y * Job->Width;
+        for (int x = 0; x < Job->Width; x++)
+        {
+            Row[x] = ExpMap_GetIterations(Job->Map, (x + 0.5 - 0.5 * Job->Width) * Job->Scale, Dy);
+        }
+    }
+}
+
+void ExpMap_Resample(const exp_map *Map, double Scale, int Width, int Height, u32 *Iterations)
+{
+    exp_map_resample_job Job = {
+        .Map = Map,
+        .Scale = Scale,
+        .Width = Width,
+        .Height = Height,
+        .Iterations = Iterations,
+    };
+    int ThreadCount = Platform_GetThreadCount();
+    for (int i = 0; i < ThreadCount; i++)
+    {
+        Platform_PushWork(ExpMap_ResampleWorker, &Job);
+    }
+    Platform_CompleteAllWork();
+}
+
+void ExpMap_Free(exp_map *Map)
+{
+    free(Map->RingScales);
+    free(Map->Core);
+    free(Map->Rings);
+    *Map = (exp_map) { 0 };
+}
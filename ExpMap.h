@@ -0,0 +1,46 @@
+#ifndef EXP_MAP_H
+#define EXP_MAP_H
+
+#include "Common.h"
+#include "BigFix.h"
+#include "Renderer.h"
+
+/* of one ring, kernel rows go in chunks of the renderer's tile */
+#define EXP_MAP_CHUNK_SIZE RENDERER_TILE_SIZE
+
+
+/*
+    Counts of a whole zoom into one point, rendered once for every frame of it.
+    The core is the deepest frame, Size*Size pixels of InnerScale.
+    Around it, ring i is the one pixel wide border of a (Size + 2)^2 view of InnerScale * q^i,
+    q = (Size + 2) / Size, so that it just covers ring i - 1: square rings in a log-polar layout,
+    their pixels as wide as they are deep at every radius.
+    A ring's counts are its bottom row, top row, left column and right column, one after the other.
+*/
+typedef struct exp_map
+{
+    bigfix CenterX, CenterY;
+    int Size; /* even, so that the center falls between pixels */
+    int RingCount;
+    double InnerScale;
+    double *RingScales; /* InnerScale * q^i */
+    render_view View; /* IterationCount, SkipsInterior and PeriodicityTolerance of every ring, the rings are always brute force */
+    u32 *Core; /* Size*Size, bottom row first like iteration_buffer */
+    u32 *Rings; /* RingCount rows of 4*Size + 4 */
+    render_precision MinPrecision, MaxPrecision; /* of the core and the rings */
+} exp_map;
+
+
+/*
+    Covers every view from Size pixels of InnerScale to Size pixels of InnerScale * Zoom around the center,
+    View gives the center (its middle) and how to iterate, each ring gets the tier it needs.
+    The stats add up the core and every ring.
+*/
+render_stats ExpMap_Render(exp_map *Map, const render_view *View, int Size, double InnerScale, double Zoom);
+/* the count nearest to the point Dx, Dy world units off the center */
+u32 ExpMap_GetIterations(const exp_map *Map, double Dx, double Dy);
+/* a Width*Height view of Scale around the center, bottom row first, on every thread of the platform's work queue */
+void ExpMap_Resample(const exp_map *Map, double Scale, int Width, int Height, u32 *Iterations);
+void ExpMap_Free(exp_map *Map);
+
+#endif /* EXP_MAP_H */
@@ -1,25 +1,64 @@
 #version 400 core
 
-#define COLOR_PALETTE_SIZE 16
-
 uniform float u_ScreenToWorldScaleFactor;
 uniform float u_WorldBottom;
 uniform float u_WorldLeft;
-uniform vec3 u_ColorPalette[COLOR_PALETTE_SIZE];
+/* one slice: pixels still at u_StartIteration pick up from their z, up to u_IterationCount */
+uniform int u_StartIteration;
 uniform int u_IterationCount;
-out vec4 FragColor;
+uniform bool u_StartsOver; /* every pixel from z = 0, the last slice was of another view */
+uniform bool u_SkipsInterior;
+/* absolute, 0 doesn't check for cycles, same check as Kernel_ScalarFloat() */
+uniform float u_PeriodicityTolerance;
+/* the last slice's outputs */
+uniform usampler2D u_LastIterations;
+uniform sampler2D u_LastState;
+/* escape count, colored later by ColorFragmentShader.glsl */
+layout (location = 0) out uint Iterations;
+/* Zx, Zy, SavedZx, SavedZy for the next slice */
+layout (location = 1) out vec4 State;
 
 void main()
 {
     float MaxValueSquared = 4.0f;
-    float Zx = 0;
-    float Zy = 0;
+    int i = 0;
+    vec4 LastState = vec4(0);
+    if (!u_StartsOver)
+    {
+        i = int(texelFetch(u_LastIterations, ivec2(gl_FragCoord.xy), 0).r);
+        LastState = texelFetch(u_LastState, ivec2(gl_FragCoord.xy), 0);
+        /* escaped already, or found inside */
+        if (i != u_StartIteration)
+        {
+            Iterations = uint(i);
+            State = LastState;
+            return;
+        }
+    }
+    float Zx = LastState.x;
+    float Zy = LastState.y;
+    float SavedZx = LastState.z;
+    float SavedZy = LastState.w;
     float Zix = gl_FragCoord.x * u_ScreenToWorldScaleFactor + u_WorldLeft;
     float Ziy = gl_FragCoord.y * u_ScreenToWorldScaleFactor + u_WorldBottom;
 
+    /* main cardioid and period-2 bulb never escape, same test as Kernel_IsInterior() */
+    if (u_SkipsInterior)
+    {
+        float Xq = Zix - 0.25f;
+        float Y2 = Ziy*Ziy;
+        float q = Xq*Xq + Y2;
+        float Xb = Zix + 1.0f;
+        if (q*(q + Xq) <= 0.25f*Y2 || Xb*Xb + Y2 <= 0.0625f)
+        {
+            Iterations = uint(u_IterationCount);
+            State = LastState;
+            return;
+        }
+    }
+
     /* calculate whether the current Zi* is in the set or not */
-    int i;
-    for (i = 0; 
+    for (; 
          i < u_IterationCount
          && (Zx*Zx + Zy*Zy) < MaxValueSquared;
          i++)
@@ -27,18 +66,19 @@ void main()
         float Tmp = Zx*Zx - Zy*Zy + Zix;
         Zy = 2.0*Zy*Zx + Ziy;
         Zx = Tmp;
-    }
 
-    /* determine the color */
-    vec3 Color;
-    if (i < u_IterationCount)
-    {
-        Color = u_ColorPalette[i & (COLOR_PALETTE_SIZE - 1)];
+        /* caught in a cycle, compared against z at the last power of two (Brent) */
+        if (abs(Zx - SavedZx) < u_PeriodicityTolerance && abs(Zy - SavedZy) < u_PeriodicityTolerance)
+        {
+            i = u_IterationCount;
+            break;
+        }
+        if (((i + 1) & i) == 0)
+        {
+            SavedZx = Zx;
+            SavedZy = Zy;
+        }
     }
-    else
-    {
-        Color = vec3(0.0f);
-    }
-    FragColor = vec4(Color, 1.0f);
-
+    Iterations = uint(i);
+    State = vec4(Zx, Zy, SavedZx, SavedZy);
 }
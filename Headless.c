@@ -0,0 +1,2180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <signal.h>
+
+#include "Platform.h"
+#include "Common.h"
+#include "WorkQueue.h"
+#include "Renderer.h"
+#include "Kernel.h"
+#include "Image.h"
+#include "ExpMap.h"
+
+#define HEADLESS_MAX_REPEAT_COUNT 1000
+#define HEADLESS_MAX_PATH 4096
+/* 256, an XYZ zoom is the pyramid level minus this */
+#define HEADLESS_PYRAMID_TILE_LEVEL 8
+#define HEADLESS_PYRAMID_TILE_SIZE (1 << HEADLESS_PYRAMID_TILE_LEVEL)
+/* a render is 4x4 tiles, the 2 levels above it are halved from that */
+#define HEADLESS_PYRAMID_BLOCK_LEVELS 2
+#define HEADLESS_VIDEO_FRAME_RATE 30
+#define HEADLESS_MAX_FARM_WORKER_COUNT 256
+#define HEADLESS_FARM_TILE_SIZE 256
+/* tiles a worker has been handed and not answered yet, so that it never waits on the coordinator */
+#define HEADLESS_FARM_QUEUE_DEPTH 2
+/* rows of tiles handed out ahead of the one written next, what the coordinator holds at most */
+#define HEADLESS_FARM_WINDOW_ROWS 4
+/* workers on the same tile at once, the ones past the first took it over from a slow one */
+#define HEADLESS_FARM_MAX_HOLDER_COUNT 2
+
+
+static uint32_t sStackAllocatorMemory[4*MB / sizeof(uint32_t)];
+static uint8_t *sStackAllocatorTop = (uint8_t *)sStackAllocatorMemory;
+static double sFrameTimeTargetS = 0;
+static double sStartTimeS;
+static double sFrameTimeMs = 0; /* for the app */
+static app_state sAppState;
+static platform_framebuffer sFramebuffer;
+static bool8 sFramebufferSizeIsFixed; /* size given on the command line wins over the app */
+static bool8 sShowsProgress; /* stderr is a terminal, scripted runs don't get the \r lines */
+
+
+/* goes over the last progress line */
+static void PrintProgress(const char *Format, ...)
+{
+    if (!sShowsProgress)
+        return;
+
+    va_list Args;
+    va_start(Args, Format);
+    fputc('\r', stderr);
+    vfprintf(stderr, Format, Args);
+    va_end(Args);
+}
+
+/* so that what comes next doesn't go over it */
+static void EndProgress(void)
+{
+    if (sShowsProgress)
+    {
+        fputc('\n', stderr);
+    }
+}
+
+static double GetTimeS(void)
+{
+    struct timespec Now;
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return Now.tv_sec + Now.tv_nsec * 1e-9;
+}
+
+void Platform_PushWork(platform_work_callback *Callback, void *Data)
+{
+    WorkQueue_Push(Callback, Data);
+}
+
+void Platform_CompleteAllWork(void)
+{
+    WorkQueue_CompleteAll();
+}
+
+int Platform_GetThreadCount(void)
+{
+    return WorkQueue_GetThreadCount();
+}
+
+
+
+void *Platform_PushMemory(int *PlatformMemory, int SizeBytes)
+{
+    int32_t AlignedSize = 0;
+    if (SizeBytes > 0)
+    {
+        /* align size to 4-byte boundary */
+        AlignedSize = (SizeBytes + sizeof(AlignedSize)) & ~0x3;
+    }
+
+    /* allocate the memory */
+    void *Memory = sStackAllocatorTop;
+    sStackAllocatorTop += AlignedSize;
+    uint8_t *StackEnd = (uint8_t *)(sStackAllocatorMemory + STATIC_ARRAY_SIZE(sStackAllocatorMemory));
+    assert(sStackAllocatorTop <= StackEnd && "Out of memory");
+
+    (*PlatformMemory) += AlignedSize;
+    return Memory;
+}
+
+void Platform_PopMemory(int SizeBytes)
+{
+    sStackAllocatorTop -= SizeBytes;
+    assert(sStackAllocatorTop >= (uint8_t *)sStackAllocatorMemory);
+}
+
+int Platform_BeginTempMemory(void)
+{
+    return 0;
+}
+
+char *Platform_PushNullTerminatedFileContentBlocking(int *PlatformMemory, const char *FileName)
+{
+    FILE *f = fopen(FileName, "rb");
+    if (!f)
+    {
+        return NULL;
+    }
+
+    /* little maneuver to get the file's size */
+    size_t FileSize = 0;
+    fseek(f, 0, SEEK_END);
+    FileSize = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    int FileBufferSize = FileSize + 1; /* null terminator */
+    char *FileBuffer = Platform_PushMemory(PlatformMemory, FileBufferSize);
+    if (FileSize != fread(FileBuffer, 1, FileSize, f))
+    {
+        *PlatformMemory -= FileBufferSize;
+        Platform_PopMemory(FileBufferSize);
+        fclose(f);
+        return NULL;
+    }
+
+    FileBuffer[FileSize] = '\0';
+    fclose(f);
+    return FileBuffer;
+}
+
+
+static void ResizeFramebuffer(int Width, int Height)
+{
+    free(sFramebuffer.Pixels);
+    sFramebuffer.Width = Width;
+    sFramebuffer.Height = Height;
+    sFramebuffer.Pixels = calloc((size_t)Width * Height, sizeof(u32));
+    if (!sFramebuffer.Pixels)
+    {
+        fprintf(stderr, "Unable to allocate a %dx%d framebuffer.\n", Width, Height);
+        exit(1);
+    }
+}
+
+void Platform_SetScreenBufferDimensions(int Width, int Height)
+{
+    if (!sFramebufferSizeIsFixed)
+    {
+        ResizeFramebuffer(Width, Height);
+    }
+}
+
+void Platform_SetFrameTimeTarget(double MillisecPerFrame)
+{
+    sFrameTimeTargetS = MillisecPerFrame * 0.001;
+}
+
+void Platform_SetVSync(bool8 Enable)
+{
+    (void)Enable; /* nothing to sync to */
+}
+
+bool8 Platform_IsKeyPressed(platform_key Key)
+{
+    (void)Key;
+    return false;
+}
+
+bool8 Platform_IsKeyDown(platform_key Key)
+{
+    (void)Key;
+    return false;
+}
+
+platform_framebuffer Platform_GetSoftwareFramebuffer(void)
+{
+    return sFramebuffer;
+}
+
+platform_window_dimensions Platform_GetWindowDimensions(void)
+{
+    return (platform_window_dimensions) {
+        .Width = sFramebuffer.Width,
+        .Height = sFramebuffer.Height,
+    };
+}
+
+double Platform_GetElapsedTimeMs(void)
+{
+    return (GetTimeS() - sStartTimeS) * 1000.0;
+}
+
+double Platform_GetFrameTimeMs(void)
+{
+    return sFrameTimeMs;
+}
+
+frame_time_stats Platform_GetFrameTimeStats(void)
+{
+    return Profiler_GetStats();
+}
+
+void Platform_BeginScope(const char *Name)
+{
+    Profiler_BeginScope(Name, Platform_GetElapsedTimeMs());
+}
+
+void Platform_EndScope(void)
+{
+    Profiler_EndScope(Platform_GetElapsedTimeMs());
+}
+
+bool8 Platform_WriteTrace(const char *FileName)
+{
+    return Profiler_WriteTrace(FileName);
+}
+
+void Platform_RequestRedraw(void)
+{
+    /* nothing to swap */
+    profiler_phase Phase = Profiler_SetPhase(PROFILER_PHASE_RENDER, Platform_GetElapsedTimeMs());
+    App_OnRedrawRequest(&sAppState, sFramebuffer.Width, sFramebuffer.Height);
+    Profiler_SetPhase(Phase, Platform_GetElapsedTimeMs());
+}
+
+
+static bool8 WriteFramebuffer(const char *FileName)
+{
+    FILE *f = strcmp(FileName, "-") == 0? stdout : fopen(FileName, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    image_writer Writer;
+    Image_Begin(&Writer, f, Image_GetFormat(FileName), sFramebuffer.Width, sFramebuffer.Height);
+    Image_WriteRows(&Writer, sFramebuffer.Pixels, sFramebuffer.Height);
+    bool8 Ok = Image_End(&Writer);
+
+    if (f != stdout)
+        Ok = fclose(f) == 0 && Ok;
+    return Ok;
+}
+
+/* 
+    The app's view at Width*Height around the same center, in the one tier that resolves all of it, 
+    parts rendered on their own wouldn't meet otherwise.
+    Scale is world units per pixel, 0 frames the app's view in Width.
+*/
+static render_view GetExportView(int Width, int Height, double Scale)
+{
+    bigfix Left = sAppState.WorldLeft;
+    bigfix Bottom = sAppState.WorldBottom;
+    Scale = Scale > 0? Scale : sAppState.WorldWidth / Width;
+    BigFix_AddDouble(&Left, 0.5 * (sAppState.WorldWidth - Width * Scale));
+    BigFix_AddDouble(&Bottom, 0.5 * (sAppState.WorldHeight - Height * Scale));
+    render_view View = {
+        .ScreenToWorldScaleFactor = Scale,
+        .WorldLeft = BigFix_ToDouble(&Left),
+        .WorldBottom = BigFix_ToDouble(&Bottom),
+        .ExactWorldLeft = Left,
+        .ExactWorldBottom = Bottom,
+        .IterationCount = sAppState.IterationCount,
+        .Width = Width,
+        .Height = Height,
+        .SkipsInterior = sAppState.SkipsInterior,
+        .PeriodicityTolerance = sAppState.PeriodicityTolerance,
+        .Method = sAppState.RenderMethod,
+    };
+    View.Precision = Renderer_ChoosePrecision(&View, RENDER_PRECISION_FLOAT);
+    return View;
+}
+
+/* 
+    Renders the app's view at Width*Height in bands of BandHeight rows, top first, 
+    each one written to FileName before the next one is rendered: 
+    memory goes with the band, the image can be far bigger than it.
+    Scale is world units per pixel, 0 frames the app's view.
+*/
+static bool8 ExportImage(const char *FileName, int Width, int Height, int BandHeight, double Scale)
+{
+    FILE *f = strcmp(FileName, "-") == 0? stdout : fopen(FileName, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    render_view View = GetExportView(Width, Height, Scale);
+
+    BandHeight = MIN(BandHeight, Height);
+    u32 *Pixels = malloc((size_t)Width * BandHeight * sizeof(u32));
+    if (!Pixels)
+    {
+        fprintf(stderr, "Unable to allocate a %dx%d band.\n", Width, BandHeight);
+        exit(1);
+    }
+    iteration_buffer Buffer = { 0 };
+    image_writer Writer;
+    double StartS = GetTimeS();
+    u64 IterationCount = 0;
+    Image_Begin(&Writer, f, Image_GetFormat(FileName), Width, Height);
+    for (int Top = 0; Top < Height && Writer.Ok; Top += BandHeight)
+    {
+        /* y goes up in the view, the top band is the highest one */
+        render_view BandView = View;
+        BandView.Height = MIN(BandHeight, Height - Top);
+        BandView.PixelOffsetY = Height - Top - BandView.Height;
+        Renderer_Render(&Buffer, &BandView, sAppState.ColorPalette, sAppState.ColorPaletteCount/3, Pixels);
+        IterationCount += Renderer_GetStats().IterationCount;
+        Image_WriteRows(&Writer, Pixels, BandView.Height);
+        PrintProgress("%d/%d rows", Top + BandView.Height, Height);
+    }
+    bool8 Ok = Image_End(&Writer);
+    if (f != stdout)
+        Ok = fclose(f) == 0 && Ok;
+
+    double TimeS = GetTimeS() - StartS;
+    EndProgress();
+    fprintf(stderr, "%dx%d in bands of %d rows, %d threads, %s, %s, tier: %s, %3.3fs, %3.3f Mpix/s, %3.3f Giter/s\n",
+        Width, Height, BandHeight,
+        Platform_GetThreadCount(),
+        Kernel_GetIsaName(Kernel_GetIsa()),
+        Renderer_GetMethodName(View.Method),
+        Renderer_GetPrecisionName(View.Precision),
+        TimeS,
+        (double)Width * Height / (TimeS * 1e6),
+        IterationCount / (TimeS * 1e9)
+    );
+    Renderer_FreeBuffer(&Buffer);
+    free(Pixels);
+    return Ok;
+}
+
+/* 
+    Deep zoom tile pyramid: level MaxLevel is the image at full size, every level above is half 
+    the one below, rounded up, down to 1x1 for DZI or one tile for XYZ. Tiles are counted from the top left.
+*/
+typedef struct pyramid_tile_job pyramid_tile_job;
+
+typedef struct tile_pyramid
+{
+    const char *Path; /* 'name.dzi', tiles in 'name_files/level/col_row.png', or the directory of 'z/x/y.png' */
+    bool8 IsXyz; /* z is level - HEADLESS_PYRAMID_TILE_LEVEL */
+    int Width, Height; /* of MaxLevel */
+    int MinLevel, MaxLevel;
+    int BlockLevel; /* tiles of it are rendered in one go at MaxLevel, the levels in between come from halving that */
+    render_view View; /* all of MaxLevel */
+    iteration_buffer Buffer;
+    /* 
+        A block from MaxLevel up to BlockLevel, and the jobs writing its tiles out. 
+        Two of them, the tiles of one block are written while the next one renders into the other.
+    */
+    u32 *BlockPixels[2][HEADLESS_PYRAMID_BLOCK_LEVELS + 1];
+    pyramid_tile_job *TileJobs[2];
+    u32 *Tiles; /* one for every level from MinLevel to BlockLevel */
+    u32 *Children; /* the 2x2 tiles under one, for every level from MinLevel */
+    i64 BlockCount, BlocksDone;
+    i64 RenderedCount, SkippedCount;
+    volatile i64 WrittenCount, FailedCount; /* by the tile jobs too */
+    u64 IterationCount;
+} tile_pyramid;
+
+struct pyramid_tile_job
+{
+    tile_pyramid *Pyramid;
+    int Level, Col, Row;
+    const u32 *Src; /* the tile's top left in its level of the block */
+    int SrcStride, Width, Height;
+    u32 *Pixels; /* the tile on its own */
+};
+
+static int GetLevelWidth(const tile_pyramid *Pyramid, int Level)
+{
+    return ((Pyramid->Width - 1) >> (Pyramid->MaxLevel - Level)) + 1;
+}
+
+static int GetLevelHeight(const tile_pyramid *Pyramid, int Level)
+{
+    return ((Pyramid->Height - 1) >> (Pyramid->MaxLevel - Level)) + 1;
+}
+
+static int GetTileCount(int Size)
+{
+    return (Size + HEADLESS_PYRAMID_TILE_SIZE - 1) / HEADLESS_PYRAMID_TILE_SIZE;
+}
+
+static void GetTilePath(const tile_pyramid *Pyramid, int Level, int Col, int Row, char *Path, size_t PathSize)
+{
+    if (Pyramid->IsXyz)
+    {
+        snprintf(Path, PathSize, "%s/%d/%d/%d.png", Pyramid->Path, Level - HEADLESS_PYRAMID_TILE_LEVEL, Col, Row);
+    }
+    else
+    {
+        int NameLen = strlen(Pyramid->Path) - strlen(".dzi");
+        snprintf(Path, PathSize, "%.*s_files/%d/%d_%d.png", NameLen, Pyramid->Path, Level, Col, Row);
+    }
+}
+
+/* mkdir -p of the directory FileName is in */
+static bool8 MakeParentDirectories(const char *FileName)
+{
+    char Path[HEADLESS_MAX_PATH];
+    snprintf(Path, sizeof Path, "%s", FileName);
+    for (char *Slash = strchr(Path + 1, '/'); Slash; Slash = strchr(Slash + 1, '/'))
+    {
+        *Slash = '\0';
+        if (mkdir(Path, 0777) != 0 && errno != EEXIST)
+            return false;
+        *Slash = '/';
+    }
+    return true;
+}
+
+/* written to the side and renamed, a tile that is there is always whole */
+static bool8 WriteTile(tile_pyramid *Pyramid, int Level, int Col, int Row, const u32 *Pixels, int Width, int Height)
+{
+    char Path[HEADLESS_MAX_PATH], TempPath[HEADLESS_MAX_PATH + 4];
+    GetTilePath(Pyramid, Level, Col, Row, Path, sizeof Path);
+    snprintf(TempPath, sizeof TempPath, "%s.tmp", Path);
+    FILE *f = MakeParentDirectories(Path)? fopen(TempPath, "wb") : NULL;
+    if (!f)
+        return false;
+
+    image_writer Writer;
+    Image_Begin(&Writer, f, IMAGE_FORMAT_PNG, Width, Height);
+    /* it runs as a job, and there are plenty of tiles to go around */
+    Writer.IsOnCallingThread = true;
+    Image_WriteRows(&Writer, Pixels, Height);
+    bool8 Ok = Image_End(&Writer);
+    Ok = fclose(f) == 0 && Ok;
+    Ok = Ok && rename(TempPath, Path) == 0;
+    AtomicAddI64(Ok? &Pyramid->WrittenCount : &Pyramid->FailedCount, 1);
+    return Ok;
+}
+
+/* Pixels can be NULL, then it only says whether the tile is there */
+static bool8 ReadTile(const tile_pyramid *Pyramid, int Level, int Col, int Row, u32 *Pixels)
+{
+    char Path[HEADLESS_MAX_PATH];
+    GetTilePath(Pyramid, Level, Col, Row, Path, sizeof Path);
+    if (!Pixels)
+        return access(Path, F_OK) == 0;
+
+    FILE *f = fopen(Path, "rb");
+    if (!f)
+        return false;
+    int Width = MIN(HEADLESS_PYRAMID_TILE_SIZE, GetLevelWidth(Pyramid, Level) - Col*HEADLESS_PYRAMID_TILE_SIZE);
+    int Height = MIN(HEADLESS_PYRAMID_TILE_SIZE, GetLevelHeight(Pyramid, Level) - Row*HEADLESS_PYRAMID_TILE_SIZE);
+    bool8 Ok = Image_ReadPng(f, Pixels, Width, Height);
+    fclose(f);
+    return Ok;
+}
+
+/* 
+    2x2 box filter, Dst is (Width + 1)/2 by (Height + 1)/2, the last column and row of an odd size count twice.
+    Src starts at an even pixel of its level so every tile's and block's halves line up.
+*/
+static void HalveImage(u32 *Dst, int DstStride, const u32 *Src, int SrcStride, int Width, int Height)
+{
+    for (int y = 0; y < (Height + 1) / 2; y++)
+    {
+        const u32 *Row0 = Src + (size_t)(2*y) * SrcStride;
+        const u32 *Row1 = Src + (size_t)MIN(2*y + 1, Height - 1) * SrcStride;
+        for (int x = 0; x < (Width + 1) / 2; x++)
+        {
+            int x0 = 2*x, x1 = MIN(2*x + 1, Width - 1);
+            u32 Pixel = 0;
+            for (int Shift = 0; Shift < 32; Shift += 8)
+            {
+                u32 Sum = (Row0[x0] >> Shift & 0xFF) + (Row0[x1] >> Shift & 0xFF) 
+                    + (Row1[x0] >> Shift & 0xFF) + (Row1[x1] >> Shift & 0xFF);
+                Pixel |= (Sum + 2) / 4 << Shift;
+            }
+            Dst[(size_t)y * DstStride + x] = Pixel;
+        }
+    }
+}
+
+static void WriteTileJob(void *Data)
+{
+    pyramid_tile_job *Job = Data;
+    for (int y = 0; y < Job->Height; y++)
+    {
+        memcpy(Job->Pixels + (size_t)y * Job->Width, Job->Src + (size_t)y * Job->SrcStride, Job->Width * sizeof(u32));
+    }
+    WriteTile(Job->Pyramid, Job->Level, Job->Col, Job->Row, Job->Pixels, Job->Width, Job->Height);
+}
+
+/* Src holds Width*Height of Level starting at tile (Col, Row), pushes a job for each tile of it that isn't there yet */
+static int PushMissingTiles(tile_pyramid *Pyramid, int Level, int Col, int Row, const u32 *Src, int Width, int Height, pyramid_tile_job *Jobs)
+{
+    int JobCount = 0;
+    for (int TileY = 0; TileY < GetTileCount(Height); TileY++)
+    {
+        for (int TileX = 0; TileX < GetTileCount(Width); TileX++)
+        {
+            if (ReadTile(Pyramid, Level, Col + TileX, Row + TileY, NULL))
+            {
+                Pyramid->SkippedCount++;
+                continue;
+            }
+            pyramid_tile_job *Job = &Jobs[JobCount++];
+            Job->Pyramid = Pyramid;
+            Job->Level = Level;
+            Job->Col = Col + TileX;
+            Job->Row = Row + TileY;
+            Job->Src = Src + (size_t)(TileY*HEADLESS_PYRAMID_TILE_SIZE) * Width + TileX*HEADLESS_PYRAMID_TILE_SIZE;
+            Job->SrcStride = Width;
+            Job->Width = MIN(HEADLESS_PYRAMID_TILE_SIZE, Width - TileX*HEADLESS_PYRAMID_TILE_SIZE);
+            Job->Height = MIN(HEADLESS_PYRAMID_TILE_SIZE, Height - TileY*HEADLESS_PYRAMID_TILE_SIZE);
+            Platform_PushWork(WriteTileJob, Job);
+        }
+    }
+    return JobCount;
+}
+
+/* 
+    One Renderer_Render() of everything under a tile of BlockLevel at MaxLevel, 
+    so that the renderer's workers have more than a tile's worth of its tiles to pick from.
+    The block's tiles are only pushed as jobs, they get written while the next block renders.
+    Pixels gets the block's own tile.
+*/
+static bool8 RenderBlock(tile_pyramid *Pyramid, int Col, int Row, u32 *Pixels)
+{
+    int Shift = Pyramid->MaxLevel - Pyramid->BlockLevel;
+    int Left = (Col * HEADLESS_PYRAMID_TILE_SIZE) << Shift;
+    int Top = (Row * HEADLESS_PYRAMID_TILE_SIZE) << Shift;
+    render_view View = Pyramid->View;
+    View.Width = MIN(HEADLESS_PYRAMID_TILE_SIZE << Shift, Pyramid->Width - Left);
+    View.Height = MIN(HEADLESS_PYRAMID_TILE_SIZE << Shift, Pyramid->Height - Top);
+    View.PixelOffsetX = Left;
+    /* y goes up in the view */
+    View.PixelOffsetY = Pyramid->Height - Top - View.Height;
+    /* the render waits for all work, the jobs of the block before, which use the other half, included */
+    u32 **Levels = Pyramid->BlockPixels[Pyramid->RenderedCount & 1];
+    pyramid_tile_job *Jobs = Pyramid->TileJobs[Pyramid->RenderedCount & 1];
+    Renderer_Render(&Pyramid->Buffer, &View, sAppState.ColorPalette, sAppState.ColorPaletteCount/3, Levels[0]);
+    Pyramid->IterationCount += Renderer_GetStats().IterationCount;
+    Pyramid->RenderedCount++;
+
+    int Width = View.Width, Height = View.Height;
+    int JobCount = 0;
+    for (int i = 0; i <= Shift; i++)
+    {
+        int Level = Pyramid->MaxLevel - i;
+        int LevelShift = Level - Pyramid->BlockLevel;
+        JobCount += PushMissingTiles(Pyramid, Level, Col << LevelShift, Row << LevelShift, Levels[i], Width, Height, Jobs + JobCount);
+        if (i < Shift)
+        {
+            HalveImage(Levels[i + 1], (Width + 1) / 2, Levels[i], Width, Width, Height);
+            Width = (Width + 1) / 2;
+            Height = (Height + 1) / 2;
+        }
+    }
+    /* what is left is the block's own tile */
+    memcpy(Pixels, Levels[Shift], (size_t)Width * Height * sizeof(u32));
+    return Pyramid->FailedCount == 0;
+}
+
+/* 
+    Depth first, a tile is only written once the ones below it are, 
+    so that when it is there, everything under it is too and a rerun can skip all of it.
+    The tile ends up in the level's Tiles.
+*/
+static bool8 BuildTile(tile_pyramid *Pyramid, int Level, int Col, int Row)
+{
+    size_t TileSize = (size_t)HEADLESS_PYRAMID_TILE_SIZE * HEADLESS_PYRAMID_TILE_SIZE;
+    u32 *Tile = Pyramid->Tiles + (size_t)(Level - Pyramid->MinLevel) * TileSize;
+    /* the top level has nothing to be halved into */
+    if (ReadTile(Pyramid, Level, Col, Row, Level > Pyramid->MinLevel? Tile : NULL))
+    {
+        /* every block under it is done */
+        int Shift = Pyramid->BlockLevel - Level;
+        int BlockCountX = GetTileCount(GetLevelWidth(Pyramid, Pyramid->BlockLevel));
+        int BlockCountY = GetTileCount(GetLevelHeight(Pyramid, Pyramid->BlockLevel));
+        Pyramid->BlocksDone += (i64)(MIN((Col + 1) << Shift, BlockCountX) - (Col << Shift))
+            * (MIN((Row + 1) << Shift, BlockCountY) - (Row << Shift));
+        Pyramid->SkippedCount++;
+        return true;
+    }
+
+    bool8 Ok = true;
+    if (Level == Pyramid->BlockLevel)
+    {
+        Ok = RenderBlock(Pyramid, Col, Row, Tile);
+        Pyramid->BlocksDone++;
+        PrintProgress("%lld/%lld blocks", (long long)Pyramid->BlocksDone, (long long)Pyramid->BlockCount);
+    }
+    else
+    {
+        /* the 4 tiles below, or fewer at the right and bottom edges, side by side */
+        int LevelWidth = GetLevelWidth(Pyramid, Level + 1);
+        int LevelHeight = GetLevelHeight(Pyramid, Level + 1);
+        int Stride = 2*HEADLESS_PYRAMID_TILE_SIZE;
+        u32 *Children = Pyramid->Children + (size_t)(Level - Pyramid->MinLevel) * 4*TileSize;
+        /* the level below's tile */
+        const u32 *Child = Tile + TileSize;
+        int Left = 2*Col*HEADLESS_PYRAMID_TILE_SIZE, Top = 2*Row*HEADLESS_PYRAMID_TILE_SIZE;
+        int Width = MIN(Stride, LevelWidth - Left), Height = MIN(Stride, LevelHeight - Top);
+        for (int i = 0; i < 4 && Ok; i++)
+        {
+            int ChildX = (i & 1) * HEADLESS_PYRAMID_TILE_SIZE, ChildY = (i >> 1) * HEADLESS_PYRAMID_TILE_SIZE;
+            if (ChildX >= Width || ChildY >= Height)
+                continue;
+
+            Ok = BuildTile(Pyramid, Level + 1, 2*Col + (i & 1), 2*Row + (i >> 1));
+            int ChildWidth = MIN(HEADLESS_PYRAMID_TILE_SIZE, Width - ChildX);
+            int ChildHeight = MIN(HEADLESS_PYRAMID_TILE_SIZE, Height - ChildY);
+            for (int y = 0; y < ChildHeight; y++)
+            {
+                memcpy(Children + (size_t)(ChildY + y) * Stride + ChildX, Child + (size_t)y * ChildWidth, ChildWidth * sizeof(u32));
+            }
+        }
+        HalveImage(Tile, (Width + 1) / 2, Children, Stride, Width, Height);
+        /* the tiles under it are still being written by the blocks' jobs */
+        Platform_CompleteAllWork();
+        Ok = Ok && Pyramid->FailedCount == 0 && WriteTile(Pyramid, Level, Col, Row, Tile, (Width + 1) / 2, (Height + 1) / 2);
+    }
+    return Ok;
+}
+
+/* 
+    Renders the app's view at Width*Height as a tile pyramid, skipping whatever a previous run already wrote.
+    XYZ rounds the size up to a square of HEADLESS_PYRAMID_TILE_SIZE times a power of 2 around the same center.
+    Scale is world units per pixel of the full size, 0 frames the app's view in Width.
+*/
+static bool8 WritePyramid(const char *Path, int Width, int Height, double Scale)
+{
+    size_t PathLen = strlen(Path);
+    tile_pyramid Pyramid = {
+        .Path = Path,
+        .IsXyz = !(PathLen > 4 && strcmp(Path + PathLen - 4, ".dzi") == 0),
+    };
+    Scale = Scale > 0? Scale : sAppState.WorldWidth / Width;
+    while ((1 << Pyramid.MaxLevel) < MAX(Width, Height))
+    {
+        Pyramid.MaxLevel++;
+    }
+    if (Pyramid.IsXyz)
+    {
+        Pyramid.MaxLevel = MAX(Pyramid.MaxLevel, HEADLESS_PYRAMID_TILE_LEVEL);
+        Pyramid.MinLevel = HEADLESS_PYRAMID_TILE_LEVEL;
+        Width = Height = 1 << Pyramid.MaxLevel;
+    }
+    else
+    {
+        /* the .dzi first, a viewer can show the levels as they come */
+        FILE *f = MakeParentDirectories(Path)? fopen(Path, "wb") : NULL;
+        if (!f)
+            return false;
+        fprintf(f, 
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" TileSize=\"%d\" Overlap=\"0\" Format=\"png\">\n"
+            "    <Size Width=\"%d\" Height=\"%d\"/>\n"
+            "</Image>\n",
+            HEADLESS_PYRAMID_TILE_SIZE, Width, Height
+        );
+        bool8 Ok = !ferror(f);
+        if (fclose(f) != 0 || !Ok)
+            return false;
+    }
+    Pyramid.Width = Width;
+    Pyramid.Height = Height;
+    Pyramid.BlockLevel = MAX(Pyramid.MaxLevel - HEADLESS_PYRAMID_BLOCK_LEVELS, Pyramid.MinLevel);
+
+    Pyramid.View = GetExportView(Width, Height, Scale);
+
+    /* every buffer the blocks and tiles need, up front */
+    int Shift = Pyramid.MaxLevel - Pyramid.BlockLevel;
+    size_t TileSize = (size_t)HEADLESS_PYRAMID_TILE_SIZE * HEADLESS_PYRAMID_TILE_SIZE;
+    int BlockTileCount = 0;
+    for (int i = 0; i <= Shift; i++)
+    {
+        BlockTileCount += 1 << 2*i;
+    }
+    int LevelCount = Pyramid.BlockLevel - Pyramid.MinLevel + 1;
+    u32 *JobPixels = malloc(2 * BlockTileCount * TileSize * sizeof(u32));
+    Pyramid.Tiles = malloc(LevelCount * TileSize * sizeof(u32));
+    Pyramid.Children = malloc(LevelCount * 4*TileSize * sizeof(u32));
+    ASSERT(JobPixels && Pyramid.Tiles && Pyramid.Children, "Out of memory");
+    for (int Half = 0; Half < 2; Half++)
+    {
+        for (int i = 0; i <= Shift; i++)
+        {
+            Pyramid.BlockPixels[Half][i] = malloc((TileSize << 2*(Shift - i)) * sizeof(u32));
+            ASSERT(Pyramid.BlockPixels[Half][i], "Out of memory");
+        }
+        Pyramid.TileJobs[Half] = calloc(BlockTileCount, sizeof(pyramid_tile_job));
+        ASSERT(Pyramid.TileJobs[Half], "Out of memory");
+        for (int i = 0; i < BlockTileCount; i++)
+        {
+            Pyramid.TileJobs[Half][i].Pixels = JobPixels + (size_t)(Half*BlockTileCount + i) * TileSize;
+        }
+    }
+    Pyramid.BlockCount = (i64)GetTileCount(GetLevelWidth(&Pyramid, Pyramid.BlockLevel)) 
+        * GetTileCount(GetLevelHeight(&Pyramid, Pyramid.BlockLevel));
+
+    double StartS = GetTimeS();
+    bool8 Ok = true;
+    for (int Row = 0; Row < GetTileCount(GetLevelHeight(&Pyramid, Pyramid.MinLevel)) && Ok; Row++)
+    {
+        for (int Col = 0; Col < GetTileCount(GetLevelWidth(&Pyramid, Pyramid.MinLevel)) && Ok; Col++)
+        {
+            Ok = BuildTile(&Pyramid, Pyramid.MinLevel, Col, Row);
+        }
+    }
+    /* the last block's tiles */
+    Platform_CompleteAllWork();
+    Ok = Ok && Pyramid.FailedCount == 0;
+
+    double TimeS = GetTimeS() - StartS;
+    EndProgress();
+    fprintf(stderr, "%dx%d, levels %d to %d, %lld tiles written, %lld already there, %lld blocks rendered, %d threads, %s, %s, tier: %s, %3.3fs, %3.3f Giter/s\n",
+        Width, Height, 
+        Pyramid.MinLevel - (Pyramid.IsXyz? HEADLESS_PYRAMID_TILE_LEVEL : 0), 
+        Pyramid.MaxLevel - (Pyramid.IsXyz? HEADLESS_PYRAMID_TILE_LEVEL : 0),
+        (long long)Pyramid.WrittenCount, (long long)Pyramid.SkippedCount, (long long)Pyramid.RenderedCount,
+        Platform_GetThreadCount(),
+        Kernel_GetIsaName(Kernel_GetIsa()),
+        Renderer_GetMethodName(Pyramid.View.Method),
+        Renderer_GetPrecisionName(Pyramid.View.Precision),
+        TimeS,
+        Pyramid.IterationCount / (TimeS * 1e9)
+    );
+    Renderer_FreeBuffer(&Pyramid.Buffer);
+    for (int Half = 0; Half < 2; Half++)
+    {
+        for (int i = 0; i <= Shift; i++)
+        {
+            free(Pyramid.BlockPixels[Half][i]);
+        }
+        free(Pyramid.TileJobs[Half]);
+    }
+    free(JobPixels);
+    free(Pyramid.Tiles);
+    free(Pyramid.Children);
+    return Ok;
+}
+
+typedef struct farm_request
+{
+    i32 Tile;
+} farm_request;
+
+/* followed by Width*Height pixels, top row first */
+typedef struct farm_reply
+{
+    i32 Tile;
+    i32 Width, Height;
+    i64 IterationCount;
+} farm_reply;
+
+typedef struct farm_worker
+{
+    pid_t Pid;
+    int Socket; /* -1 once it is gone */
+    i32 Tiles[HEADLESS_FARM_QUEUE_DEPTH]; /* handed to it, oldest first */
+    int TileCount;
+} farm_worker;
+
+/* 
+    Processes of its own, forked from the coordinator, rendering tiles of View over a Unix socket. 
+    Tiles are handed out in order, each row of them written once all of it came back.
+*/
+typedef struct render_farm
+{
+    render_view View;
+    int TileCountX, TileCountY;
+    farm_worker Workers[HEADLESS_MAX_FARM_WORKER_COUNT];
+    int WorkerCount;
+    int RespawnCount, MaxRespawnCount;
+    u8 *HolderCounts; /* of every tile, workers rendering it */
+    bool8 *IsDone; /* of every tile, written to its band or already to the file */
+    u32 *Bands; /* HEADLESS_FARM_WINDOW_ROWS rows of tiles, row y goes to band y % HEADLESS_FARM_WINDOW_ROWS */
+    u32 *TilePixels; /* of a reply */
+    int WrittenRowCount; /* of tiles */
+    i64 IterationCount;
+    int TakenOverCount;
+} render_farm;
+
+
+static bool8 ReadAll(int Socket, void *Data, size_t Size)
+{
+    u8 *Bytes = Data;
+    while (Size > 0)
+    {
+        ssize_t Count = read(Socket, Bytes, Size);
+        if (Count < 0 && errno == EINTR)
+            continue;
+        if (Count <= 0)
+            return false;
+        Bytes += Count;
+        Size -= Count;
+    }
+    return true;
+}
+
+/* a worker that is gone is an error, not a SIGPIPE */
+static bool8 WriteAll(int Socket, const void *Data, size_t Size)
+{
+    const u8 *Bytes = Data;
+    while (Size > 0)
+    {
+        ssize_t Count = send(Socket, Bytes, Size, MSG_NOSIGNAL);
+        if (Count < 0 && errno == EINTR)
+            continue;
+        if (Count <= 0)
+            return false;
+        Bytes += Count;
+        Size -= Count;
+    }
+    return true;
+}
+
+/* rows of tiles go top first, like the image */
+static render_view GetFarmTileView(const render_farm *Farm, i32 Tile)
+{
+    render_view TileView = Farm->View;
+    int Col = Tile % Farm->TileCountX;
+    int Row = Tile / Farm->TileCountX;
+    TileView.Width = MIN(HEADLESS_FARM_TILE_SIZE, Farm->View.Width - Col*HEADLESS_FARM_TILE_SIZE);
+    TileView.Height = MIN(HEADLESS_FARM_TILE_SIZE, Farm->View.Height - Row*HEADLESS_FARM_TILE_SIZE);
+    TileView.PixelOffsetX = Col*HEADLESS_FARM_TILE_SIZE;
+    TileView.PixelOffsetY = Farm->View.Height - Row*HEADLESS_FARM_TILE_SIZE - TileView.Height;
+    return TileView;
+}
+
+/* the worker process, never returns */
+static void RunFarmWorker(const render_farm *Farm, int Socket, int CrashAfterTileCount)
+{
+    WorkQueue_ForgetThreads();
+    iteration_buffer Buffer = { 0 };
+    u32 *Pixels = malloc((size_t)HEADLESS_FARM_TILE_SIZE * HEADLESS_FARM_TILE_SIZE * sizeof(u32));
+    if (!Pixels)
+        _exit(1);
+
+    farm_request Request;
+    int TileCount = 0;
+    while (ReadAll(Socket, &Request, sizeof Request))
+    {
+        if (CrashAfterTileCount > 0 && TileCount == CrashAfterTileCount)
+            _exit(1);
+
+        render_view TileView = GetFarmTileView(Farm, Request.Tile);
+        Renderer_Render(&Buffer, &TileView, sAppState.ColorPalette, sAppState.ColorPaletteCount/3, Pixels);
+        farm_reply Reply = {
+            .Tile = Request.Tile,
+            .Width = TileView.Width,
+            .Height = TileView.Height,
+            .IterationCount = Renderer_GetStats().IterationCount,
+        };
+        if (!WriteAll(Socket, &Reply, sizeof Reply) 
+        || !WriteAll(Socket, Pixels, (size_t)TileView.Width * TileView.Height * sizeof(u32)))
+            break;
+        TileCount++;
+    }
+    /* exit() would flush the coordinator's stdio buffers a second time */
+    _exit(0);
+}
+
+static bool8 SpawnFarmWorker(render_farm *Farm, farm_worker *Worker, int CrashAfterTileCount)
+{
+    int Sockets[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, Sockets) != 0)
+        return false;
+
+    fflush(NULL);
+    pid_t Pid = fork();
+    if (Pid < 0)
+    {
+        close(Sockets[0]);
+        close(Sockets[1]);
+        return false;
+    }
+    if (Pid == 0)
+    {
+        close(Sockets[0]);
+        for (int i = 0; i < Farm->WorkerCount; i++)
+        {
+            if (Farm->Workers[i].Socket >= 0)
+                close(Farm->Workers[i].Socket);
+        }
+        RunFarmWorker(Farm, Sockets[1], CrashAfterTileCount);
+    }
+    close(Sockets[1]);
+    *Worker = (farm_worker) {
+        .Pid = Pid,
+        .Socket = Sockets[0],
+    };
+    return true;
+}
+
+/* whatever it was on goes back to the others, a new worker takes its place while there are respawns left */
+static void ReplaceFarmWorker(render_farm *Farm, farm_worker *Worker)
+{
+    close(Worker->Socket);
+    kill(Worker->Pid, SIGKILL);
+    waitpid(Worker->Pid, NULL, 0);
+    for (int i = 0; i < Worker->TileCount; i++)
+    {
+        Farm->HolderCounts[Worker->Tiles[i]]--;
+    }
+    *Worker = (farm_worker) { .Socket = -1 };
+
+    if (Farm->RespawnCount < Farm->MaxRespawnCount && SpawnFarmWorker(Farm, Worker, 0))
+    {
+        Farm->RespawnCount++;
+        EndProgress();
+        fprintf(stderr, "A worker died, respawned it (%d/%d)\n", Farm->RespawnCount, Farm->MaxRespawnCount);
+    }
+}
+
+/* 
+    The first tile no one has, in the window of rows being worked on. 
+    Once there is none, the first one that is still being worked on by someone else:
+    an idle worker takes it over, whoever is first wins, so one slow worker never holds up the rows behind it.
+*/
+static i32 GetNextFarmTile(render_farm *Farm, const farm_worker *Worker)
+{
+    i32 FirstTile = Farm->WrittenRowCount * Farm->TileCountX;
+    i32 EndTile = MIN(Farm->WrittenRowCount + HEADLESS_FARM_WINDOW_ROWS, Farm->TileCountY) * Farm->TileCountX;
+    for (i32 Tile = FirstTile; Tile < EndTile; Tile++)
+    {
+        if (!Farm->IsDone[Tile] && Farm->HolderCounts[Tile] == 0)
+            return Tile;
+    }
+    for (i32 Tile = FirstTile; Tile < EndTile; Tile++)
+    {
+        bool8 IsHeld = false;
+        for (int i = 0; i < Worker->TileCount; i++)
+        {
+            IsHeld = IsHeld || Worker->Tiles[i] == Tile;
+        }
+        if (!Farm->IsDone[Tile] && !IsHeld && Farm->HolderCounts[Tile] < HEADLESS_FARM_MAX_HOLDER_COUNT)
+        {
+            Farm->TakenOverCount++;
+            return Tile;
+        }
+    }
+    return -1;
+}
+
+/* false when the worker is gone or sent something that isn't a tile it had */
+static bool8 ReceiveFarmTile(render_farm *Farm, farm_worker *Worker)
+{
+    farm_reply Reply;
+    if (!ReadAll(Worker->Socket, &Reply, sizeof Reply) || Worker->TileCount == 0 || Reply.Tile != Worker->Tiles[0])
+        return false;
+
+    render_view TileView = GetFarmTileView(Farm, Reply.Tile);
+    if (Reply.Width != TileView.Width || Reply.Height != TileView.Height
+    || !ReadAll(Worker->Socket, Farm->TilePixels, (size_t)Reply.Width * Reply.Height * sizeof(u32)))
+        return false;
+
+    /* workers answer in the order they were asked */
+    Worker->TileCount--;
+    memmove(Worker->Tiles, Worker->Tiles + 1, Worker->TileCount * sizeof(i32));
+    Farm->HolderCounts[Reply.Tile]--;
+    if (Farm->IsDone[Reply.Tile])
+        return true;
+
+    int Col = Reply.Tile % Farm->TileCountX;
+    int Row = Reply.Tile / Farm->TileCountX;
+    u32 *Band = Farm->Bands + (size_t)(Row % HEADLESS_FARM_WINDOW_ROWS) * HEADLESS_FARM_TILE_SIZE * Farm->View.Width;
+    for (int y = 0; y < Reply.Height; y++)
+    {
+        memcpy(
+            Band + (size_t)y * Farm->View.Width + Col*HEADLESS_FARM_TILE_SIZE, 
+            Farm->TilePixels + (size_t)y * Reply.Width, 
+            Reply.Width * sizeof(u32)
+        );
+    }
+    Farm->IsDone[Reply.Tile] = true;
+    Farm->IterationCount += Reply.IterationCount;
+    return true;
+}
+
+/* 
+    Renders the app's view at Width*Height on WorkerCount processes to FileName, in HEADLESS_FARM_TILE_SIZE tiles.
+    A worker that dies or stops making sense is killed and its tiles go to the others.
+    The first workers die after CrashAfterTileCount tiles when it isn't 0, the ones that replace them don't.
+    Scale is world units per pixel, 0 frames the app's view.
+*/
+static bool8 RunRenderFarm(const char *FileName, int Width, int Height, int WorkerCount, int CrashAfterTileCount, double Scale)
+{
+    FILE *f = strcmp(FileName, "-") == 0? stdout : fopen(FileName, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    render_farm Farm = {
+        .View = GetExportView(Width, Height, Scale),
+        .TileCountX = (Width + HEADLESS_FARM_TILE_SIZE - 1) / HEADLESS_FARM_TILE_SIZE,
+        .TileCountY = (Height + HEADLESS_FARM_TILE_SIZE - 1) / HEADLESS_FARM_TILE_SIZE,
+        .MaxRespawnCount = 2*WorkerCount,
+    };
+    i32 TileCount = Farm.TileCountX * Farm.TileCountY;
+    Farm.HolderCounts = calloc(TileCount, sizeof(u8));
+    Farm.IsDone = calloc(TileCount, sizeof(bool8));
+    Farm.Bands = malloc((size_t)HEADLESS_FARM_WINDOW_ROWS * HEADLESS_FARM_TILE_SIZE * Width * sizeof(u32));
+    Farm.TilePixels = malloc((size_t)HEADLESS_FARM_TILE_SIZE * HEADLESS_FARM_TILE_SIZE * sizeof(u32));
+    ASSERT(Farm.HolderCounts && Farm.IsDone && Farm.Bands && Farm.TilePixels, "Out of memory");
+
+    double StartS = GetTimeS();
+    bool8 Ok = true;
+    Farm.WorkerCount = MIN(WorkerCount, HEADLESS_MAX_FARM_WORKER_COUNT);
+    for (int i = 0; i < Farm.WorkerCount; i++)
+    {
+        Farm.Workers[i].Socket = -1;
+    }
+    for (int i = 0; i < Farm.WorkerCount && Ok; i++)
+    {
+        Ok = SpawnFarmWorker(&Farm, &Farm.Workers[i], CrashAfterTileCount);
+    }
+
+    image_writer Writer;
+    Image_Begin(&Writer, f, Image_GetFormat(FileName), Width, Height);
+    while (Ok && Farm.WrittenRowCount < Farm.TileCountY)
+    {
+        struct pollfd Polls[HEADLESS_MAX_FARM_WORKER_COUNT];
+        int PollCount = 0;
+        for (int i = 0; i < Farm.WorkerCount; i++)
+        {
+            farm_worker *Worker = &Farm.Workers[i];
+            if (Worker->Socket < 0)
+                continue;
+
+            i32 Tile;
+            while (Worker->TileCount < HEADLESS_FARM_QUEUE_DEPTH && (Tile = GetNextFarmTile(&Farm, Worker)) >= 0)
+            {
+                farm_request Request = { .Tile = Tile };
+                if (!WriteAll(Worker->Socket, &Request, sizeof Request))
+                    break;
+                Worker->Tiles[Worker->TileCount++] = Tile;
+                Farm.HolderCounts[Tile]++;
+            }
+            Polls[PollCount++] = (struct pollfd) { .fd = Worker->Socket, .events = POLLIN };
+        }
+        if (PollCount == 0)
+        {
+            EndProgress();
+            fprintf(stderr, "Every worker died\n");
+            Ok = false;
+            break;
+        }
+        if (poll(Polls, PollCount, -1) < 0 && errno != EINTR)
+        {
+            Ok = false;
+            break;
+        }
+
+        for (int i = 0, p = 0; i < Farm.WorkerCount; i++)
+        {
+            farm_worker *Worker = &Farm.Workers[i];
+            if (Worker->Socket < 0 || Polls[p++].revents == 0)
+                continue;
+            if (!ReceiveFarmTile(&Farm, Worker))
+                ReplaceFarmWorker(&Farm, Worker);
+        }
+
+        /* every row of tiles in order, as soon as all of it is there */
+        while (Farm.WrittenRowCount < Farm.TileCountY && Writer.Ok)
+        {
+            i32 FirstTile = Farm.WrittenRowCount * Farm.TileCountX;
+            bool8 IsRowDone = true;
+            for (int x = 0; x < Farm.TileCountX; x++)
+            {
+                IsRowDone = IsRowDone && Farm.IsDone[FirstTile + x];
+            }
+            if (!IsRowDone)
+                break;
+
+            int Row = Farm.WrittenRowCount;
+            int RowCount = MIN(HEADLESS_FARM_TILE_SIZE, Height - Row*HEADLESS_FARM_TILE_SIZE);
+            Image_WriteRows(&Writer, Farm.Bands + (size_t)(Row % HEADLESS_FARM_WINDOW_ROWS) * HEADLESS_FARM_TILE_SIZE * Width, RowCount);
+            Farm.WrittenRowCount++;
+            PrintProgress("%d/%d rows", Row*HEADLESS_FARM_TILE_SIZE + RowCount, Height);
+        }
+        Ok = Ok && Writer.Ok;
+    }
+
+    /* the workers see the end of their socket and leave */
+    for (int i = 0; i < Farm.WorkerCount; i++)
+    {
+        farm_worker *Worker = &Farm.Workers[i];
+        if (Worker->Socket < 0)
+            continue;
+        close(Worker->Socket);
+        waitpid(Worker->Pid, NULL, 0);
+    }
+    Ok = Image_End(&Writer) && Ok;
+    if (f != stdout)
+        Ok = fclose(f) == 0 && Ok;
+
+    double TimeS = GetTimeS() - StartS;
+    EndProgress();
+    fprintf(stderr, "%dx%d in %d tiles of %d, %d workers, %d respawned, %d tiles taken over, %s, %s, tier: %s, %3.3fs, %3.3f Mpix/s, %3.3f Giter/s\n",
+        Width, Height, TileCount, HEADLESS_FARM_TILE_SIZE,
+        Farm.WorkerCount, Farm.RespawnCount, Farm.TakenOverCount,
+        Kernel_GetIsaName(Kernel_GetIsa()),
+        Renderer_GetMethodName(Farm.View.Method),
+        Renderer_GetPrecisionName(Farm.View.Precision),
+        TimeS,
+        (double)Width * Height / (TimeS * 1e6),
+        Farm.IterationCount / (TimeS * 1e9)
+    );
+    free(Farm.HolderCounts);
+    free(Farm.IsDone);
+    free(Farm.Bands);
+    free(Farm.TilePixels);
+    return Ok;
+}
+
+/* BT.601 limited range, the planes of Y4M's C444 one after the other */
+static void ConvertToYuv(u8 *Planes, const u32 *Pixels, size_t PixelCount)
+{
+    u8 *Y = Planes, *U = Planes + PixelCount, *V = Planes + 2*PixelCount;
+    for (size_t i = 0; i < PixelCount; i++)
+    {
+        int R = Pixels[i] & 0xFF, G = Pixels[i] >> 8 & 0xFF, B = Pixels[i] >> 16 & 0xFF;
+        Y[i] = ((66*R + 129*G + 25*B + 128) >> 8) + 16;
+        U[i] = ((-38*R - 74*G + 112*B + 128) >> 8) + 128;
+        V[i] = ((112*R - 94*G - 18*B + 128) >> 8) + 128;
+    }
+}
+
+/* 
+    Zooms into the center of the app's view by Zoom over FrameCount frames, as Y4M.
+    Every frame is resampled from one exp_map of the whole zoom instead of rendered,
+    which costs about Width/2 * ln(Zoom) rings of 4*Width pixels, however many frames there are.
+    Scale is world units per pixel of the first frame, 0 frames the app's view in Width.
+*/
+static bool8 WriteZoomVideo(const char *FileName, int Width, int Height, int FrameCount, double Zoom, double Scale)
+{
+    FILE *f = strcmp(FileName, "-") == 0? stdout : fopen(FileName, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    /* each ring gets the tier it needs */
+    render_view View = GetExportView(Width, Height, Scale);
+    Scale = View.ScreenToWorldScaleFactor;
+
+    /* the core is the last frame, the outermost ring frames the first one */
+    int Size = (MAX(Width, Height) + 1) & ~1;
+    exp_map Map = { 0 };
+    double StartS = GetTimeS();
+    render_stats Stats = ExpMap_Render(&Map, &View, Size, Scale / Zoom, Zoom);
+    double MapTimeS = GetTimeS() - StartS;
+    fprintf(stderr, "%d rings of %d pixels around %dx%d in %3.3fs\n", Map.RingCount, 4*Size + 4, Size, Size, MapTimeS);
+
+    size_t PixelCount = (size_t)Width * Height;
+    u32 *Iterations = malloc(PixelCount * sizeof(u32));
+    u32 *Pixels = malloc(PixelCount * sizeof(u32));
+    u8 *Planes = malloc(3 * PixelCount);
+    ASSERT(Iterations && Pixels && Planes, "Out of memory");
+    fprintf(f, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", Width, Height, HEADLESS_VIDEO_FRAME_RATE);
+    bool8 Ok = true;
+    for (int Frame = 0; Frame < FrameCount && Ok; Frame++)
+    {
+        /* the same factor every frame, so that the zoom looks steady */
+        double FrameScale = Scale * pow(Zoom, -(double)Frame / MAX(FrameCount - 1, 1));
+        ExpMap_Resample(&Map, FrameScale, Width, Height, Iterations);
+        Renderer_ColorIterations(Iterations, &View, sAppState.ColorPalette, sAppState.ColorPaletteCount/3, Pixels);
+        ConvertToYuv(Planes, Pixels, PixelCount);
+        Ok = fputs("FRAME\n", f) >= 0 && fwrite(Planes, 1, 3 * PixelCount, f) == 3 * PixelCount;
+        PrintProgress("%d/%d frames", Frame + 1, FrameCount);
+    }
+    Ok = Ok && fflush(f) == 0;
+    if (f != stdout)
+        Ok = fclose(f) == 0 && Ok;
+
+    double TimeS = GetTimeS() - StartS;
+    EndProgress();
+    fprintf(stderr, "%dx%d, %d frames zooming %g times, %d threads, %s, tiers: %s to %s, map: %3.3fs for %3.1f frames' worth of pixels, %3.3f Giter/s, frames: %3.3fms each\n",
+        Width, Height, FrameCount, Zoom,
+        Platform_GetThreadCount(),
+        Kernel_GetIsaName(Kernel_GetIsa()),
+        Renderer_GetPrecisionName(Map.MinPrecision),
+        Renderer_GetPrecisionName(Map.MaxPrecision),
+        MapTimeS,
+        (double)Stats.PixelCount / PixelCount,
+        Stats.IterationCount / (MapTimeS * 1e9),
+        (TimeS - MapTimeS) * 1000.0 / MAX(FrameCount, 1)
+    );
+    ExpMap_Free(&Map);
+    free(Iterations);
+    free(Pixels);
+    free(Planes);
+    return Ok;
+}
+
+static size_t CountMismatches(const iteration_buffer *A, const iteration_buffer *B, const render_view *View)
+{
+    size_t MismatchCount = 0;
+    for (int y = 0; y < View->Height; y++)
+    {
+        for (int x = 0; x < View->Width; x++)
+        {
+            size_t i = (size_t)y * View->Width + x;
+            MismatchCount += A->Iterations[i] != B->Iterations[i];
+        }
+    }
+    return MismatchCount;
+}
+
+/* xorshift, the same numbers every run */
+static u32 GetRandomU32(u64 *State)
+{
+    *State ^= *State << 13;
+    *State ^= *State >> 7;
+    *State ^= *State << 17;
+    return (u32)(*State >> 32);
+}
+
+/* 
+    Holds BigFix_Mul() and BigFix_Sqr() at every limb count against the exact product of the limbs they see,
+    BigFix_Sqr() must match BigFix_Mul() bit for bit. Also reports what each costs against BigFix_MulExact().
+*/
+static bool8 VerifyBigFix(void)
+{
+    enum { NumberCount = 256 };
+    static bigfix Numbers[NumberCount];
+    u64 Random = 0x9E3779B97F4A7C15ull;
+    for (int i = 0; i < NumberCount; i++)
+    {
+        for (int k = 0; k < BIGFIX_LIMB_COUNT; k++)
+        {
+            Numbers[i].Limbs[k] = GetRandomU32(&Random);
+        }
+        /* like z of an orbit, |z| < 2, and a few with only the top limbs set */
+        Numbers[i].Limbs[BIGFIX_LIMB_COUNT - 1] = (GetRandomU32(&Random) & 1)? 1 : (u32)-2;
+        for (int k = 0; k < (i % 4 == 0? BIGFIX_LIMB_COUNT - 3 : 0); k++)
+        {
+            Numbers[i].Limbs[k] = 0;
+        }
+    }
+
+    bool8 AllMatch = true;
+    for (int LimbCount = BIGFIX_MIN_LIMB_COUNT; LimbCount <= BIGFIX_LIMB_COUNT; LimbCount++)
+    {
+        int MaxError = 0, SqrMismatchCount = 0;
+        for (int i = 0; i < NumberCount; i++)
+        {
+            const bigfix *A = &Numbers[i], *B = &Numbers[(i*7 + 3) % NumberCount];
+            bigfix Got, Expected, Error;
+            BigFix_Mul(&Got, A, B, LimbCount);
+            BigFix_MulExact(&Expected, A, B, LimbCount);
+            /* in units of the lowest limb kept, either way since negative products round the magnitude down */
+            BigFix_Sub(&Error, &Expected, &Got);
+            double Ulps = AbsF(ldexp(BigFix_ToDouble(&Error), 32*(LimbCount - 1)));
+            MaxError = MAX(MaxError, (int)ceil(Ulps));
+
+            bigfix Square, Product;
+            BigFix_Sqr(&Square, A, LimbCount);
+            BigFix_Mul(&Product, A, A, LimbCount);
+            SqrMismatchCount += memcmp(&Square, &Product, sizeof Square) != 0;
+        }
+        bool8 Ok = MaxError <= LimbCount + 1 && SqrMismatchCount == 0;
+        AllMatch = AllMatch && Ok;
+        if (!Ok || (LimbCount & (LimbCount - 1)) == 0)
+        {
+            fprintf(stderr, "bigfix %d limbs: products off by %d at most in the lowest limb, %d squares off\n", LimbCount, MaxError, SqrMismatchCount);
+        }
+    }
+
+    /* what a reference orbit spends its time on */
+    enum { RepeatCount = 20000 };
+    for (int LimbCount = 4; LimbCount <= BIGFIX_LIMB_COUNT; LimbCount *= 2)
+    {
+        bigfix Out = { 0 };
+        double StartS = GetTimeS();
+        for (int i = 0; i < RepeatCount; i++)
+            BigFix_Sqr(&Out, &Numbers[i % NumberCount], LimbCount);
+        double SqrNs = (GetTimeS() - StartS) * 1e9 / RepeatCount;
+        StartS = GetTimeS();
+        for (int i = 0; i < RepeatCount; i++)
+            BigFix_Mul(&Out, &Numbers[i % NumberCount], &Numbers[(i + 1) % NumberCount], LimbCount);
+        double MulNs = (GetTimeS() - StartS) * 1e9 / RepeatCount;
+        StartS = GetTimeS();
+        for (int i = 0; i < RepeatCount; i++)
+            BigFix_MulExact(&Out, &Numbers[i % NumberCount], &Numbers[(i + 1) % NumberCount], LimbCount);
+        double ExactNs = (GetTimeS() - StartS) * 1e9 / RepeatCount;
+        fprintf(stderr, "bigfix %d limbs: sqr %3.1fns, mul %3.1fns, schoolbook %3.1fns, %3.1fx slower than sqr\n", 
+            LimbCount, SqrNs, MulNs, ExactNs, ExactNs / SqrNs
+        );
+    }
+    return AllMatch;
+}
+
+/* 
+    renders the app's view with every kernel ISA and compares the counts against the scalar kernel, 
+    from scratch, continued from half the iteration count, and panned from there
+*/
+static bool8 VerifyKernels(void)
+{
+    render_view View = {
+        .ScreenToWorldScaleFactor = sAppState.ScreenToWorldScaleFactor,
+        .WorldLeft = BigFix_ToDouble(&sAppState.WorldLeft),
+        .WorldBottom = BigFix_ToDouble(&sAppState.WorldBottom),
+        .ExactWorldLeft = sAppState.WorldLeft,
+        .ExactWorldBottom = sAppState.WorldBottom,
+        .IterationCount = sAppState.IterationCount,
+        .Width = sFramebuffer.Width,
+        .Height = sFramebuffer.Height,
+        .SkipsInterior = sAppState.SkipsInterior,
+        .PeriodicityTolerance = sAppState.PeriodicityTolerance,
+    };
+    render_view HalfView = View;
+    HalfView.IterationCount /= 2;
+    render_view PannedView = View;
+    PannedView.PixelOffsetX = View.Width / 7;
+    PannedView.PixelOffsetY = -View.Height / 5;
+    iteration_buffer Expected = { 0 };
+    iteration_buffer ExpectedPanned = { 0 };
+    iteration_buffer Got = { 0 };
+    iteration_buffer GotOther = { 0 };
+    kernel_isa SelectedIsa = Kernel_GetIsa();
+    bool8 AllMatch = true;
+    for (render_precision Precision = 0; Precision <= RENDER_PRECISION_DOUBLE_DOUBLE; Precision++)
+    {
+        View.Precision = Precision;
+        HalfView.Precision = Precision;
+        PannedView.Precision = Precision;
+        Kernel_SetIsa(KERNEL_ISA_SCALAR);
+        Renderer_InvalidateBuffer(&Expected);
+        Renderer_RenderIterations(&Expected, &View);
+        Renderer_InvalidateBuffer(&ExpectedPanned);
+        Renderer_RenderIterations(&ExpectedPanned, &PannedView);
+        for (kernel_isa Isa = KERNEL_ISA_SCALAR; Isa <= Kernel_GetBestIsa(); Isa++)
+        {
+            Kernel_SetIsa(Isa);
+            size_t MismatchCount = 0;
+            if (Isa != KERNEL_ISA_SCALAR)
+            {
+                Renderer_InvalidateBuffer(&Got);
+                Renderer_RenderIterations(&Got, &View);
+                MismatchCount = CountMismatches(&Expected, &Got, &View);
+            }
+
+            Renderer_InvalidateBuffer(&Got);
+            Renderer_RenderIterations(&Got, &HalfView);
+            Renderer_RenderIterations(&Got, &View);
+            size_t ContinuedMismatchCount = CountMismatches(&Expected, &Got, &View);
+
+            Renderer_InvalidateBuffer(&Got);
+            Renderer_RenderIterations(&Got, &HalfView);
+            Renderer_RenderIterations(&Got, &PannedView);
+            size_t PannedMismatchCount = CountMismatches(&ExpectedPanned, &Got, &View);
+
+            /* one pixel in 8x8 first, then finer samples down to every pixel, panned on the way */
+            render_view Refinements[] = { HalfView, View, PannedView, PannedView };
+            Renderer_InvalidateBuffer(&Got);
+            for (int i = 0; i < (int)STATIC_ARRAY_SIZE(Refinements); i++)
+            {
+                Refinements[i].SampleShift = STATIC_ARRAY_SIZE(Refinements) - 1 - i;
+                Renderer_RenderIterations(&Got, &Refinements[i]);
+            }
+            size_t RefinedMismatchCount = CountMismatches(&ExpectedPanned, &Got, &View);
+
+            fprintf(stderr, "%s %s: %zu mismatches, %zu continued from %d iterations, %zu panned, %zu refined\n", 
+                Kernel_GetIsaName(Isa), 
+                Renderer_GetPrecisionName(Precision),
+                MismatchCount,
+                ContinuedMismatchCount,
+                HalfView.IterationCount,
+                PannedMismatchCount,
+                RefinedMismatchCount
+            );
+            AllMatch = AllMatch && MismatchCount == 0 && ContinuedMismatchCount == 0 && PannedMismatchCount == 0 
+                && RefinedMismatchCount == 0;
+        }
+
+        /* the interior check must not change the image either */
+        render_view FlippedView = View;
+        FlippedView.SkipsInterior = !View.SkipsInterior;
+        Kernel_SetIsa(KERNEL_ISA_SCALAR);
+        Renderer_InvalidateBuffer(&Got);
+        Renderer_RenderIterations(&Got, &FlippedView);
+        size_t InteriorMismatchCount = CountMismatches(&Expected, &Got, &View);
+        fprintf(stderr, "%s with the interior check %s: %zu mismatches\n", 
+            Renderer_GetPrecisionName(Precision),
+            FlippedView.SkipsInterior? "on" : "off",
+            InteriorMismatchCount
+        );
+        AllMatch = AllMatch && InteriorMismatchCount == 0;
+
+        /* 
+            Neither should the cycle check, but it is a heuristic: 
+            orbits that creep by less than its tolerance look like cycles, 
+            which happens where the tier barely resolves the pixels, so this only reports.
+        */
+        render_view OffView = View;
+        OffView.PeriodicityTolerance = 0;
+        render_view OnView = View;
+        OnView.PeriodicityTolerance = View.PeriodicityTolerance > 0? View.PeriodicityTolerance : 4.0f;
+        Renderer_InvalidateBuffer(&Got);
+        Renderer_RenderIterations(&Got, &OffView);
+        Renderer_InvalidateBuffer(&GotOther);
+        Renderer_RenderIterations(&GotOther, &OnView);
+        render_stats Stats = Renderer_GetStats();
+        size_t PeriodicityMismatchCount = CountMismatches(&Got, &GotOther, &View);
+        fprintf(stderr, "%s with the cycle check: %zu mismatches, %.1f%% of the pixels exited early\n", 
+            Renderer_GetPrecisionName(Precision),
+            PeriodicityMismatchCount,
+            100.0 * Stats.EarlyExitCount / MAX(Stats.PixelCount, 1)
+        );
+
+        /* Mariani-Silver guesses too, it is held against brute force the same ways as the kernels but only reported */
+        render_view GuessView = View;
+        GuessView.Method = RENDER_METHOD_MARIANI_SILVER;
+        render_view GuessHalfView = HalfView;
+        GuessHalfView.Method = RENDER_METHOD_MARIANI_SILVER;
+        render_view GuessPannedView = PannedView;
+        GuessPannedView.Method = RENDER_METHOD_MARIANI_SILVER;
+        Renderer_InvalidateBuffer(&Got);
+        Renderer_RenderIterations(&Got, &GuessView);
+        Stats = Renderer_GetStats();
+        size_t GuessMismatchCount = CountMismatches(&Expected, &Got, &View);
+        /* it only guesses from counts, so every ISA must still guess the same */
+        size_t GuessIsaMismatchCount = 0;
+        for (kernel_isa Isa = KERNEL_ISA_SSE2; Isa <= Kernel_GetBestIsa(); Isa++)
+        {
+            Kernel_SetIsa(Isa);
+            Renderer_InvalidateBuffer(&GotOther);
+            Renderer_RenderIterations(&GotOther, &GuessView);
+            GuessIsaMismatchCount += CountMismatches(&Got, &GotOther, &View);
+        }
+        Kernel_SetIsa(KERNEL_ISA_SCALAR);
+        Renderer_InvalidateBuffer(&Got);
+        Renderer_RenderIterations(&Got, &GuessHalfView);
+        Renderer_RenderIterations(&Got, &GuessView);
+        size_t GuessContinuedMismatchCount = CountMismatches(&Expected, &Got, &View);
+        Renderer_InvalidateBuffer(&Got);
+        Renderer_RenderIterations(&Got, &GuessHalfView);
+        Renderer_RenderIterations(&Got, &GuessPannedView);
+        size_t GuessPannedMismatchCount = CountMismatches(&ExpectedPanned, &Got, &View);
+        fprintf(stderr, "%s %s: %zu mismatches, %zu continued, %zu panned, iterated %.1f%% of the pixels, %zu between ISAs\n", 
+            Renderer_GetMethodName(GuessView.Method),
+            Renderer_GetPrecisionName(Precision),
+            GuessMismatchCount,
+            GuessContinuedMismatchCount,
+            GuessPannedMismatchCount,
+            100.0 * Stats.PixelCount / ((double)View.Width * View.Height),
+            GuessIsaMismatchCount
+        );
+        AllMatch = AllMatch && GuessIsaMismatchCount == 0;
+    }
+    Kernel_SetIsa(SelectedIsa);
+    Renderer_FreeBuffer(&Expected);
+    Renderer_FreeBuffer(&ExpectedPanned);
+    Renderer_FreeBuffer(&Got);
+    Renderer_FreeBuffer(&GotOther);
+    return AllMatch;
+}
+
+static size_t CountPixelMismatches(const u32 *A, const u32 *B, size_t PixelCount)
+{
+    size_t MismatchCount = 0;
+    for (size_t i = 0; i < PixelCount; i++)
+    {
+        MismatchCount += A[i] != B[i];
+    }
+    return MismatchCount;
+}
+
+/* mean absolute difference of every channel, in 255ths */
+static double GetColorError(const u32 *A, const u32 *B, size_t PixelCount)
+{
+    u64 Sum = 0;
+    for (size_t i = 0; i < PixelCount; i++)
+    {
+        for (int Shift = 0; Shift < 24; Shift += 8)
+        {
+            Sum += ABSI((int)(A[i] >> Shift & 0xFF) - (int)(B[i] >> Shift & 0xFF));
+        }
+    }
+    return (double)Sum / (3.0 * MAX(PixelCount, 1));
+}
+
+/* 
+    Every ISA must supersample the app's view the same, and taking it a sample per call must end up where one call does.
+    Reports how far it is from plain 16x supersampling, and at what share of its iterations, which double only pays for.
+    At half the framebuffer's size, up to 16 samples a pixel take long enough as it is.
+*/
+static bool8 VerifySupersampling(void)
+{
+    render_view View = {
+        .ScreenToWorldScaleFactor = 2.0 * sAppState.ScreenToWorldScaleFactor,
+        .WorldLeft = BigFix_ToDouble(&sAppState.WorldLeft),
+        .WorldBottom = BigFix_ToDouble(&sAppState.WorldBottom),
+        .ExactWorldLeft = sAppState.WorldLeft,
+        .ExactWorldBottom = sAppState.WorldBottom,
+        .IterationCount = sAppState.IterationCount,
+        .Width = sFramebuffer.Width / 2,
+        .Height = sFramebuffer.Height / 2,
+        .SkipsInterior = sAppState.SkipsInterior,
+        .PeriodicityTolerance = sAppState.PeriodicityTolerance,
+    };
+    const float *Palette = sAppState.ColorPalette;
+    int PaletteSize = sAppState.ColorPaletteCount/3;
+    int Threshold = sAppState.SupersampleThreshold;
+    size_t PixelCount = (size_t)View.Width * View.Height;
+    u32 *Expected = malloc(PixelCount * sizeof(u32));
+    u32 *Got = malloc(PixelCount * sizeof(u32));
+    if (!Expected || !Got)
+    {
+        fprintf(stderr, "Unable to allocate a %dx%d image.\n", View.Width, View.Height);
+        exit(1);
+    }
+    iteration_buffer Counts = { 0 };
+    supersample_buffer Buffer = { 0 };
+    kernel_isa SelectedIsa = Kernel_GetIsa();
+    bool8 AllMatch = true;
+    for (render_precision Precision = 0; Precision < RENDER_PRECISION_COUNT; Precision++)
+    {
+        View.Precision = Precision;
+        Kernel_SetIsa(KERNEL_ISA_SCALAR);
+        Renderer_InvalidateBuffer(&Counts);
+        Renderer_RenderIterations(&Counts, &View);
+        Buffer.IsValid = false;
+        Renderer_Supersample(&Buffer, Counts.Iterations, &View, Threshold, Palette, PaletteSize, Expected, INFINITY);
+        render_stats Stats = Renderer_GetStats();
+
+        /* perturbation has no ISAs of its own */
+        size_t IsaMismatchCount = 0;
+        for (kernel_isa Isa = KERNEL_ISA_SSE2; Isa <= Kernel_GetBestIsa() && Precision != RENDER_PRECISION_PERTURBATION; Isa++)
+        {
+            Kernel_SetIsa(Isa);
+            Buffer.IsValid = false;
+            Renderer_Supersample(&Buffer, Counts.Iterations, &View, Threshold, Palette, PaletteSize, Got, INFINITY);
+            IsaMismatchCount += CountPixelMismatches(Expected, Got, PixelCount);
+        }
+
+        Kernel_SetIsa(KERNEL_ISA_SCALAR);
+        Buffer.IsValid = false;
+        int CallCount = 1;
+        while (!Renderer_Supersample(&Buffer, Counts.Iterations, &View, Threshold, Palette, PaletteSize, Got, 0))
+        {
+            CallCount++;
+        }
+        size_t SlicedMismatchCount = CountPixelMismatches(Expected, Got, PixelCount);
+        fprintf(stderr, "%s supersampled: %zu mismatches between ISAs, %zu over %d calls, %.2f samples per pixel\n", 
+            Renderer_GetPrecisionName(Precision),
+            IsaMismatchCount,
+            SlicedMismatchCount,
+            CallCount,
+            1.0 + (double)Stats.PixelCount / PixelCount
+        );
+        AllMatch = AllMatch && IsaMismatchCount == 0 && SlicedMismatchCount == 0;
+
+        if (Precision == RENDER_PRECISION_DOUBLE)
+        {
+            Buffer.IsValid = false;
+            Renderer_Supersample(&Buffer, Counts.Iterations, &View, -1, Palette, PaletteSize, Got, INFINITY);
+            render_stats PlainStats = Renderer_GetStats();
+            double Error = GetColorError(Expected, Got, PixelCount);
+            Renderer_ColorIterations(Counts.Iterations, &View, Palette, PaletteSize, Expected);
+            fprintf(stderr, "against 16x supersampling: %.1f%% of its iterations, off by %.2f/255 per channel, %.2f/255 without any\n", 
+                100.0 * Stats.IterationCount / MAX(PlainStats.IterationCount, 1),
+                Error,
+                GetColorError(Expected, Got, PixelCount)
+            );
+        }
+    }
+    Kernel_SetIsa(SelectedIsa);
+    Renderer_FreeBuffer(&Counts);
+    Renderer_FreeSupersampleBuffer(&Buffer);
+    free(Expected);
+    free(Got);
+    return AllMatch;
+}
+
+/* bottom left corner of a Width*Height view centered on (CenterX, CenterY) with Scale world units per pixel */
+static bool8 GetViewCorner(bigfix *Left, bigfix *Bottom, const char *CenterX, const char *CenterY, int Width, int Height, double Scale)
+{
+    if (!BigFix_FromString(Left, CenterX) || !BigFix_FromString(Bottom, CenterY) || !(Scale > 0))
+        return false;
+
+    BigFix_AddDouble(Left, -0.5 * Width * Scale);
+    BigFix_AddDouble(Bottom, -0.5 * Height * Scale);
+    return true;
+}
+
+/* centers the app's view on (CenterX, CenterY) */
+static bool8 SetAppView(const char *CenterX, const char *CenterY, double Scale)
+{
+    bigfix Left, Bottom;
+    if (!GetViewCorner(&Left, &Bottom, CenterX, CenterY, sFramebuffer.Width, sFramebuffer.Height, Scale))
+        return false;
+
+    sAppState.WorldLeft = Left;
+    sAppState.WorldBottom = Bottom;
+    sAppState.WorldWidth = sFramebuffer.Width * Scale;
+    sAppState.WorldHeight = sFramebuffer.Height * Scale;
+    sAppState.ScreenToWorldScaleFactor = Scale;
+    sAppState.ZoomBaseScale = Scale;
+    sAppState.ZoomLevel = 0;
+    return true;
+}
+
+/* 
+    What a user looking around does, one event a frame: zooms in on the center and back out, 
+    drags the view away and back. Every lap ends where it started.
+*/
+static void SendTourEvent(int Frame)
+{
+    enum { ZOOM_STEPS = 8, DRAG_STEPS = 12, DRAG_STEP_PIXELS = 40, LAP = 2*ZOOM_STEPS + 2*DRAG_STEPS };
+    int Step = Frame % LAP;
+    int CenterX = sFramebuffer.Width / 2, CenterY = sFramebuffer.Height / 2;
+    if (Step < 2*ZOOM_STEPS)
+    {
+        mouse_data Move = { .Event = MOUSE_MOVE, .Status.Move = { .X = CenterX, .Y = CenterY } };
+        mouse_data Wheel = { .Event = MOUSE_WHEEL, .Status.Wheel.ScrollTowardUser = Step >= ZOOM_STEPS };
+        App_OnMouseEvent(&sAppState, &Move);
+        App_OnMouseEvent(&sAppState, &Wheel);
+        return;
+    }
+
+    Step -= 2*ZOOM_STEPS;
+    int Dx = Step < DRAG_STEPS? DRAG_STEP_PIXELS : -DRAG_STEP_PIXELS;
+    mouse_data Drag = { 
+        .Event = MOUSE_MOVE, 
+        .Status.Move = { .X = sAppState.MouseX + Dx, .Y = CenterY, .IsLeftClicking = true },
+    };
+    App_OnMouseEvent(&sAppState, &Drag);
+}
+
+typedef struct bench_view
+{
+    const char *Name;
+    const char *CenterX, *CenterY; /* like -x and -y */
+    double Scale; /* world units per pixel */
+    int Width, Height;
+    int IterationCount;
+    render_precision MinPrecision, MaxPrecision; /* benchmarked at every tier in between */
+    bool8 SkipsInterior;
+    float PeriodicityTolerance;
+} bench_view;
+
+/* 
+    Results only compare between builds as long as these stay the same, 
+    change a view by adding one under a new name.
+*/
+static const bench_view sBenchViews[] = {
+    {
+        .Name = "full-set", .CenterX = "-0.75", .CenterY = "0", .Scale = 3.125e-3, 
+        .Width = 1280, .Height = 720, .IterationCount = 1024,
+        .MinPrecision = RENDER_PRECISION_FLOAT, .MaxPrecision = RENDER_PRECISION_DOUBLE,
+        .SkipsInterior = true, .PeriodicityTolerance = 4.0f,
+    },
+    {
+        .Name = "seahorse-valley", .CenterX = "-0.7463", .CenterY = "0.1102", .Scale = 4e-6, 
+        .Width = 1280, .Height = 720, .IterationCount = 1024,
+        .MinPrecision = RENDER_PRECISION_FLOAT, .MaxPrecision = RENDER_PRECISION_DOUBLE,
+        .SkipsInterior = true, .PeriodicityTolerance = 4.0f,
+    },
+    {
+        .Name = "elephant-valley", .CenterX = "0.2822", .CenterY = "0.01", .Scale = 1.5e-5, 
+        .Width = 1280, .Height = 720, .IterationCount = 1024,
+        .MinPrecision = RENDER_PRECISION_FLOAT, .MaxPrecision = RENDER_PRECISION_DOUBLE,
+        .SkipsInterior = true, .PeriodicityTolerance = 4.0f,
+    },
+    /* period 16, about 3e-18 across, past what double resolves */
+    {
+        .Name = "deep-minibrot", .CenterX = "-1.99999999655308045362110874015473483139206276235932946992", .CenterY = "0", .Scale = 2e-20, 
+        .Width = 640, .Height = 360, .IterationCount = 2048,
+        .MinPrecision = RENDER_PRECISION_DOUBLE_DOUBLE, .MaxPrecision = RENDER_PRECISION_PERTURBATION,
+        .SkipsInterior = true, .PeriodicityTolerance = 4.0f,
+    },
+    /* inside the main cardioid, every pixel runs to the iteration count without the checks that would skip it */
+    {
+        .Name = "all-interior", .CenterX = "-0.1", .CenterY = "0.1", .Scale = 1e-4, 
+        .Width = 640, .Height = 360, .IterationCount = 1024,
+        .MinPrecision = RENDER_PRECISION_FLOAT, .MaxPrecision = RENDER_PRECISION_DOUBLE,
+        .SkipsInterior = false, .PeriodicityTolerance = 0,
+    },
+};
+
+static int CompareDoubles(const void *A, const void *B)
+{
+    double a = *(const double *)A, b = *(const double *)B;
+    return (a > b) - (a < b);
+}
+
+/* nearest rank, Sorted has Count > 0 values */
+static double GetPercentile(const double *Sorted, int Count, int Percent)
+{
+    int Rank = (Percent * Count + 99) / 100;
+    return Sorted[MIN(MAX(Rank, 1), Count) - 1];
+}
+
+/* the ISA that really runs, Kernel_GetRowFunction() falls back to lower ones */
+static kernel_isa GetEffectiveIsa(kernel_isa Isa, render_precision Precision)
+{
+    while (Isa > KERNEL_ISA_SCALAR && Kernel_GetRowFunction(Isa, Precision) == Kernel_GetRowFunction(Isa - 1, Precision))
+        Isa--;
+    return Isa;
+}
+
+/* 
+    Renders every view of sBenchViews from scratch RepeatCount times, at each of its tiers, with every ISA 
+    (or only Isa when it isn't -1) and 1, 2, 4... up to MaxThreadCount threads, and writes the times as JSON.
+    The first render of each is left out, it allocates the buffer and computes the reference orbit of perturbation.
+*/
+static bool8 RunBenchmark(const char *FileName, kernel_isa Isa, int MaxThreadCount, int RepeatCount, render_method Method)
+{
+    FILE *f = strcmp(FileName, "-") == 0? stdout : fopen(FileName, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    double StartS = GetTimeS();
+    double TimesMs[HEADLESS_MAX_REPEAT_COUNT];
+    iteration_buffer Buffer = { 0 };
+    kernel_isa SelectedIsa = Kernel_GetIsa();
+    fprintf(f, "{\n    \"compiler\": \"%s\",\n    \"best_isa\": \"%s\",\n    \"method\": \"%s\",\n    \"repeats\": %d,\n    \"results\": [",
+        __VERSION__,
+        Kernel_GetIsaName(Kernel_GetBestIsa()),
+        Renderer_GetMethodName(Method),
+        RepeatCount
+    );
+    const char *Separator = "\n";
+    for (int ThreadCount = 1; ; ThreadCount = MIN(2*ThreadCount, MaxThreadCount))
+    {
+        WorkQueue_StartThreads(ThreadCount);
+        for (size_t ViewIndex = 0; ViewIndex < STATIC_ARRAY_SIZE(sBenchViews); ViewIndex++)
+        {
+            const bench_view *BenchView = &sBenchViews[ViewIndex];
+            bigfix Left, Bottom;
+            GetViewCorner(&Left, &Bottom, BenchView->CenterX, BenchView->CenterY, BenchView->Width, BenchView->Height, BenchView->Scale);
+            render_view View = {
+                .ScreenToWorldScaleFactor = BenchView->Scale,
+                .WorldLeft = BigFix_ToDouble(&Left),
+                .WorldBottom = BigFix_ToDouble(&Bottom),
+                .ExactWorldLeft = Left,
+                .ExactWorldBottom = Bottom,
+                .IterationCount = BenchView->IterationCount,
+                .Width = BenchView->Width,
+                .Height = BenchView->Height,
+                .SkipsInterior = BenchView->SkipsInterior,
+                .PeriodicityTolerance = BenchView->PeriodicityTolerance,
+                .Method = Method,
+            };
+            for (View.Precision = BenchView->MinPrecision; View.Precision <= BenchView->MaxPrecision; View.Precision++)
+            {
+                kernel_isa FirstIsa = Isa == (kernel_isa)-1? KERNEL_ISA_SCALAR : Isa;
+                kernel_isa LastIsa = Isa == (kernel_isa)-1? Kernel_GetBestIsa() : Isa;
+                for (kernel_isa BenchIsa = FirstIsa; BenchIsa <= LastIsa; BenchIsa++)
+                {
+                    /* a fallback runs the same kernel as the ISA below */
+                    kernel_isa EffectiveIsa = GetEffectiveIsa(BenchIsa, View.Precision);
+                    if (EffectiveIsa != BenchIsa && Isa == (kernel_isa)-1)
+                        continue;
+
+                    Kernel_SetIsa(BenchIsa);
+                    Renderer_InvalidateBuffer(&Buffer);
+                    Renderer_RenderIterations(&Buffer, &View);
+                    double WallTimeMs = 0;
+                    for (int i = 0; i < RepeatCount; i++)
+                    {
+                        double RenderStartS = GetTimeS();
+                        Renderer_InvalidateBuffer(&Buffer);
+                        Renderer_RenderIterations(&Buffer, &View);
+                        TimesMs[i] = (GetTimeS() - RenderStartS) * 1000.0;
+                        WallTimeMs += TimesMs[i];
+                    }
+                    render_stats Stats = Renderer_GetStats();
+                    qsort(TimesMs, RepeatCount, sizeof(TimesMs[0]), CompareDoubles);
+
+                    double MedianMs = GetPercentile(TimesMs, RepeatCount, 50);
+                    double MpixPerS = (double)View.Width * View.Height / (MedianMs * 1000.0);
+                    double GiterPerS = Stats.IterationCount / (MedianMs * 1e6);
+                    fprintf(f, 
+                        "%s        {\"view\": \"%s\", \"precision\": \"%s\", \"isa\": \"%s\", \"threads\": %d, "
+                        "\"width\": %d, \"height\": %d, \"iteration_count\": %d, "
+                        "\"pixels_iterated\": %llu, \"iterations\": %llu, \"early_exits\": %llu, "
+                        "\"ms\": {\"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+                        "\"wall_ms\": %.3f, \"mpix_per_s\": %.3f, \"giter_per_s\": %.3f}",
+                        Separator,
+                        BenchView->Name,
+                        Renderer_GetPrecisionName(View.Precision),
+                        Kernel_GetIsaName(EffectiveIsa),
+                        ThreadCount,
+                        View.Width, View.Height, View.IterationCount,
+                        (unsigned long long)Stats.PixelCount,
+                        (unsigned long long)Stats.IterationCount,
+                        (unsigned long long)Stats.EarlyExitCount,
+                        TimesMs[0], MedianMs,
+                        GetPercentile(TimesMs, RepeatCount, 90),
+                        GetPercentile(TimesMs, RepeatCount, 99),
+                        TimesMs[RepeatCount - 1],
+                        WallTimeMs, MpixPerS, GiterPerS
+                    );
+                    Separator = ",\n";
+                    fprintf(stderr, "%s, %s, %s, %d threads: p50 %3.3fms, %3.3f Mpix/s, %3.3f Giter/s\n",
+                        BenchView->Name,
+                        Renderer_GetPrecisionName(View.Precision),
+                        Kernel_GetIsaName(EffectiveIsa),
+                        ThreadCount,
+                        MedianMs, MpixPerS, GiterPerS
+                    );
+                }
+            }
+        }
+        if (ThreadCount == MaxThreadCount)
+            break;
+    }
+    fprintf(f, "\n    ],\n    \"wall_s\": %.3f\n}\n", GetTimeS() - StartS);
+
+    Kernel_SetIsa(SelectedIsa);
+    Renderer_FreeBuffer(&Buffer);
+    bool8 Ok = !ferror(f);
+    if (f != stdout)
+        Ok = fclose(f) == 0 && Ok;
+    return Ok;
+}
+
+static void PrintUsage(const char *ProgramName)
+{
+    fprintf(stderr,
+        "usage: %s [-w width] [-h height] [-f frames] [-t threads] [-k isa] [-o output] [-x re -y im -s scale] [-l limbs] [-n iterations] [-i 0|1] [-p tolerance] [-m method] [-a 0|1] [-T trace] [-b rows | -P pyramid | -Z zoom | -F workers [-K tiles]] [-c MB] [-N] [-V | -B]\n"
+        "    -f: also the renders of every case with -B, defaults to 1, or 5 with -B\n"
+        "    -o: '.ppm', '.tif' and '.png' files are written as such, everything else as raw RGBA, '-' is stdout, defaults to frame.ppm, or stdout with -B\n"
+        "    -k: scalar, sse2, avx2 or avx512, defaults to the best one the CPU supports\n"
+        "    -x, -y, -s: center of the view (decimal, any number of digits) and world units per pixel\n"
+        "    -i: 0 iterates the main cardioid and period-2 bulb instead of skipping them\n"
+        "    -p: cycle check tolerance in epsilons of the precision tier, 0 iterates cycles up to the iteration count\n"
+        "    -m: brute-force or mariani-silver, which only iterates the borders of areas with one count\n"
+        "    -a: 0 leaves the frames aliased, 1 gives the pixels at the edges more samples once the view has every count\n"
+        "        -b, -P, -Z and -F are never antialiased, they color the center of every pixel\n"
+        "    -b: renders -w x -h in bands of this many rows straight to -o without holding the whole image, -s then defaults to the app's view\n"
+        "    -P: renders -w x -h as a pyramid of 256x256 PNG tiles, 'name.dzi' for Deep Zoom, any other path is a directory of XYZ 'z/x/y.png',\n"
+        "        -s as with -b, tiles already there are kept so that an interrupted run picks up where it stopped\n"
+        "    -Z: -f frames of -w x -h zooming this many times into the center, as Y4M at %d fps to -o, defaults to stdout and 300 frames,\n"
+        "        -s as with -b, every frame comes out of one render of the whole zoom\n"
+        "    -F: renders -w x -h to -o on this many worker processes, in tiles of %d handed out over Unix sockets, -s as with -b\n"
+        "    -K: the first -F workers die after this many tiles, to see their tiles go to the others\n"
+        "    -l: limbs of the bigfix products of the reference orbit (2 to %d), defaults to as many as the scale needs\n"
+        "    -c: memory budget of the tile cache of the CPU frames, defaults to %d\n"
+        "    -N: every frame zooms or drags along a fixed tour that keeps coming back to the view, to see the tile cache at work\n"
+        "    -T: the frames as a Chrome trace, for chrome://tracing\n"
+        "    -V: check that every kernel ISA gives the same counts as the scalar one, report how many the cycle check and mariani-silver change,\n"
+        "        check the bigfix products at every limb count, that every ISA supersamples the same and how close it gets to 16x\n"
+        "    -B: benchmark a fixed set of views at every tier they need, with every ISA (or -k) and 1, 2, 4... threads up to -t, as JSON\n",
+        ProgramName, HEADLESS_VIDEO_FRAME_RATE, HEADLESS_FARM_TILE_SIZE, BIGFIX_LIMB_COUNT, TILE_CACHE_DEFAULT_BUDGET_MB
+    );
+}
+
+int main(int argc, char **argv)
+{
+    int Width = 0, Height = 0;
+    int FrameCount = 0;
+    int ThreadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *OutputFileName = NULL;
+    bool8 ShouldVerify = false;
+    bool8 ShouldBenchmark = false;
+    kernel_isa Isa = -1;
+    const char *CenterX = NULL, *CenterY = NULL;
+    double Scale = 0;
+    int IterationCount = 0;
+    int SkipsInterior = -1;
+    float PeriodicityTolerance = -1;
+    int RenderMethod = -1;
+    int Supersamples = -1;
+    const char *TraceFileName = NULL;
+    int BandHeight = 0;
+    const char *PyramidPath = NULL;
+    double Zoom = 0;
+    int FarmWorkerCount = 0;
+    int CrashAfterTileCount = 0;
+    int TileCacheBudgetMB = -1;
+    int LimbCount = 0;
+    bool8 ShouldTour = false;
+    for (int i = 1; i < argc; i++)
+    {
+        const char *Arg = argv[i];
+        const char *Value = i + 1 < argc? argv[i + 1] : NULL;
+        if (strcmp(Arg, "-V") == 0)
+        {
+            ShouldVerify = true;
+            continue;
+        }
+        if (strcmp(Arg, "-B") == 0)
+        {
+            ShouldBenchmark = true;
+            continue;
+        }
+        if (strcmp(Arg, "-N") == 0)
+        {
+            ShouldTour = true;
+            continue;
+        }
+        if (!Value || Arg[0] != '-' || Arg[1] == '\0' || Arg[2] != '\0')
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+
+        switch (Arg[1])
+        {
+        case 'w': Width = atoi(Value); break;
+        case 'h': Height = atoi(Value); break;
+        case 'f': FrameCount = atoi(Value); break;
+        case 't': ThreadCount = atoi(Value); break;
+        case 'o': OutputFileName = Value; break;
+        case 'x': CenterX = Value; break;
+        case 'y': CenterY = Value; break;
+        case 's': Scale = strtod(Value, NULL); break;
+        case 'n': IterationCount = atoi(Value); break;
+        case 'i': SkipsInterior = atoi(Value) != 0; break;
+        case 'p': PeriodicityTolerance = strtod(Value, NULL); break;
+        case 'a': Supersamples = atoi(Value) != 0; break;
+        case 'T': TraceFileName = Value; break;
+        case 'b': BandHeight = atoi(Value); break;
+        case 'P': PyramidPath = Value; break;
+        case 'Z': Zoom = strtod(Value, NULL); break;
+        case 'F': FarmWorkerCount = atoi(Value); break;
+        case 'K': CrashAfterTileCount = atoi(Value); break;
+        case 'c': TileCacheBudgetMB = atoi(Value); break;
+        case 'l': LimbCount = atoi(Value); break;
+        case 'm':
+        {
+            RenderMethod = 0;
+            while (RenderMethod < RENDER_METHOD_COUNT && strcmp(Value, Renderer_GetMethodName(RenderMethod)) != 0)
+                RenderMethod++;
+            if (RenderMethod == RENDER_METHOD_COUNT)
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } break;
+        case 'k':
+        {
+            Isa = 0;
+            while (Isa < KERNEL_ISA_COUNT && strcmp(Value, Kernel_GetIsaName(Isa)) != 0)
+                Isa++;
+            if (Isa == KERNEL_ISA_COUNT)
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        } break;
+        default:
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        } break;
+        }
+        i++;
+    }
+    ThreadCount = MIN(MAX(ThreadCount, 1), WORK_QUEUE_MAX_THREAD_COUNT);
+    sShowsProgress = isatty(STDERR_FILENO);
+    if (Isa != (kernel_isa)-1)
+    {
+        Kernel_SetIsa(Isa);
+    }
+    if (LimbCount)
+    {
+        BigFix_SetLimbCount(MIN(MAX(LimbCount, BIGFIX_MIN_LIMB_COUNT), BIGFIX_LIMB_COUNT));
+    }
+    if (ShouldBenchmark)
+    {
+        OutputFileName = OutputFileName? OutputFileName : "-";
+        int RepeatCount = FrameCount > 0? MIN(FrameCount, HEADLESS_MAX_REPEAT_COUNT) : 5;
+        if (!RunBenchmark(OutputFileName, Isa, ThreadCount, RepeatCount, RenderMethod != -1? RenderMethod : RENDER_METHOD_BRUTE_FORCE))
+        {
+            fprintf(stderr, "Unable to write '%s'\n", OutputFileName);
+            return 1;
+        }
+        return 0;
+    }
+    int VideoFrameCount = FrameCount > 0? FrameCount : 10*HEADLESS_VIDEO_FRAME_RATE;
+    FrameCount = MAX(FrameCount, 1);
+    OutputFileName = OutputFileName? OutputFileName : Zoom > 0? "-" : "frame.ppm";
+    WorkQueue_StartThreads(ThreadCount);
+
+    /* an export never has the whole image in the framebuffer */
+    if (Width > 0 && Height > 0 && BandHeight <= 0 && !PyramidPath && !(Zoom > 0) && FarmWorkerCount <= 0)
+    {
+        ResizeFramebuffer(Width, Height);
+        sFramebufferSizeIsFixed = true;
+    }
+    else
+    {
+        ResizeFramebuffer(1080, 720);
+    }
+
+
+    sStartTimeS = GetTimeS();
+    sAppState = App_OnEntry();
+    if ((CenterX || CenterY || Scale) 
+    && !SetAppView(CenterX? CenterX : "0", CenterY? CenterY : "0", Scale? Scale : sAppState.ScreenToWorldScaleFactor))
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    if (IterationCount > 0)
+    {
+        sAppState.IterationCount = IterationCount;
+    }
+    if (SkipsInterior != -1)
+    {
+        sAppState.SkipsInterior = SkipsInterior;
+    }
+    if (PeriodicityTolerance >= 0)
+    {
+        sAppState.PeriodicityTolerance = PeriodicityTolerance;
+    }
+    if (RenderMethod != -1)
+    {
+        sAppState.RenderMethod = RenderMethod;
+    }
+    if (Supersamples != -1)
+    {
+        sAppState.Supersamples = Supersamples;
+    }
+    if (TileCacheBudgetMB >= 0)
+    {
+        TileCache_SetBudget(&sAppState.TileCache, (size_t)TileCacheBudgetMB * MB);
+    }
+    if (ShouldVerify)
+    {
+        bool8 BigFixOk = VerifyBigFix();
+        bool8 KernelsOk = VerifyKernels();
+        return VerifySupersampling() && KernelsOk && BigFixOk? 0 : 1;
+    }
+    if (PyramidPath)
+    {
+        if (Width <= 0 || Height <= 0)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        if (!WritePyramid(PyramidPath, Width, Height, Scale))
+        {
+            fprintf(stderr, "Unable to write '%s'\n", PyramidPath);
+            return 1;
+        }
+        return 0;
+    }
+    if (FarmWorkerCount > 0)
+    {
+        if (Width <= 0 || Height <= 0)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        if (!RunRenderFarm(OutputFileName, Width, Height, FarmWorkerCount, CrashAfterTileCount, Scale))
+        {
+            fprintf(stderr, "Unable to write '%s'\n", OutputFileName);
+            return 1;
+        }
+        return 0;
+    }
+    if (Zoom > 0)
+    {
+        if (Width <= 0 || Height <= 0)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        if (!WriteZoomVideo(OutputFileName, Width, Height, VideoFrameCount, Zoom, Scale))
+        {
+            fprintf(stderr, "Unable to write '%s'\n", OutputFileName);
+            return 1;
+        }
+        return 0;
+    }
+    if (BandHeight > 0)
+    {
+        if (Width <= 0 || Height <= 0)
+        {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        if (!ExportImage(OutputFileName, Width, Height, BandHeight, Scale))
+        {
+            fprintf(stderr, "Unable to write '%s'\n", OutputFileName);
+            return 1;
+        }
+        return 0;
+    }
+
+    double TotalFrameTimeMs = 0;
+    for (int i = 0; i < FrameCount; i++)
+    {
+        double FrameStart = GetTimeS();
+        /* the first frame is the view as it is */
+        if (ShouldTour && i > 0)
+        {
+            Profiler_SetPhase(PROFILER_PHASE_INPUT, Platform_GetElapsedTimeMs());
+            SendTourEvent(i - 1);
+        }
+        Profiler_SetPhase(PROFILER_PHASE_UPDATE, Platform_GetElapsedTimeMs());
+        App_OnLoop(&sAppState);
+        sFrameTimeMs = (GetTimeS() - FrameStart) * 1000.0;
+        TotalFrameTimeMs += sFrameTimeMs;
+
+        double FrameTimeLeftS = sFrameTimeTargetS - sFrameTimeMs*0.001;
+        if (FrameTimeLeftS > 0)
+        {
+            Profiler_SetPhase(PROFILER_PHASE_IDLE, Platform_GetElapsedTimeMs());
+            usleep(FrameTimeLeftS * 1000000.0);
+        }
+        Profiler_EndFrame(Platform_GetElapsedTimeMs());
+    }
+    /* the last frame may have been one slice of the counts, the image has all of them */
+    while (!App_IsIdle(&sAppState))
+    {
+        App_OnLoop(&sAppState);
+    }
+
+    u64 TileHitCount = sAppState.TileCache.HitCount;
+    u64 TileMissCount = sAppState.TileCache.MissCount;
+    App_OnExit(&sAppState);
+
+    double AvgFrameTimeMs = TotalFrameTimeMs / MAX(FrameCount, 1);
+    double PixelCount = (double)sFramebuffer.Width * sFramebuffer.Height;
+    const render_stats *Stats = &sAppState.RenderStats;
+    frame_time_stats Frames = Profiler_GetStats();
+    fprintf(stderr, "%dx%d, %d frames, %d threads, %s, %s, tier: %s %3.3fns/iter, early exits: %2.1f%%, t_frame: %3.3fms, p50|p95|p99: %3.3f|%3.3f|%3.3f, tiles hit|miss: %llu|%llu, %3.3f Mpix/s\n",
+        sFramebuffer.Width, sFramebuffer.Height,
+        FrameCount,
+        Platform_GetThreadCount(),
+        Kernel_GetIsaName(Kernel_GetIsa()),
+        Renderer_GetMethodName(sAppState.RenderMethod),
+        Renderer_GetPrecisionName(Stats->Precision),
+        Stats->NsPerIteration,
+        Stats->PixelCount? 100.0 * Stats->EarlyExitCount / Stats->PixelCount : 0.0,
+        AvgFrameTimeMs,
+        Frames.Busy.P50, Frames.Busy.P95, Frames.Busy.P99,
+        (unsigned long long)TileHitCount, (unsigned long long)TileMissCount,
+        PixelCount / (AvgFrameTimeMs * 1000.0)
+    );
+
+    if (TraceFileName && !Profiler_WriteTrace(TraceFileName))
+    {
+        fprintf(stderr, "Unable to write '%s'\n", TraceFileName);
+        return 1;
+    }
+
+    if (!WriteFramebuffer(OutputFileName))
+    {
+        fprintf(stderr, "Unable to write '%s'\n", OutputFileName);
+        return 1;
+    }
+    return 0;
+}
+
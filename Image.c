@@ -0,0 +1,576 @@
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "Platform.h"
+#include "Image.h"
+
+
+/* a run of rows of one band, filtered and deflated on its own */
+struct image_deflate_chunk
+{
+    const u32 *Rows;
+    const u32 *RowAbove; /* NULL for the top row of the image */
+    int RowCount, Width;
+    bool8 IsLast; /* of the image, ends the zlib stream */
+    u8 *Filtered; /* a filter type byte and the filtered RGB of every row */
+    size_t FilteredCapacity;
+    u8 *Deflated;
+    size_t DeflatedSize, DeflatedCapacity;
+    u32 Adler;
+};
+
+
+image_format Image_GetFormat(const char *FileName)
+{
+    static const struct {
+        const char *Extension;
+        image_format Format;
+    } Extensions[] = {
+        { ".ppm", IMAGE_FORMAT_PPM },
+        { ".tif", IMAGE_FORMAT_TIFF },
+        { ".tiff", IMAGE_FORMAT_TIFF },
+        { ".png", IMAGE_FORMAT_PNG },
+    };
+    size_t NameLen = strlen(FileName);
+    for (size_t i = 0; i < STATIC_ARRAY_SIZE(Extensions); i++)
+    {
+        size_t ExtensionLen = strlen(Extensions[i].Extension);
+        if (NameLen >= ExtensionLen && strcmp(FileName + NameLen - ExtensionLen, Extensions[i].Extension) == 0)
+            return Extensions[i].Format;
+    }
+    return IMAGE_FORMAT_RAW;
+}
+
+
+static void Image_Write(image_writer *Writer, const void *Data, size_t Size)
+{
+    Writer->Ok = Writer->Ok && Size == fwrite(Data, 1, Size, Writer->File);
+}
+
+static u8 *Image_PutLittleEndian(u8 *Cursor, u64 Value, int ByteCount)
+{
+    for (int i = 0; i < ByteCount; i++)
+        *Cursor++ = Value >> 8*i;
+    return Cursor;
+}
+
+static u8 *Image_PutBigEndian(u8 *Cursor, u64 Value, int ByteCount)
+{
+    for (int i = ByteCount - 1; i >= 0; i--)
+        *Cursor++ = Value >> 8*i;
+    return Cursor;
+}
+
+static void Image_ToRgb(u8 *Rgb, const u32 *Row, int Width)
+{
+    for (int x = 0; x < Width; x++)
+    {
+        u32 Pixel = Row[x];
+        Rgb[3*x + 0] = Pixel;
+        Rgb[3*x + 1] = Pixel >> 8;
+        Rgb[3*x + 2] = Pixel >> 16;
+    }
+}
+
+
+
+/* TIFF */
+
+typedef enum
+{
+    TIFF_TYPE_SHORT = 3,
+    TIFF_TYPE_LONG = 4,
+    TIFF_TYPE_RATIONAL = 5,
+    TIFF_TYPE_LONG8 = 16, /* BigTIFF */
+} tiff_type;
+
+typedef struct tiff_layout
+{
+    bool8 IsBig;
+    u8 *Entry; /* next IFD entry */
+    u8 *Extra; /* next value too big for its entry */
+    u64 ExtraOffset; /* of Extra in the file */
+} tiff_layout;
+
+/* Values are LONGs for RATIONAL, 2 of them per rational */
+static void Image_PutTiffEntry(tiff_layout *Layout, u16 Tag, tiff_type Type, u64 Count, const u64 *Values)
+{
+    int ValueSize = Type == TIFF_TYPE_SHORT? 2 : Type == TIFF_TYPE_LONG8? 8 : 4;
+    u64 ValueCount = Type == TIFF_TYPE_RATIONAL? 2*Count : Count;
+    int InlineSize = Layout->IsBig? 8 : 4;
+
+    u8 *Entry = Layout->Entry;
+    Entry = Image_PutLittleEndian(Entry, Tag, 2);
+    Entry = Image_PutLittleEndian(Entry, Type, 2);
+    Entry = Image_PutLittleEndian(Entry, Count, Layout->IsBig? 8 : 4);
+    u8 *Values8 = Entry;
+    if (ValueCount * ValueSize > (u64)InlineSize)
+    {
+        Entry = Image_PutLittleEndian(Entry, Layout->ExtraOffset, InlineSize);
+        Values8 = Layout->Extra;
+        Layout->Extra += ValueCount * ValueSize;
+        Layout->ExtraOffset += ValueCount * ValueSize;
+    }
+    else
+    {
+        memset(Entry, 0, InlineSize);
+        Entry += InlineSize;
+    }
+    for (u64 i = 0; i < ValueCount; i++)
+    {
+        Values8 = Image_PutLittleEndian(Values8, Values[i], ValueSize);
+    }
+    Layout->Entry = Entry;
+}
+
+/*
+    Header, one IFD, the values that don't fit in it, then the pixels in strips of IMAGE_TIFF_ROWS_PER_STRIP rows,
+    every offset is known up front since nothing is compressed.
+*/
+static void Image_WriteTiffHeader(image_writer *Writer)
+{
+    enum { TAG_COUNT = 12 };
+    u64 RowSize = (u64)Writer->Width * 3;
+    u64 StripCount = (Writer->Height + IMAGE_TIFF_ROWS_PER_STRIP - 1) / IMAGE_TIFF_ROWS_PER_STRIP;
+    u64 StripSize = RowSize * IMAGE_TIFF_ROWS_PER_STRIP;
+
+    /* everything but the pixels is small, a classic TIFF fits when the pixels end before 4 GB with room to spare */
+    u64 ClassicExtraSize = 6 + 8 + 8 + (StripCount > 1? 2*4*StripCount : 0);
+    u64 ClassicHeaderSize = 8 + 2 + TAG_COUNT*12 + 4 + ClassicExtraSize;
+    bool8 IsBig = ClassicHeaderSize + RowSize * Writer->Height > UINT32_MAX;
+    u64 IfdOffset = IsBig? 16 : 8;
+    u64 IfdSize = IsBig? 8 + TAG_COUNT*20 + 8 : 2 + TAG_COUNT*12 + 4;
+    u64 ExtraSize = IsBig? (StripCount > 1? 2*8*StripCount : 0) : ClassicExtraSize;
+    u64 DataOffset = IfdOffset + IfdSize + ExtraSize;
+
+    u8 *Header = malloc(DataOffset);
+    u64 *StripOffsets = malloc(StripCount * sizeof(u64));
+    u64 *StripByteCounts = malloc(StripCount * sizeof(u64));
+    ASSERT(Header && StripOffsets && StripByteCounts, "Out of memory");
+    for (u64 i = 0; i < StripCount; i++)
+    {
+        u64 RowsLeft = Writer->Height - i*IMAGE_TIFF_ROWS_PER_STRIP;
+        StripOffsets[i] = DataOffset + i*StripSize;
+        StripByteCounts[i] = RowSize * MIN(RowsLeft, IMAGE_TIFF_ROWS_PER_STRIP);
+    }
+
+    u8 *Cursor = Header;
+    *Cursor++ = 'I';
+    *Cursor++ = 'I';
+    if (IsBig)
+    {
+        Cursor = Image_PutLittleEndian(Cursor, 43, 2);
+        Cursor = Image_PutLittleEndian(Cursor, 8, 2); /* offset size */
+        Cursor = Image_PutLittleEndian(Cursor, 0, 2);
+        Cursor = Image_PutLittleEndian(Cursor, IfdOffset, 8);
+        Cursor = Image_PutLittleEndian(Cursor, TAG_COUNT, 8);
+    }
+    else
+    {
+        Cursor = Image_PutLittleEndian(Cursor, 42, 2);
+        Cursor = Image_PutLittleEndian(Cursor, IfdOffset, 4);
+        Cursor = Image_PutLittleEndian(Cursor, TAG_COUNT, 2);
+    }
+
+    tiff_layout Layout = {
+        .IsBig = IsBig,
+        .Entry = Cursor,
+        .Extra = Header + IfdOffset + IfdSize,
+        .ExtraOffset = IfdOffset + IfdSize,
+    };
+    tiff_type OffsetType = IsBig? TIFF_TYPE_LONG8 : TIFF_TYPE_LONG;
+    u64 Width = Writer->Width, Height = Writer->Height;
+    u64 BitsPerSample[3] = { 8, 8, 8 };
+    u64 Resolution[2] = { 72, 1 };
+    u64 One = 1, Two = 2, Three = 3, RowsPerStrip = IMAGE_TIFF_ROWS_PER_STRIP;
+    /* in increasing tag order */
+    Image_PutTiffEntry(&Layout, 256, TIFF_TYPE_LONG, 1, &Width); /* ImageWidth */
+    Image_PutTiffEntry(&Layout, 257, TIFF_TYPE_LONG, 1, &Height); /* ImageLength */
+    Image_PutTiffEntry(&Layout, 258, TIFF_TYPE_SHORT, 3, BitsPerSample);
+    Image_PutTiffEntry(&Layout, 259, TIFF_TYPE_SHORT, 1, &One); /* Compression: none */
+    Image_PutTiffEntry(&Layout, 262, TIFF_TYPE_SHORT, 1, &Two); /* PhotometricInterpretation: RGB */
+    Image_PutTiffEntry(&Layout, 273, OffsetType, StripCount, StripOffsets);
+    Image_PutTiffEntry(&Layout, 277, TIFF_TYPE_SHORT, 1, &Three); /* SamplesPerPixel */
+    Image_PutTiffEntry(&Layout, 278, TIFF_TYPE_LONG, 1, &RowsPerStrip);
+    Image_PutTiffEntry(&Layout, 279, OffsetType, StripCount, StripByteCounts);
+    Image_PutTiffEntry(&Layout, 282, TIFF_TYPE_RATIONAL, 1, Resolution); /* XResolution */
+    Image_PutTiffEntry(&Layout, 283, TIFF_TYPE_RATIONAL, 1, Resolution); /* YResolution */
+    Image_PutTiffEntry(&Layout, 296, TIFF_TYPE_SHORT, 1, &Two); /* ResolutionUnit: inch */
+    /* no next IFD */
+    Image_PutLittleEndian(Layout.Entry, 0, IsBig? 8 : 4);
+    ASSERT(Layout.ExtraOffset == DataOffset, "TIFF header size is off");
+
+    Image_Write(Writer, Header, DataOffset);
+    free(Header);
+    free(StripOffsets);
+    free(StripByteCounts);
+}
+
+
+
+/* PNG */
+
+static void Image_WritePngChunk(image_writer *Writer, const char *Type, const u8 *Data, u32 Size)
+{
+    u8 Length[4];
+    Image_PutBigEndian(Length, Size, 4);
+    Image_Write(Writer, Length, 4);
+    Image_Write(Writer, Type, 4);
+    Image_Write(Writer, Data, Size);
+    /* crc32() of NULL is its initial value, not a continuation */
+    u32 Crc = crc32(0, (const u8 *)Type, 4);
+    if (Size > 0)
+        Crc = crc32(Crc, Data, Size);
+    u8 CrcBytes[4];
+    Image_PutBigEndian(CrcBytes, Crc, 4);
+    Image_Write(Writer, CrcBytes, 4);
+}
+
+static int Image_Paeth(int Left, int Above, int AboveLeft)
+{
+    int p = Left + Above - AboveLeft;
+    int pLeft = ABSI(p - Left), pAbove = ABSI(p - Above), pAboveLeft = ABSI(p - AboveLeft);
+    if (pLeft <= pAbove && pLeft <= pAboveLeft)
+        return Left;
+    return pAbove <= pAboveLeft? Above : AboveLeft;
+}
+
+/*
+    Each row gets the filter with the smallest sum of its bytes taken as signed, like libpng does.
+    Then the chunk is deflated as a raw stream of its own, flushed to a byte boundary so that
+    the chunks of every band can just be put one after the other, and only the last one of the image is final.
+*/
+static void Image_DeflateChunk(void *Data)
+{
+    image_deflate_chunk *Chunk = Data;
+    int LineSize = Chunk->Width * 3;
+    size_t FilteredSize = (size_t)Chunk->RowCount * (1 + LineSize);
+    u8 *Lines = malloc(2 * (size_t)LineSize);
+    u8 *Candidates = malloc(4 * (size_t)LineSize);
+    ASSERT(Lines && Candidates, "Out of memory");
+
+    u8 *Line = Lines, *Above = Lines + LineSize;
+    if (Chunk->RowAbove)
+        Image_ToRgb(Above, Chunk->RowAbove, Chunk->Width);
+    else
+        memset(Above, 0, LineSize);
+    u8 *Out = Chunk->Filtered;
+    for (int y = 0; y < Chunk->RowCount; y++)
+    {
+        Image_ToRgb(Line, Chunk->Rows + (size_t)y * Chunk->Width, Chunk->Width);
+        u32 Costs[4] = { 0 };
+        for (int i = 0; i < LineSize; i++)
+        {
+            int Left = i >= 3? Line[i - 3] : 0;
+            int AboveLeft = i >= 3? Above[i - 3] : 0;
+            u8 Filtered[4] = {
+                Line[i],
+                Line[i] - Left,
+                Line[i] - Above[i],
+                Line[i] - Image_Paeth(Left, Above[i], AboveLeft),
+            };
+            for (int Filter = 0; Filter < 4; Filter++)
+            {
+                Candidates[Filter*LineSize + i] = Filtered[Filter];
+                Costs[Filter] += ABSI((i8)Filtered[Filter]);
+            }
+        }
+        int Best = 0;
+        for (int Filter = 1; Filter < 4; Filter++)
+        {
+            if (Costs[Filter] < Costs[Best])
+                Best = Filter;
+        }
+        /* PNG numbers them none, sub, up, average, paeth */
+        *Out++ = Best == 3? 4 : Best;
+        memcpy(Out, Candidates + Best*LineSize, LineSize);
+        Out += LineSize;
+        SWAP(u8 *, Line, Above);
+    }
+    free(Lines);
+    free(Candidates);
+    Chunk->Adler = adler32(1, Chunk->Filtered, FilteredSize);
+
+    z_stream Stream = { 0 };
+    int Status = deflateInit2(&Stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+    ASSERT(Status == Z_OK, "Unable to start deflate");
+    /* room for the sync flush's empty stored block too */
+    size_t Bound = deflateBound(&Stream, FilteredSize) + 16;
+    if (Chunk->DeflatedCapacity < Bound)
+    {
+        free(Chunk->Deflated);
+        Chunk->Deflated = malloc(Bound);
+        Chunk->DeflatedCapacity = Bound;
+        ASSERT(Chunk->Deflated, "Out of memory");
+    }
+    Stream.next_in = Chunk->Filtered;
+    Stream.avail_in = FilteredSize;
+    Stream.next_out = Chunk->Deflated;
+    Stream.avail_out = Chunk->DeflatedCapacity;
+    Status = deflate(&Stream, Chunk->IsLast? Z_FINISH : Z_SYNC_FLUSH);
+    ASSERT(Stream.avail_in == 0 && (Chunk->IsLast? Status == Z_STREAM_END : Status == Z_OK), "Deflate ran out of room");
+    Chunk->DeflatedSize = Chunk->DeflatedCapacity - Stream.avail_out;
+    deflateEnd(&Stream);
+}
+
+static void Image_WritePngRows(image_writer *Writer, const u32 *Rows, int RowCount)
+{
+    /* a chunk for every thread, deflating less than a row at a time isn't worth it */
+    int ThreadCount = Writer->IsOnCallingThread? 1 : Platform_GetThreadCount();
+    int ChunkRowCount = (RowCount + ThreadCount - 1) / ThreadCount;
+    int ChunkCount = (RowCount + ChunkRowCount - 1) / ChunkRowCount;
+    if (Writer->ChunkCount < ChunkCount)
+    {
+        Writer->Chunks = realloc(Writer->Chunks, ChunkCount * sizeof(image_deflate_chunk));
+        ASSERT(Writer->Chunks, "Out of memory");
+        memset(Writer->Chunks + Writer->ChunkCount, 0, (ChunkCount - Writer->ChunkCount) * sizeof(image_deflate_chunk));
+        Writer->ChunkCount = ChunkCount;
+    }
+
+    for (int i = 0; i < ChunkCount; i++)
+    {
+        image_deflate_chunk *Chunk = &Writer->Chunks[i];
+        int FirstRow = i * ChunkRowCount;
+        Chunk->Rows = Rows + (size_t)FirstRow * Writer->Width;
+        Chunk->RowAbove = FirstRow > 0? Chunk->Rows - Writer->Width : Writer->RowCount > 0? Writer->LastRow : NULL;
+        Chunk->RowCount = MIN(ChunkRowCount, RowCount - FirstRow);
+        Chunk->Width = Writer->Width;
+        Chunk->IsLast = Writer->RowCount + FirstRow + Chunk->RowCount == Writer->Height;
+        size_t FilteredSize = (size_t)Chunk->RowCount * (1 + 3*(size_t)Writer->Width);
+        if (Chunk->FilteredCapacity < FilteredSize)
+        {
+            free(Chunk->Filtered);
+            Chunk->Filtered = malloc(FilteredSize);
+            Chunk->FilteredCapacity = FilteredSize;
+            ASSERT(Chunk->Filtered, "Out of memory");
+        }
+        if (Writer->IsOnCallingThread)
+        {
+            Image_DeflateChunk(Chunk);
+        }
+        else
+        {
+            Platform_PushWork(Image_DeflateChunk, Chunk);
+        }
+    }
+    if (!Writer->IsOnCallingThread)
+    {
+        Platform_CompleteAllWork();
+    }
+
+    /* one IDAT for the band, the zlib header goes before the first and the checksum after the last */
+    bool8 IsFirst = Writer->RowCount == 0;
+    bool8 IsLast = Writer->RowCount + RowCount == Writer->Height;
+    size_t Size = (IsFirst? 2 : 0) + (IsLast? 4 : 0);
+    for (int i = 0; i < ChunkCount; i++)
+    {
+        Size += Writer->Chunks[i].DeflatedSize;
+    }
+    ASSERT(Size <= INT32_MAX, "Band is too big for one IDAT");
+
+    u8 ZlibHeader[2] = { 0x78, 0x9C };
+    u8 Length[4];
+    Image_PutBigEndian(Length, Size, 4);
+    Image_Write(Writer, Length, 4);
+    Image_Write(Writer, "IDAT", 4);
+    u32 Crc = crc32(0, (const u8 *)"IDAT", 4);
+    if (IsFirst)
+    {
+        Image_Write(Writer, ZlibHeader, 2);
+        Crc = crc32(Crc, ZlibHeader, 2);
+    }
+    for (int i = 0; i < ChunkCount; i++)
+    {
+        image_deflate_chunk *Chunk = &Writer->Chunks[i];
+        size_t FilteredSize = (size_t)Chunk->RowCount * (1 + 3*(size_t)Writer->Width);
+        Image_Write(Writer, Chunk->Deflated, Chunk->DeflatedSize);
+        Crc = crc32(Crc, Chunk->Deflated, Chunk->DeflatedSize);
+        Writer->Adler = adler32_combine(Writer->Adler, Chunk->Adler, FilteredSize);
+    }
+    if (IsLast)
+    {
+        u8 Adler[4];
+        Image_PutBigEndian(Adler, Writer->Adler, 4);
+        Image_Write(Writer, Adler, 4);
+        Crc = crc32(Crc, Adler, 4);
+    }
+    u8 CrcBytes[4];
+    Image_PutBigEndian(CrcBytes, Crc, 4);
+    Image_Write(Writer, CrcBytes, 4);
+
+    memcpy(Writer->LastRow, Rows + (size_t)(RowCount - 1) * Writer->Width, Writer->Width * sizeof(u32));
+}
+
+
+
+bool8 Image_Begin(image_writer *Writer, FILE *File, image_format Format, int Width, int Height)
+{
+    *Writer = (image_writer) {
+        .File = File,
+        .Format = Format,
+        .Width = Width,
+        .Height = Height,
+        .Ok = Width > 0 && Height > 0,
+        .Adler = 1,
+    };
+    Writer->RowBytes = malloc(Width * sizeof(u32));
+    ASSERT(Writer->RowBytes, "Out of memory");
+    switch (Format)
+    {
+    case IMAGE_FORMAT_RAW: break;
+    case IMAGE_FORMAT_PPM:
+    {
+        Writer->Ok = Writer->Ok && fprintf(File, "P6\n%d %d\n255\n", Width, Height) > 0;
+    } break;
+    case IMAGE_FORMAT_TIFF:
+    {
+        Image_WriteTiffHeader(Writer);
+    } break;
+    case IMAGE_FORMAT_PNG:
+    {
+        Writer->LastRow = malloc(Width * sizeof(u32));
+        ASSERT(Writer->LastRow, "Out of memory");
+        Image_Write(Writer, "\x89PNG\r\n\x1A\n", 8);
+        u8 Header[13];
+        u8 *Cursor = Header;
+        Cursor = Image_PutBigEndian(Cursor, Width, 4);
+        Cursor = Image_PutBigEndian(Cursor, Height, 4);
+        *Cursor++ = 8; /* bits per sample */
+        *Cursor++ = 2; /* RGB */
+        *Cursor++ = 0; /* deflate */
+        *Cursor++ = 0; /* adaptive filtering */
+        *Cursor++ = 0; /* not interlaced */
+        Image_WritePngChunk(Writer, "IHDR", Header, sizeof Header);
+    } break;
+    case IMAGE_FORMAT_COUNT: UNREACHABLE(); break;
+    }
+    return Writer->Ok;
+}
+
+bool8 Image_WriteRows(image_writer *Writer, const u32 *Rows, int RowCount)
+{
+    RowCount = MIN(RowCount, Writer->Height - Writer->RowCount);
+    if (RowCount <= 0)
+        return Writer->Ok;
+
+    if (Writer->Format == IMAGE_FORMAT_PNG)
+    {
+        Image_WritePngRows(Writer, Rows, RowCount);
+    }
+    else if (Writer->Format == IMAGE_FORMAT_RAW)
+    {
+        Image_Write(Writer, Rows, (size_t)RowCount * Writer->Width * sizeof(u32));
+    }
+    else /* PPM and TIFF are both RGB, row after row */
+    {
+        for (int y = 0; y < RowCount; y++)
+        {
+            Image_ToRgb(Writer->RowBytes, Rows + (size_t)y * Writer->Width, Writer->Width);
+            Image_Write(Writer, Writer->RowBytes, (size_t)Writer->Width * 3);
+        }
+    }
+    Writer->RowCount += RowCount;
+    return Writer->Ok;
+}
+
+bool8 Image_End(image_writer *Writer)
+{
+    if (Writer->Format == IMAGE_FORMAT_PNG && Writer->RowCount == Writer->Height)
+    {
+        Image_WritePngChunk(Writer, "IEND", NULL, 0);
+    }
+    bool8 Ok = Writer->Ok && Writer->RowCount == Writer->Height && fflush(Writer->File) == 0;
+
+    for (int i = 0; i < Writer->ChunkCount; i++)
+    {
+        free(Writer->Chunks[i].Filtered);
+        free(Writer->Chunks[i].Deflated);
+    }
+    free(Writer->Chunks);
+    free(Writer->LastRow);
+    free(Writer->RowBytes);
+    *Writer = (image_writer) { 0 };
+    return Ok;
+}
+
+static u32 Image_GetBigEndian(const u8 *Bytes)
+{
+    return (u32)Bytes[0] << 24 | (u32)Bytes[1] << 16 | (u32)Bytes[2] << 8 | Bytes[3];
+}
+
+bool8 Image_ReadPng(FILE *File, u32 *Pixels, int Width, int Height)
+{
+    u8 Signature[8];
+    if (fread(Signature, 1, 8, File) != 8 || memcmp(Signature, "\x89PNG\r\n\x1A\n", 8) != 0)
+        return false;
+
+    int LineSize = Width * 3;
+    size_t FilteredSize = (size_t)Height * (1 + LineSize);
+    u8 *Filtered = malloc(FilteredSize);
+    u8 *Data = NULL;
+    ASSERT(Filtered, "Out of memory");
+    z_stream Stream = { 0 };
+    bool8 Ok = inflateInit(&Stream) == Z_OK;
+    Stream.next_out = Filtered;
+    Stream.avail_out = FilteredSize;
+    bool8 HasHeader = false, HasEnd = false;
+    while (Ok && !HasEnd)
+    {
+        u8 ChunkHeader[8];
+        Ok = fread(ChunkHeader, 1, 8, File) == 8;
+        u32 Size = Ok? Image_GetBigEndian(ChunkHeader) : 0;
+        Ok = Ok && Size <= INT32_MAX;
+        /* the CRC is left to inflate's Adler-32, a tile that got cut short fails either way */
+        Data = Ok? realloc(Data, (size_t)Size + 4) : Data;
+        Ok = Ok && Data && fread(Data, 1, (size_t)Size + 4, File) == (size_t)Size + 4;
+        if (!Ok)
+            break;
+
+        if (memcmp(ChunkHeader + 4, "IHDR", 4) == 0)
+        {
+            /* only what Image_Begin() writes: 8-bit RGB, not interlaced */
+            HasHeader = Size == 13 
+                && Image_GetBigEndian(Data) == (u32)Width && Image_GetBigEndian(Data + 4) == (u32)Height
+                && Data[8] == 8 && Data[9] == 2 && Data[12] == 0;
+            Ok = HasHeader;
+        }
+        else if (memcmp(ChunkHeader + 4, "IDAT", 4) == 0)
+        {
+            Stream.next_in = Data;
+            Stream.avail_in = Size;
+            int Status = inflate(&Stream, Z_NO_FLUSH);
+            Ok = HasHeader && (Status == Z_OK || Status == Z_STREAM_END || (Status == Z_BUF_ERROR && Size == 0));
+        }
+        else if (memcmp(ChunkHeader + 4, "IEND", 4) == 0)
+        {
+            HasEnd = true;
+        }
+    }
+    Ok = Ok && Stream.avail_out == 0 && inflate(&Stream, Z_FINISH) == Z_STREAM_END;
+    inflateEnd(&Stream);
+    free(Data);
+
+    for (int y = 0; Ok && y < Height; y++)
+    {
+        u8 Filter = Filtered[(size_t)y * (1 + LineSize)];
+        u8 *Line = Filtered + (size_t)y * (1 + LineSize) + 1;
+        const u8 *Above = y > 0? Line - (1 + LineSize) : NULL;
+        Ok = Filter <= 4;
+        for (int i = 0; Ok && i < LineSize; i++)
+        {
+            int Left = i >= 3? Line[i - 3] : 0;
+            int Up = Above? Above[i] : 0;
+            int AboveLeft = Above && i >= 3? Above[i - 3] : 0;
+            int Predicted[5] = { 0, Left, Up, (Left + Up) / 2, Image_Paeth(Left, Up, AboveLeft) };
+            Line[i] += Predicted[Filter];
+        }
+        u32 *Row = Pixels + (size_t)y * Width;
+        for (int x = 0; Ok && x < Width; x++)
+        {
+            const u8 *Rgb = Line + 3*x;
+            Row[x] = Rgb[0] | Rgb[1] << 8 | Rgb[2] << 16 | (u32)0xFF << 24;
+        }
+    }
+    free(Filtered);
+    return Ok;
+}
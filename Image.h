@@ -0,0 +1,55 @@
+#ifndef IMAGE_H
+#define IMAGE_H
+
+#include <stdio.h>
+#include "Common.h"
+
+/* the offsets of every strip go in the header, ahead of the pixels */
+#define IMAGE_TIFF_ROWS_PER_STRIP 64
+
+
+typedef enum
+{
+    IMAGE_FORMAT_RAW, /* RGBA, no header */
+    IMAGE_FORMAT_PPM,
+    IMAGE_FORMAT_TIFF, /* uncompressed, BigTIFF past 4 GB */
+    IMAGE_FORMAT_PNG, /* deflated band by band on every thread */
+    IMAGE_FORMAT_COUNT,
+} image_format;
+
+typedef struct image_deflate_chunk image_deflate_chunk;
+
+/*
+    Writes an image a band of rows at a time, top row first,
+    so that only the band has to be in memory and never the whole image.
+*/
+typedef struct image_writer
+{
+    FILE *File;
+    image_format Format;
+    int Width, Height;
+    int RowCount; /* written so far */
+    bool8 Ok; /* no write failed so far */
+    bool8 IsOnCallingThread; /* PNG deflates without the work queue, for writers that run as work themselves */
+    u8 *RowBytes; /* one row in the file's format */
+    /* PNG only, the IDAT chunks of every band make up one zlib stream */
+    u32 *LastRow; /* the rows are filtered against the ones above them */
+    u32 Adler;
+    image_deflate_chunk *Chunks;
+    int ChunkCount;
+} image_writer;
+
+
+/* by extension: '.ppm', '.tif' or '.tiff', '.png', anything else is raw */
+image_format Image_GetFormat(const char *FileName);
+/* writes the header, File stays open after Image_End() */
+bool8 Image_Begin(image_writer *Writer, FILE *File, image_format Format, int Width, int Height);
+/* RowCount rows of Width pixels, R, G, B, A in memory order like platform_framebuffer, PNG deflates them on the platform's work queue */
+bool8 Image_WriteRows(image_writer *Writer, const u32 *Rows, int RowCount);
+/* false when a write failed or the rows don't add up to Height, frees the writer either way */
+bool8 Image_End(image_writer *Writer);
+/* reads back a PNG like the ones above into Width*Height pixels, false for any other size or kind of PNG, or a broken one */
+bool8 Image_ReadPng(FILE *File, u32 *Pixels, int Width, int Height);
+
+#endif /* IMAGE_H */
+
@@ -0,0 +1,2161 @@
+
+#include <float.h>
+#include <math.h>
+#include "Kernel.h"
+#include "DoubleDouble.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define KERNEL_HAS_X86_SIMD 1
+#  include <cpuid.h>
+#  include <immintrin.h>
+#  define KERNEL_TARGET(Isa) __attribute__((target(Isa)))
+/* the kernels' loops, so that each call gets its own copy with IsBlock and RefillCount folded in */
+#  define KERNEL_INLINE inline __attribute__((always_inline))
+#else
+#  define KERNEL_HAS_X86_SIMD 0
+#endif /* __GNUC__ && x86 */
+
+/*
+    NOTE: the SIMD kernels do the exact same operations in the exact same order as the scalar ones,
+    which is what keeps the counts identical.
+    That only holds as long as the compiler doesn't fuse mul and add into FMA (-ffp-contract=off).
+    The one FMA on purpose is the double-double kernels' exact product error, which Dekker's split gets too.
+*/
+
+static int sKernel_Isa = -1;
+
+/* 
+    Brent's cycle detection: z is compared against the one saved at the last power of two, 
+    so the window it can find a cycle in keeps doubling without ever storing more than one z.
+    It only depends on the iteration, which every lane of a SIMD kernel's block shares, the lanes of its list check it from their counts.
+*/
+#define KERNEL_SAVES_Z_AFTER(i) ((((i) + 1) & (i)) == 0)
+/* a power of two, how often a block checks whether enough of its lanes are off to go on in the list, see Kernel_ShouldStop() */
+#define KERNEL_BLOCK_REFILL_STEPS 32
+
+
+/* same as Kernel_IsInterior(), in the float kernels' precision */
+static bool8 Kernel_IsInteriorF(float Cx, float Cy)
+{
+    float Xq = Cx - 0.25f;
+    float Y2 = Cy*Cy;
+    float q = Xq*Xq + Y2;
+    float Xb = Cx + 1.0f;
+    return q*(q + Xq) <= 0.25f*Y2 || Xb*Xb + Y2 <= 0.0625f;
+}
+
+
+
+/* same as main() in FragmentShader.glsl */
+static void Kernel_ScalarFloat(const render_view *View, kernel_row *Row)
+{
+    float Scale = View->ScreenToWorldScaleFactor;
+    float Left = View->WorldLeft;
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    float Tolerance = View->PeriodicityTolerance * FLT_EPSILON;
+    for (int x = 0; x < Row->Count; x++)
+    {
+        if (Row->Iterations[x] != (u32)Row->StartIteration)
+            continue;
+
+        float MaxValueSquared = 4.0f;
+        float Zx = Row->Zx[x];
+        float Zy = Row->Zy[x];
+        float SavedZx = Row->SavedZx[x];
+        float SavedZy = Row->SavedZy[x];
+        int PixelX = Row->StartX + (Row->IsColumn? 0 : x);
+        int PixelY = Row->Y + (Row->IsColumn? x : 0);
+        float Zix = ((float)PixelX + 0.5f) * Scale + Left;
+        float Ziy = ((float)PixelY + 0.5f) * Scale + (float)View->WorldBottom;
+        if (View->SkipsInterior && Kernel_IsInteriorF(Zix, Ziy))
+        {
+            Row->Iterations[x] = View->IterationCount;
+            Row->EarlyExitCount++;
+            Row->SkippedIterationCount += View->IterationCount - Row->StartIteration;
+            continue;
+        }
+        int i;
+        for (i = Row->StartIteration;
+             i < View->IterationCount
+             && (Zx*Zx + Zy*Zy) < MaxValueSquared;
+             i++)
+        {
+            float Tmp = Zx*Zx - Zy*Zy + Zix;
+            Zy = 2.0f*Zy*Zx + Ziy;
+            Zx = Tmp;
+            if (ChecksPeriodicity)
+            {
+                if (fabsf(Zx - SavedZx) < Tolerance && fabsf(Zy - SavedZy) < Tolerance)
+                {
+                    Row->EarlyExitCount++;
+                    Row->SkippedIterationCount += View->IterationCount - (i + 1);
+                    i = View->IterationCount;
+                    break;
+                }
+                if (KERNEL_SAVES_Z_AFTER(i))
+                {
+                    SavedZx = Zx;
+                    SavedZy = Zy;
+                }
+            }
+        }
+        Row->Iterations[x] = i;
+        Row->Zx[x] = Zx;
+        Row->Zy[x] = Zy;
+        Row->SavedZx[x] = SavedZx;
+        Row->SavedZy[x] = SavedZy;
+    }
+}
+
+static void Kernel_ScalarDouble(const render_view *View, kernel_row *Row)
+{
+    double Scale = View->ScreenToWorldScaleFactor;
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    double Tolerance = View->PeriodicityTolerance * DBL_EPSILON;
+    for (int x = 0; x < Row->Count; x++)
+    {
+        if (Row->Iterations[x] != (u32)Row->StartIteration)
+            continue;
+
+        double Zx = Row->Zx[x];
+        double Zy = Row->Zy[x];
+        double SavedZx = Row->SavedZx[x];
+        double SavedZy = Row->SavedZy[x];
+        int PixelX = Row->StartX + (Row->IsColumn? 0 : x);
+        int PixelY = Row->Y + (Row->IsColumn? x : 0);
+        double Zix = ((double)PixelX + 0.5) * Scale + View->WorldLeft;
+        double Ziy = ((double)PixelY + 0.5) * Scale + View->WorldBottom;
+        if (View->SkipsInterior && Kernel_IsInterior(Zix, Ziy))
+        {
+            Row->Iterations[x] = View->IterationCount;
+            Row->EarlyExitCount++;
+            Row->SkippedIterationCount += View->IterationCount - Row->StartIteration;
+            continue;
+        }
+        int i;
+        for (i = Row->StartIteration;
+             i < View->IterationCount
+             && (Zx*Zx + Zy*Zy) < 4.0;
+             i++)
+        {
+            double Tmp = Zx*Zx - Zy*Zy + Zix;
+            Zy = 2.0*Zy*Zx + Ziy;
+            Zx = Tmp;
+            if (ChecksPeriodicity)
+            {
+                if (fabs(Zx - SavedZx) < Tolerance && fabs(Zy - SavedZy) < Tolerance)
+                {
+                    Row->EarlyExitCount++;
+                    Row->SkippedIterationCount += View->IterationCount - (i + 1);
+                    i = View->IterationCount;
+                    break;
+                }
+                if (KERNEL_SAVES_Z_AFTER(i))
+                {
+                    SavedZx = Zx;
+                    SavedZy = Zy;
+                }
+            }
+        }
+        Row->Iterations[x] = i;
+        Row->Zx[x] = Zx;
+        Row->Zy[x] = Zy;
+        Row->SavedZx[x] = SavedZx;
+        Row->SavedZy[x] = SavedZy;
+    }
+}
+
+
+static void Kernel_ScalarDoubleDouble(const render_view *View, kernel_row *Row)
+{
+    double Scale = View->ScreenToWorldScaleFactor;
+    ddouble Left = DD_FromBigFix(&View->ExactWorldLeft);
+    ddouble Bottom = DD_FromBigFix(&View->ExactWorldBottom);
+    for (int x = 0; x < Row->Count; x++)
+    {
+        if (Row->Iterations[x] != (u32)Row->StartIteration)
+            continue;
+
+        ddouble Zx = { Row->Zx[x], Row->ZxLo[x] };
+        ddouble Zy = { Row->Zy[x], Row->ZyLo[x] };
+        int PixelX = Row->StartX + (Row->IsColumn? 0 : x);
+        int PixelY = Row->Y + (Row->IsColumn? x : 0);
+        ddouble Zix = DD_Add(Left, DD_TwoProd((double)PixelX + 0.5, Scale));
+        ddouble Ziy = DD_Add(Bottom, DD_TwoProd((double)PixelY + 0.5, Scale));
+        /* double is plenty, points that close to the boundary don't escape in any sane iteration count */
+        if (View->SkipsInterior && Kernel_IsInterior(Zix.Hi, Ziy.Hi))
+        {
+            Row->Iterations[x] = View->IterationCount;
+            Row->EarlyExitCount++;
+            Row->SkippedIterationCount += View->IterationCount - Row->StartIteration;
+            continue;
+        }
+        int i;
+        for (i = Row->StartIteration; i < View->IterationCount; i++)
+        {
+            ddouble Zx2 = DD_Sqr(Zx);
+            ddouble Zy2 = DD_Sqr(Zy);
+            if (Zx2.Hi + Zy2.Hi >= 4.0)
+                break;
+
+            ddouble Tmp = DD_Add(DD_Sub(Zx2, Zy2), Zix);
+            Zy = DD_Add(DD_MulBy2(DD_Mul(Zx, Zy)), Ziy);
+            Zx = Tmp;
+        }
+        Row->Iterations[x] = i;
+        Row->Zx[x] = Zx.Hi;
+        Row->ZxLo[x] = Zx.Lo;
+        Row->Zy[x] = Zy.Hi;
+        Row->ZyLo[x] = Zy.Lo;
+    }
+}
+
+
+#if KERNEL_HAS_X86_SIMD
+
+/*
+    Every kernel below goes like this:
+    each lane holds one pixel, lanes that reached the bailout or their iteration count get masked off,
+    active lanes get their count bumped.
+    The row starts out in blocks of a vector's width, straight from its arrays, 
+    until enough lanes of a block are off, and the pixels of the block still going make the kernel's list.
+    The list is then iterated with every lane taking the next pixel off it as soon as the one it had is done,
+    so that the lanes keep iterating pixels that need it instead of waiting for the slowest one of a block.
+    Lanes caught in a cycle are masked off the same way, after their count jumps to View->IterationCount.
+    z is stored as double even for float lanes, which converts back and forth exactly.
+*/
+
+/* 
+    The list of a row's pixels still going after their block, and the lanes iterating them,
+    as arrays to load the vectors from and store them back to around each run of a kernel's loop.
+    The pixels' counts and z stay in the row in between.
+    A lane without a pixel has the count View->IterationCount, which keeps it off.
+*/
+typedef struct kernel_lanes
+{
+    int Count;
+    int RefillCount; /* this many lanes off and the loop stops for more pixels, one with few lanes, half with many */
+    render_precision Precision;
+
+    int PixelCount, NextPixel;
+    int Pixels[KERNEL_MAX_ROW_COUNT]; /* x in the row */
+    double PixelCx[KERNEL_MAX_ROW_COUNT], PixelCy[KERNEL_MAX_ROW_COUNT];
+    double PixelCxLo[KERNEL_MAX_ROW_COUNT], PixelCyLo[KERNEL_MAX_ROW_COUNT]; /* double-double only */
+
+    int Pixel[KERNEL_MAX_LANE_COUNT]; /* -1 for none */
+    u32 Iterations[KERNEL_MAX_LANE_COUNT];
+    u32 SaveAt[KERNEL_MAX_LANE_COUNT]; /* count that the cycle check saves z at next */
+    double Zx[KERNEL_MAX_LANE_COUNT], Zy[KERNEL_MAX_LANE_COUNT];
+    double ZxLo[KERNEL_MAX_LANE_COUNT], ZyLo[KERNEL_MAX_LANE_COUNT]; /* double-double only */
+    double SavedZx[KERNEL_MAX_LANE_COUNT], SavedZy[KERNEL_MAX_LANE_COUNT];
+    double Cx[KERNEL_MAX_LANE_COUNT], Cy[KERNEL_MAX_LANE_COUNT];
+    double CxLo[KERNEL_MAX_LANE_COUNT], CyLo[KERNEL_MAX_LANE_COUNT]; /* double-double only */
+} kernel_lanes;
+
+static void Kernel_BeginLanes(kernel_lanes *Lanes, const kernel_row *Row, int Count, render_precision Precision)
+{
+    ASSERT(Row->Count <= KERNEL_MAX_ROW_COUNT, "Row too long");
+    Lanes->Count = Count;
+    Lanes->RefillCount = MAX(Count / 2, 1);
+    Lanes->Precision = Precision;
+    Lanes->PixelCount = 0;
+    Lanes->NextPixel = 0;
+}
+
+/* the first count past Iterations that KERNEL_SAVES_Z_AFTER() the iteration before */
+static u32 Kernel_GetSaveAt(u32 Iterations)
+{
+    return Iterations? 1u << (32 - __builtin_clz(Iterations)) : 1;
+}
+
+/* the lanes of Survivors, of the block at x, go on the list with their c, CxLo and CyLo only for double-double */
+static void Kernel_ListLanes(kernel_lanes *Lanes, int x, u32 Survivors, const double *Cx, const double *Cy, const double *CxLo, const double *CyLo)
+{
+    for (; Survivors; Survivors &= Survivors - 1)
+    {
+        int k = __builtin_ctz(Survivors);
+        int i = Lanes->PixelCount++;
+        Lanes->Pixels[i] = x + k;
+        Lanes->PixelCx[i] = Cx[k];
+        Lanes->PixelCy[i] = Cy[k];
+        if (CxLo)
+        {
+            Lanes->PixelCxLo[i] = CxLo[k];
+            Lanes->PixelCyLo[i] = CyLo[k];
+        }
+    }
+}
+
+/* 
+    Writes the lanes not in ActiveLanes back to the row and loads the next pixels of the list into them.
+    Returns the lanes active from now on, 0 once the row is done.
+*/
+static u32 Kernel_RefillLanes(kernel_lanes *Lanes, const render_view *View, kernel_row *Row, u32 ActiveLanes)
+{
+    bool8 IsDoubleDouble = Lanes->Precision == RENDER_PRECISION_DOUBLE_DOUBLE;
+    for (u32 Idle = ~ActiveLanes & ((1u << Lanes->Count) - 1); Idle; Idle &= Idle - 1)
+    {
+        int k = __builtin_ctz(Idle);
+        int x = Lanes->Pixel[k];
+        if (x >= 0)
+        {
+            Row->Iterations[x] = Lanes->Iterations[k];
+            Row->Zx[x] = Lanes->Zx[k];
+            Row->Zy[x] = Lanes->Zy[k];
+            Row->SavedZx[x] = Lanes->SavedZx[k];
+            Row->SavedZy[x] = Lanes->SavedZy[k];
+            if (IsDoubleDouble)
+            {
+                Row->ZxLo[x] = Lanes->ZxLo[k];
+                Row->ZyLo[x] = Lanes->ZyLo[k];
+            }
+            Lanes->Pixel[k] = -1;
+            Lanes->Iterations[k] = View->IterationCount;
+        }
+
+        if (Lanes->NextPixel < Lanes->PixelCount)
+        {
+            int i = Lanes->NextPixel++;
+            x = Lanes->Pixels[i];
+            Lanes->Pixel[k] = x;
+            Lanes->Iterations[k] = Row->Iterations[x];
+            Lanes->SaveAt[k] = Kernel_GetSaveAt(Row->Iterations[x]);
+            Lanes->Zx[k] = Row->Zx[x];
+            Lanes->Zy[k] = Row->Zy[x];
+            Lanes->SavedZx[k] = Row->SavedZx[x];
+            Lanes->SavedZy[k] = Row->SavedZy[x];
+            Lanes->Cx[k] = Lanes->PixelCx[i];
+            Lanes->Cy[k] = Lanes->PixelCy[i];
+            if (IsDoubleDouble)
+            {
+                Lanes->ZxLo[k] = Row->ZxLo[x];
+                Lanes->ZyLo[k] = Row->ZyLo[x];
+                Lanes->CxLo[k] = Lanes->PixelCxLo[i];
+                Lanes->CyLo[k] = Lanes->PixelCyLo[i];
+            }
+            ActiveLanes |= 1u << k;
+        }
+    }
+    return ActiveLanes;
+}
+
+/* 
+    Loads the first pixels of the list into the lanes, after the blocks.
+    Returns the active lanes like Kernel_RefillLanes(), 0 right away for a row that the blocks finished.
+*/
+static u32 Kernel_BeginList(kernel_lanes *Lanes, const render_view *View, kernel_row *Row)
+{
+    if (Lanes->PixelCount == 0)
+        return 0;
+    for (int k = 0; k < Lanes->Count; k++)
+    {
+        Lanes->Pixel[k] = -1;
+        Lanes->Iterations[k] = View->IterationCount;
+        Lanes->SaveAt[k] = 0;
+        Lanes->Zx[k] = Lanes->Zy[k] = Lanes->ZxLo[k] = Lanes->ZyLo[k] = 0;
+        Lanes->SavedZx[k] = Lanes->SavedZy[k] = 0;
+        Lanes->Cx[k] = Lanes->Cy[k] = Lanes->CxLo[k] = Lanes->CyLo[k] = 0;
+    }
+    return Kernel_RefillLanes(Lanes, View, Row, 0);
+}
+
+/* 
+    How many iterations the active lanes can all take before the furthest one reaches View->IterationCount,
+    the loop stops there so that it need not check every lane's count.
+*/
+static int Kernel_GetLaneStepCount(const kernel_lanes *Lanes, const render_view *View, u32 ActiveLanes)
+{
+    u32 MaxIterations = 0;
+    for (int k = 0; k < Lanes->Count; k++)
+    {
+        u32 Iterations = (ActiveLanes >> k & 1)? Lanes->Iterations[k] : 0;
+        MaxIterations = MAX(MaxIterations, Iterations);
+    }
+    return View->IterationCount - MaxIterations;
+}
+
+/* whether RefillCount of the Count lanes are off, inlined into kernels that have popcnt */
+static inline bool8 Kernel_NeedsRefill(u32 ActiveLanes, int Count, int RefillCount)
+{
+    return Count - __builtin_popcount(ActiveLanes) >= RefillCount;
+}
+
+/* same for the 2 or 4 lanes of SSE2, which has no popcnt: bits set in every nibble, packed in a constant */
+static inline bool8 Kernel_Sse2NeedsRefill(u32 ActiveLanes, int Count, int RefillCount)
+{
+    int ActiveCount = (0x4332322132212110ull >> (ActiveLanes*4)) & 0xF;
+    return Count - ActiveCount >= RefillCount;
+}
+
+/* 
+    Whether a kernel's loop stops at Step. The list's lanes look for more pixels as soon as RefillCount of them are off, 
+    a block only every KERNEL_BLOCK_REFILL_STEPS: most blocks of a shallow view are done before that or all go on together,
+    and they only pay for the test of the loop without a list, that every lane is off.
+*/
+static inline bool8 Kernel_ShouldStop(u32 ActiveLanes, int Count, int RefillCount, int Step, bool8 IsBlock)
+{
+    if (IsBlock)
+        return !ActiveLanes || ((Step + 1) % KERNEL_BLOCK_REFILL_STEPS == 0 && Kernel_NeedsRefill(ActiveLanes, Count, RefillCount));
+    return Kernel_NeedsRefill(ActiveLanes, Count, RefillCount);
+}
+
+static inline bool8 Kernel_Sse2ShouldStop(u32 ActiveLanes, int Count, int RefillCount, int Step, bool8 IsBlock)
+{
+    if (IsBlock)
+        return !ActiveLanes || ((Step + 1) % KERNEL_BLOCK_REFILL_STEPS == 0 && Kernel_Sse2NeedsRefill(ActiveLanes, Count, RefillCount));
+    return Kernel_Sse2NeedsRefill(ActiveLanes, Count, RefillCount);
+}
+
+/* once the list runs out the lanes have nothing to take, and go on until they are all off */
+static int Kernel_GetRefillCount(const kernel_lanes *Lanes)
+{
+    return Lanes->NextPixel < Lanes->PixelCount? Lanes->RefillCount : Lanes->Count;
+}
+
+/* the lanes of Periodic jump to View->IterationCount from Counts, which they got to */
+static void Kernel_SkipPeriodicLanes(const render_view *View, kernel_row *Row, const u32 *Counts, u32 Periodic)
+{
+    for (int k = 0; Periodic; k++, Periodic >>= 1)
+    {
+        if (Periodic & 1)
+        {
+            Row->EarlyExitCount++;
+            Row->SkippedIterationCount += View->IterationCount - Counts[k];
+        }
+    }
+}
+
+/* Kernel_IsInterior() of every lane, as a lane mask */
+KERNEL_TARGET("sse2")
+static __m128 Kernel_Sse2IsInteriorPs(__m128 Cx, __m128 Cy)
+{
+    __m128 Xq = _mm_sub_ps(Cx, _mm_set1_ps(0.25f));
+    __m128 Y2 = _mm_mul_ps(Cy, Cy);
+    __m128 q = _mm_add_ps(_mm_mul_ps(Xq, Xq), Y2);
+    __m128 Xb = _mm_add_ps(Cx, _mm_set1_ps(1.0f));
+    __m128 Cardioid = _mm_cmple_ps(_mm_mul_ps(q, _mm_add_ps(q, Xq)), _mm_mul_ps(_mm_set1_ps(0.25f), Y2));
+    __m128 Bulb = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(Xb, Xb), Y2), _mm_set1_ps(0.0625f));
+    return _mm_or_ps(Cardioid, Bulb);
+}
+
+KERNEL_TARGET("sse2")
+static __m128d Kernel_Sse2IsInteriorPd(__m128d Cx, __m128d Cy)
+{
+    __m128d Xq = _mm_sub_pd(Cx, _mm_set1_pd(0.25));
+    __m128d Y2 = _mm_mul_pd(Cy, Cy);
+    __m128d q = _mm_add_pd(_mm_mul_pd(Xq, Xq), Y2);
+    __m128d Xb = _mm_add_pd(Cx, _mm_set1_pd(1.0));
+    __m128d Cardioid = _mm_cmple_pd(_mm_mul_pd(q, _mm_add_pd(q, Xq)), _mm_mul_pd(_mm_set1_pd(0.25), Y2));
+    __m128d Bulb = _mm_cmple_pd(_mm_add_pd(_mm_mul_pd(Xb, Xb), Y2), _mm_set1_pd(0.0625));
+    return _mm_or_pd(Cardioid, Bulb);
+}
+
+/* 4 floats from and to the doubles of a row or the lanes */
+KERNEL_TARGET("sse2")
+static __m128 Kernel_Sse2LoadFloats(const double *Values)
+{
+    return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(Values)), _mm_cvtpd_ps(_mm_loadu_pd(Values + 2)));
+}
+
+KERNEL_TARGET("sse2")
+static void Kernel_Sse2StoreFloats(double *Values, __m128 Floats)
+{
+    _mm_storeu_pd(Values, _mm_cvtps_pd(Floats));
+    _mm_storeu_pd(Values + 2, _mm_cvtps_pd(_mm_movehl_ps(Floats, Floats)));
+}
+
+/* 2 counts from and to 64-bit lanes, to line up with the doubles */
+KERNEL_TARGET("sse2")
+static __m128i Kernel_Sse2LoadCounts(const u32 *Counts)
+{
+    return _mm_unpacklo_epi32(_mm_loadl_epi64((const __m128i *)Counts), _mm_setzero_si128());
+}
+
+KERNEL_TARGET("sse2")
+static void Kernel_Sse2StoreCounts(u32 *Counts, __m128i Lanes)
+{
+    _mm_storel_epi64((__m128i *)Counts, _mm_shuffle_epi32(Lanes, _MM_SHUFFLE(3, 3, 2, 0)));
+}
+
+/* no 64-bit compares in SSE2, the counts never get near 2^31 so the low halves decide */
+KERNEL_TARGET("sse2")
+static __m128i Kernel_Sse2CountsEqual(__m128i A, __m128i B)
+{
+    return _mm_shuffle_epi32(_mm_cmpeq_epi32(A, B), _MM_SHUFFLE(2, 2, 0, 0));
+}
+
+KERNEL_TARGET("sse2")
+static __m128i Kernel_Sse2CountsLess(__m128i A, __m128i B)
+{
+    return _mm_shuffle_epi32(_mm_cmplt_epi32(A, B), _MM_SHUFFLE(2, 2, 0, 0));
+}
+
+/* B in the lanes of Mask, A in the others */
+KERNEL_TARGET("sse2")
+static __m128i Kernel_Sse2Select(__m128i Mask, __m128i A, __m128i B)
+{
+    return _mm_or_si128(_mm_andnot_si128(Mask, A), _mm_and_si128(Mask, B));
+}
+
+KERNEL_TARGET("sse2")
+static __m128 Kernel_Sse2SelectPs(__m128 Mask, __m128 A, __m128 B)
+{
+    return _mm_or_ps(_mm_andnot_ps(Mask, A), _mm_and_ps(Mask, B));
+}
+
+KERNEL_TARGET("sse2")
+static __m128d Kernel_Sse2SelectPd(__m128d Mask, __m128d A, __m128d B)
+{
+    return _mm_or_pd(_mm_andnot_pd(Mask, A), _mm_and_pd(Mask, B));
+}
+
+/* the vectors of Kernel_Sse2Float() */
+typedef struct kernel_sse2_float
+{
+    __m128 Active;
+    __m128 Cx, Cy;
+    __m128 Zx, Zy;
+    __m128 SavedZx, SavedZy;
+    __m128i Counts, SaveAt;
+} kernel_sse2_float;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("sse2")
+static KERNEL_INLINE void Kernel_Sse2FloatRun(const render_view *View, kernel_row *Row, kernel_sse2_float *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m128 Four = _mm_set1_ps(4.0f);
+    __m128 Two = _mm_set1_ps(2.0f);
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    __m128 Tolerance = _mm_set1_ps(View->PeriodicityTolerance * FLT_EPSILON);
+    __m128 SignBit = _mm_set1_ps(-0.0f);
+    __m128i IterationCount = _mm_set1_epi32(View->IterationCount);
+    __m128 Active = V->Active;
+    __m128 Cx = V->Cx, Cy = V->Cy;
+    __m128 Zx = V->Zx, Zy = V->Zy;
+    __m128 SavedZx = V->SavedZx, SavedZy = V->SavedZy;
+    __m128i Counts = V->Counts, SaveAt = V->SaveAt;
+    /* lanes caught in a cycle keep the z they were caught at, the others step on after they are off */
+    __m128 Caught = _mm_setzero_ps();
+    __m128 CaughtZx = Zx, CaughtZy = Zy;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        __m128 Zx2 = _mm_mul_ps(Zx, Zx);
+        __m128 Zy2 = _mm_mul_ps(Zy, Zy);
+        Active = _mm_and_ps(Active, _mm_cmplt_ps(_mm_add_ps(Zx2, Zy2), Four));
+        if (Kernel_Sse2ShouldStop(_mm_movemask_ps(Active), 4, RefillCount, Step, IsBlock))
+            break;
+        /* active lanes are all ones (-1) */
+        Counts = _mm_sub_epi32(Counts, _mm_castps_si128(Active));
+
+        __m128 Tmp = _mm_add_ps(_mm_sub_ps(Zx2, Zy2), Cx);
+        Zy = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(Two, Zy), Zx), Cy);
+        Zx = Tmp;
+        if (ChecksPeriodicity)
+        {
+            __m128 CloseX = _mm_cmplt_ps(_mm_andnot_ps(SignBit, _mm_sub_ps(Zx, SavedZx)), Tolerance);
+            __m128 CloseY = _mm_cmplt_ps(_mm_andnot_ps(SignBit, _mm_sub_ps(Zy, SavedZy)), Tolerance);
+            __m128 Periodic = _mm_and_ps(Active, _mm_and_ps(CloseX, CloseY));
+            int PeriodicLanes = _mm_movemask_ps(Periodic);
+            if (PeriodicLanes)
+            {
+                u32 LaneCounts[4];
+                _mm_storeu_si128((__m128i *)LaneCounts, Counts);
+                Kernel_SkipPeriodicLanes(View, Row, LaneCounts, PeriodicLanes);
+                Counts = Kernel_Sse2Select(_mm_castps_si128(Periodic), Counts, IterationCount);
+                CaughtZx = Kernel_Sse2SelectPs(Periodic, CaughtZx, Zx);
+                CaughtZy = Kernel_Sse2SelectPs(Periodic, CaughtZy, Zy);
+                Caught = _mm_or_ps(Caught, Periodic);
+                Active = _mm_andnot_ps(Periodic, Active);
+            }
+            __m128 Saves = IsBlock? Active : _mm_and_ps(Active, _mm_castsi128_ps(_mm_cmpeq_epi32(Counts, SaveAt)));
+            if (IsBlock? KERNEL_SAVES_Z_AFTER(Row->StartIteration + Step) : _mm_movemask_ps(Saves))
+            {
+                SavedZx = Kernel_Sse2SelectPs(Saves, SavedZx, Zx);
+                SavedZy = Kernel_Sse2SelectPs(Saves, SavedZy, Zy);
+                SaveAt = _mm_add_epi32(SaveAt, _mm_and_si128(_mm_castps_si128(Saves), SaveAt));
+            }
+        }
+    }
+    V->Active = _mm_and_ps(Active, _mm_castsi128_ps(_mm_cmplt_epi32(Counts, IterationCount)));
+    V->Zx = Kernel_Sse2SelectPs(Caught, Zx, CaughtZx);
+    V->Zy = Kernel_Sse2SelectPs(Caught, Zy, CaughtZy);
+    V->SavedZx = SavedZx;
+    V->SavedZy = SavedZy;
+    V->Counts = Counts;
+    V->SaveAt = SaveAt;
+}
+
+KERNEL_TARGET("sse2")
+static void Kernel_Sse2Float(const render_view *View, kernel_row *Row)
+{
+    float Scale = View->ScreenToWorldScaleFactor;
+    float Left = View->WorldLeft;
+    float Bottom = View->WorldBottom;
+    /* lane i is pixel i of the row, or of the column */
+    __m128i ColumnMask = _mm_set1_epi32(Row->IsColumn? -1 : 0);
+    __m128i LaneX = _mm_andnot_si128(ColumnMask, _mm_setr_epi32(0, 1, 2, 3));
+    __m128i LaneY = _mm_and_si128(ColumnMask, _mm_setr_epi32(0, 1, 2, 3));
+    __m128i IterationCount = _mm_set1_epi32(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 4, RENDER_PRECISION_FLOAT);
+    kernel_sse2_float V;
+    for (int x = 0; x < Row->Count; x += 4)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m128 PixelX = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(StartX), LaneX));
+        __m128 PixelY = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(StartY), LaneY));
+        V.Cx = _mm_add_ps(_mm_mul_ps(_mm_add_ps(PixelX, _mm_set1_ps(0.5f)), _mm_set1_ps(Scale)), _mm_set1_ps(Left));
+        V.Cy = _mm_add_ps(_mm_mul_ps(_mm_add_ps(PixelY, _mm_set1_ps(0.5f)), _mm_set1_ps(Scale)), _mm_set1_ps(Bottom));
+        V.Zx = Kernel_Sse2LoadFloats(Row->Zx + x);
+        V.Zy = Kernel_Sse2LoadFloats(Row->Zy + x);
+        V.SavedZx = Kernel_Sse2LoadFloats(Row->SavedZx + x);
+        V.SavedZy = Kernel_Sse2LoadFloats(Row->SavedZy + x);
+        V.Counts = _mm_loadu_si128((__m128i *)(Row->Iterations + x));
+        V.SaveAt = _mm_set1_epi32(Kernel_GetSaveAt(Row->StartIteration));
+        V.Active = _mm_castsi128_ps(_mm_cmpeq_epi32(V.Counts, _mm_set1_epi32(Row->StartIteration)));
+        if (View->SkipsInterior)
+        {
+            __m128 Interior = _mm_and_ps(V.Active, Kernel_Sse2IsInteriorPs(V.Cx, V.Cy));
+            V.Counts = Kernel_Sse2Select(_mm_castps_si128(Interior), V.Counts, IterationCount);
+            V.Active = _mm_andnot_ps(Interior, V.Active);
+            int InteriorCount = __builtin_popcount(_mm_movemask_ps(Interior));
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (_mm_movemask_ps(V.Active))
+        {
+            Kernel_Sse2FloatRun(View, Row, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        _mm_storeu_si128((__m128i *)(Row->Iterations + x), V.Counts);
+        Kernel_Sse2StoreFloats(Row->Zx + x, V.Zx);
+        Kernel_Sse2StoreFloats(Row->Zy + x, V.Zy);
+        Kernel_Sse2StoreFloats(Row->SavedZx + x, V.SavedZx);
+        Kernel_Sse2StoreFloats(Row->SavedZy + x, V.SavedZy);
+        int Survivors = _mm_movemask_ps(V.Active);
+        if (Survivors)
+        {
+            double Cx[4], Cy[4];
+            Kernel_Sse2StoreFloats(Cx, V.Cx);
+            Kernel_Sse2StoreFloats(Cy, V.Cy);
+            Kernel_ListLanes(&Lanes, x, Survivors, Cx, Cy, NULL, NULL);
+        }
+    }
+
+    u32 ActiveLanes = Kernel_BeginList(&Lanes, View, Row);
+    while (ActiveLanes)
+    {
+        V.Cx = Kernel_Sse2LoadFloats(Lanes.Cx);
+        V.Cy = Kernel_Sse2LoadFloats(Lanes.Cy);
+        V.Zx = Kernel_Sse2LoadFloats(Lanes.Zx);
+        V.Zy = Kernel_Sse2LoadFloats(Lanes.Zy);
+        V.SavedZx = Kernel_Sse2LoadFloats(Lanes.SavedZx);
+        V.SavedZy = Kernel_Sse2LoadFloats(Lanes.SavedZy);
+        V.Counts = _mm_loadu_si128((__m128i *)Lanes.Iterations);
+        V.SaveAt = _mm_loadu_si128((__m128i *)Lanes.SaveAt);
+        V.Active = _mm_castsi128_ps(_mm_cmplt_epi32(V.Counts, IterationCount));
+        Kernel_Sse2FloatRun(View, Row, &V, Kernel_GetLaneStepCount(&Lanes, View, ActiveLanes), Kernel_GetRefillCount(&Lanes), false);
+        _mm_storeu_si128((__m128i *)Lanes.Iterations, V.Counts);
+        _mm_storeu_si128((__m128i *)Lanes.SaveAt, V.SaveAt);
+        Kernel_Sse2StoreFloats(Lanes.Zx, V.Zx);
+        Kernel_Sse2StoreFloats(Lanes.Zy, V.Zy);
+        Kernel_Sse2StoreFloats(Lanes.SavedZx, V.SavedZx);
+        Kernel_Sse2StoreFloats(Lanes.SavedZy, V.SavedZy);
+        ActiveLanes = Kernel_RefillLanes(&Lanes, View, Row, _mm_movemask_ps(V.Active));
+    }
+}
+
+/* the vectors of Kernel_Sse2Double() */
+typedef struct kernel_sse2_double
+{
+    __m128d Active;
+    __m128d Cx, Cy;
+    __m128d Zx, Zy;
+    __m128d SavedZx, SavedZy;
+    __m128i Counts, SaveAt; /* 64-bit, to line up with the doubles */
+} kernel_sse2_double;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("sse2")
+static KERNEL_INLINE void Kernel_Sse2DoubleRun(const render_view *View, kernel_row *Row, kernel_sse2_double *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m128d Four = _mm_set1_pd(4.0);
+    __m128d Two = _mm_set1_pd(2.0);
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    __m128d Tolerance = _mm_set1_pd(View->PeriodicityTolerance * DBL_EPSILON);
+    __m128d SignBit = _mm_set1_pd(-0.0);
+    __m128i IterationCount = _mm_set1_epi64x(View->IterationCount);
+    __m128d Active = V->Active;
+    __m128d Cx = V->Cx, Cy = V->Cy;
+    __m128d Zx = V->Zx, Zy = V->Zy;
+    __m128d SavedZx = V->SavedZx, SavedZy = V->SavedZy;
+    __m128i Counts = V->Counts, SaveAt = V->SaveAt;
+    /* lanes caught in a cycle keep the z they were caught at, the others step on after they are off */
+    __m128d Caught = _mm_setzero_pd();
+    __m128d CaughtZx = Zx, CaughtZy = Zy;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        __m128d Zx2 = _mm_mul_pd(Zx, Zx);
+        __m128d Zy2 = _mm_mul_pd(Zy, Zy);
+        Active = _mm_and_pd(Active, _mm_cmplt_pd(_mm_add_pd(Zx2, Zy2), Four));
+        if (Kernel_Sse2ShouldStop(_mm_movemask_pd(Active), 2, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm_sub_epi64(Counts, _mm_castpd_si128(Active));
+
+        __m128d Tmp = _mm_add_pd(_mm_sub_pd(Zx2, Zy2), Cx);
+        Zy = _mm_add_pd(_mm_mul_pd(_mm_mul_pd(Two, Zy), Zx), Cy);
+        Zx = Tmp;
+        if (ChecksPeriodicity)
+        {
+            __m128d CloseX = _mm_cmplt_pd(_mm_andnot_pd(SignBit, _mm_sub_pd(Zx, SavedZx)), Tolerance);
+            __m128d CloseY = _mm_cmplt_pd(_mm_andnot_pd(SignBit, _mm_sub_pd(Zy, SavedZy)), Tolerance);
+            __m128d Periodic = _mm_and_pd(Active, _mm_and_pd(CloseX, CloseY));
+            int PeriodicLanes = _mm_movemask_pd(Periodic);
+            if (PeriodicLanes)
+            {
+                u32 LaneCounts[2];
+                Kernel_Sse2StoreCounts(LaneCounts, Counts);
+                Kernel_SkipPeriodicLanes(View, Row, LaneCounts, PeriodicLanes);
+                Counts = Kernel_Sse2Select(_mm_castpd_si128(Periodic), Counts, IterationCount);
+                CaughtZx = Kernel_Sse2SelectPd(Periodic, CaughtZx, Zx);
+                CaughtZy = Kernel_Sse2SelectPd(Periodic, CaughtZy, Zy);
+                Caught = _mm_or_pd(Caught, Periodic);
+                Active = _mm_andnot_pd(Periodic, Active);
+            }
+            __m128d Saves = IsBlock? Active : _mm_and_pd(Active, _mm_castsi128_pd(Kernel_Sse2CountsEqual(Counts, SaveAt)));
+            if (IsBlock? KERNEL_SAVES_Z_AFTER(Row->StartIteration + Step) : _mm_movemask_pd(Saves))
+            {
+                SavedZx = Kernel_Sse2SelectPd(Saves, SavedZx, Zx);
+                SavedZy = Kernel_Sse2SelectPd(Saves, SavedZy, Zy);
+                SaveAt = _mm_add_epi64(SaveAt, _mm_and_si128(_mm_castpd_si128(Saves), SaveAt));
+            }
+        }
+    }
+    V->Active = _mm_and_pd(Active, _mm_castsi128_pd(Kernel_Sse2CountsLess(Counts, IterationCount)));
+    V->Zx = Kernel_Sse2SelectPd(Caught, Zx, CaughtZx);
+    V->Zy = Kernel_Sse2SelectPd(Caught, Zy, CaughtZy);
+    V->SavedZx = SavedZx;
+    V->SavedZy = SavedZy;
+    V->Counts = Counts;
+    V->SaveAt = SaveAt;
+}
+
+KERNEL_TARGET("sse2")
+static void Kernel_Sse2Double(const render_view *View, kernel_row *Row)
+{
+    double Scale = View->ScreenToWorldScaleFactor;
+    __m128i ColumnMask = _mm_set1_epi32(Row->IsColumn? -1 : 0);
+    __m128i LaneX = _mm_andnot_si128(ColumnMask, _mm_setr_epi32(0, 1, 0, 0));
+    __m128i LaneY = _mm_and_si128(ColumnMask, _mm_setr_epi32(0, 1, 0, 0));
+    __m128i IterationCount = _mm_set1_epi64x(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 2, RENDER_PRECISION_DOUBLE);
+    kernel_sse2_double V;
+    for (int x = 0; x < Row->Count; x += 2)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m128d PixelX = _mm_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartX), LaneX));
+        __m128d PixelY = _mm_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartY), LaneY));
+        V.Cx = _mm_add_pd(_mm_mul_pd(_mm_add_pd(PixelX, _mm_set1_pd(0.5)), _mm_set1_pd(Scale)), _mm_set1_pd(View->WorldLeft));
+        V.Cy = _mm_add_pd(_mm_mul_pd(_mm_add_pd(PixelY, _mm_set1_pd(0.5)), _mm_set1_pd(Scale)), _mm_set1_pd(View->WorldBottom));
+        V.Zx = _mm_loadu_pd(Row->Zx + x);
+        V.Zy = _mm_loadu_pd(Row->Zy + x);
+        V.SavedZx = _mm_loadu_pd(Row->SavedZx + x);
+        V.SavedZy = _mm_loadu_pd(Row->SavedZy + x);
+        V.Counts = Kernel_Sse2LoadCounts(Row->Iterations + x);
+        V.SaveAt = _mm_set1_epi64x(Kernel_GetSaveAt(Row->StartIteration));
+        V.Active = _mm_castsi128_pd(Kernel_Sse2CountsEqual(V.Counts, _mm_set1_epi64x(Row->StartIteration)));
+        if (View->SkipsInterior)
+        {
+            __m128d Interior = _mm_and_pd(V.Active, Kernel_Sse2IsInteriorPd(V.Cx, V.Cy));
+            V.Counts = Kernel_Sse2Select(_mm_castpd_si128(Interior), V.Counts, IterationCount);
+            V.Active = _mm_andnot_pd(Interior, V.Active);
+            int InteriorCount = __builtin_popcount(_mm_movemask_pd(Interior));
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (_mm_movemask_pd(V.Active))
+        {
+            Kernel_Sse2DoubleRun(View, Row, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        Kernel_Sse2StoreCounts(Row->Iterations + x, V.Counts);
+        _mm_storeu_pd(Row->Zx + x, V.Zx);
+        _mm_storeu_pd(Row->Zy + x, V.Zy);
+        _mm_storeu_pd(Row->SavedZx + x, V.SavedZx);
+        _mm_storeu_pd(Row->SavedZy + x, V.SavedZy);
+        int Survivors = _mm_movemask_pd(V.Active);
+        if (Survivors)
+        {
+            double Cx[2], Cy[2];
+            _mm_storeu_pd(Cx, V.Cx);
+            _mm_storeu_pd(Cy, V.Cy);
+            Kernel_ListLanes(&Lanes, x, Survivors, Cx, Cy, NULL, NULL);
+        }
+    }
+
+    u32 ActiveLanes = Kernel_BeginList(&Lanes, View, Row);
+    while (ActiveLanes)
+    {
+        V.Cx = _mm_loadu_pd(Lanes.Cx);
+        V.Cy = _mm_loadu_pd(Lanes.Cy);
+        V.Zx = _mm_loadu_pd(Lanes.Zx);
+        V.Zy = _mm_loadu_pd(Lanes.Zy);
+        V.SavedZx = _mm_loadu_pd(Lanes.SavedZx);
+        V.SavedZy = _mm_loadu_pd(Lanes.SavedZy);
+        V.Counts = Kernel_Sse2LoadCounts(Lanes.Iterations);
+        V.SaveAt = Kernel_Sse2LoadCounts(Lanes.SaveAt);
+        V.Active = _mm_castsi128_pd(Kernel_Sse2CountsLess(V.Counts, IterationCount));
+        Kernel_Sse2DoubleRun(View, Row, &V, Kernel_GetLaneStepCount(&Lanes, View, ActiveLanes), Kernel_GetRefillCount(&Lanes), false);
+        Kernel_Sse2StoreCounts(Lanes.Iterations, V.Counts);
+        Kernel_Sse2StoreCounts(Lanes.SaveAt, V.SaveAt);
+        _mm_storeu_pd(Lanes.Zx, V.Zx);
+        _mm_storeu_pd(Lanes.Zy, V.Zy);
+        _mm_storeu_pd(Lanes.SavedZx, V.SavedZx);
+        _mm_storeu_pd(Lanes.SavedZy, V.SavedZy);
+        ActiveLanes = Kernel_RefillLanes(&Lanes, View, Row, _mm_movemask_pd(V.Active));
+    }
+}
+
+
+/* a ddouble in every lane, the helpers below do what DoubleDouble.h does in the same order */
+typedef struct ddouble2
+{
+    __m128d Hi, Lo;
+} ddouble2;
+
+KERNEL_TARGET("sse2")
+static inline ddouble2 Kernel_Sse2QuickTwoSum(__m128d A, __m128d B)
+{
+    __m128d Sum = _mm_add_pd(A, B);
+    return (ddouble2) { Sum, _mm_sub_pd(B, _mm_sub_pd(Sum, A)) };
+}
+
+KERNEL_TARGET("sse2")
+static inline ddouble2 Kernel_Sse2TwoSum(__m128d A, __m128d B)
+{
+    __m128d Sum = _mm_add_pd(A, B);
+    __m128d BVirtual = _mm_sub_pd(Sum, A);
+    __m128d AVirtual = _mm_sub_pd(Sum, BVirtual);
+    return (ddouble2) { Sum, _mm_add_pd(_mm_sub_pd(A, AVirtual), _mm_sub_pd(B, BVirtual)) };
+}
+
+/* no FMA, Dekker's split like the scalar kernel */
+KERNEL_TARGET("sse2")
+static inline ddouble2 Kernel_Sse2TwoProd(__m128d A, __m128d B)
+{
+    __m128d Splitter = _mm_set1_pd(134217729.0);
+    __m128d Product = _mm_mul_pd(A, B);
+    __m128d Ta = _mm_mul_pd(Splitter, A);
+    __m128d AHi = _mm_sub_pd(Ta, _mm_sub_pd(Ta, A));
+    __m128d ALo = _mm_sub_pd(A, AHi);
+    __m128d Tb = _mm_mul_pd(Splitter, B);
+    __m128d BHi = _mm_sub_pd(Tb, _mm_sub_pd(Tb, B));
+    __m128d BLo = _mm_sub_pd(B, BHi);
+    __m128d Error = _mm_sub_pd(_mm_mul_pd(AHi, BHi), Product);
+    Error = _mm_add_pd(_mm_add_pd(_mm_add_pd(Error, _mm_mul_pd(AHi, BLo)), _mm_mul_pd(ALo, BHi)), _mm_mul_pd(ALo, BLo));
+    return (ddouble2) { Product, Error };
+}
+
+KERNEL_TARGET("sse2")
+static inline ddouble2 Kernel_Sse2DDAdd(ddouble2 A, ddouble2 B)
+{
+    ddouble2 S = Kernel_Sse2TwoSum(A.Hi, B.Hi);
+    ddouble2 T = Kernel_Sse2TwoSum(A.Lo, B.Lo);
+    S = Kernel_Sse2QuickTwoSum(S.Hi, _mm_add_pd(S.Lo, T.Hi));
+    return Kernel_Sse2QuickTwoSum(S.Hi, _mm_add_pd(S.Lo, T.Lo));
+}
+
+KERNEL_TARGET("sse2")
+static inline ddouble2 Kernel_Sse2DDMul(ddouble2 A, ddouble2 B)
+{
+    ddouble2 P = Kernel_Sse2TwoProd(A.Hi, B.Hi);
+    __m128d Cross = _mm_add_pd(_mm_mul_pd(A.Hi, B.Lo), _mm_mul_pd(A.Lo, B.Hi));
+    return Kernel_Sse2QuickTwoSum(P.Hi, _mm_add_pd(P.Lo, Cross));
+}
+
+KERNEL_TARGET("sse2")
+static inline ddouble2 Kernel_Sse2DDSqr(ddouble2 A)
+{
+    ddouble2 P = Kernel_Sse2TwoProd(A.Hi, A.Hi);
+    __m128d Cross = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(2.0), A.Hi), A.Lo);
+    return Kernel_Sse2QuickTwoSum(P.Hi, _mm_add_pd(P.Lo, Cross));
+}
+
+/* the vectors of Kernel_Sse2DoubleDouble() */
+typedef struct kernel_sse2_double_double
+{
+    __m128d Active;
+    ddouble2 Cx, Cy;
+    ddouble2 Zx, Zy;
+    __m128i Counts; /* 64-bit, to line up with the doubles */
+} kernel_sse2_double_double;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("sse2")
+static KERNEL_INLINE void Kernel_Sse2DoubleDoubleRun(const render_view *View, kernel_sse2_double_double *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m128d Four = _mm_set1_pd(4.0);
+    __m128d Two = _mm_set1_pd(2.0);
+    __m128d SignBit = _mm_set1_pd(-0.0);
+    __m128d Active = V->Active;
+    ddouble2 Cx = V->Cx, Cy = V->Cy;
+    ddouble2 Zx = V->Zx, Zy = V->Zy;
+    __m128i Counts = V->Counts;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        ddouble2 Zx2 = Kernel_Sse2DDSqr(Zx);
+        ddouble2 Zy2 = Kernel_Sse2DDSqr(Zy);
+        Active = _mm_and_pd(Active, _mm_cmplt_pd(_mm_add_pd(Zx2.Hi, Zy2.Hi), Four));
+        if (Kernel_Sse2ShouldStop(_mm_movemask_pd(Active), 2, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm_sub_epi64(Counts, _mm_castpd_si128(Active));
+
+        ddouble2 MinusZy2 = { _mm_xor_pd(Zy2.Hi, SignBit), _mm_xor_pd(Zy2.Lo, SignBit) };
+        ddouble2 Tmp = Kernel_Sse2DDAdd(Kernel_Sse2DDAdd(Zx2, MinusZy2), Cx);
+        ddouble2 ZxZy = Kernel_Sse2DDMul(Zx, Zy);
+        ddouble2 TwoZxZy = { _mm_mul_pd(Two, ZxZy.Hi), _mm_mul_pd(Two, ZxZy.Lo) };
+        Zy = Kernel_Sse2DDAdd(TwoZxZy, Cy);
+        Zx = Tmp;
+    }
+    V->Active = _mm_and_pd(Active, _mm_castsi128_pd(Kernel_Sse2CountsLess(Counts, _mm_set1_epi64x(View->IterationCount))));
+    V->Zx = Zx;
+    V->Zy = Zy;
+    V->Counts = Counts;
+}
+
+KERNEL_TARGET("sse2")
+static void Kernel_Sse2DoubleDouble(const render_view *View, kernel_row *Row)
+{
+    ddouble Left = DD_FromBigFix(&View->ExactWorldLeft);
+    ddouble Bottom = DD_FromBigFix(&View->ExactWorldBottom);
+    ddouble2 LeftLanes = { _mm_set1_pd(Left.Hi), _mm_set1_pd(Left.Lo) };
+    ddouble2 BottomLanes = { _mm_set1_pd(Bottom.Hi), _mm_set1_pd(Bottom.Lo) };
+    __m128d Scale = _mm_set1_pd(View->ScreenToWorldScaleFactor);
+    __m128i ColumnMask = _mm_set1_epi32(Row->IsColumn? -1 : 0);
+    __m128i LaneX = _mm_andnot_si128(ColumnMask, _mm_setr_epi32(0, 1, 0, 0));
+    __m128i LaneY = _mm_and_si128(ColumnMask, _mm_setr_epi32(0, 1, 0, 0));
+    __m128i IterationCount = _mm_set1_epi64x(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 2, RENDER_PRECISION_DOUBLE_DOUBLE);
+    kernel_sse2_double_double V;
+    for (int x = 0; x < Row->Count; x += 2)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m128d PixelX = _mm_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartX), LaneX));
+        __m128d PixelY = _mm_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartY), LaneY));
+        V.Cx = Kernel_Sse2DDAdd(LeftLanes, Kernel_Sse2TwoProd(_mm_add_pd(PixelX, _mm_set1_pd(0.5)), Scale));
+        V.Cy = Kernel_Sse2DDAdd(BottomLanes, Kernel_Sse2TwoProd(_mm_add_pd(PixelY, _mm_set1_pd(0.5)), Scale));
+        V.Zx = (ddouble2) { _mm_loadu_pd(Row->Zx + x), _mm_loadu_pd(Row->ZxLo + x) };
+        V.Zy = (ddouble2) { _mm_loadu_pd(Row->Zy + x), _mm_loadu_pd(Row->ZyLo + x) };
+        V.Counts = Kernel_Sse2LoadCounts(Row->Iterations + x);
+        V.Active = _mm_castsi128_pd(Kernel_Sse2CountsEqual(V.Counts, _mm_set1_epi64x(Row->StartIteration)));
+        if (View->SkipsInterior)
+        {
+            __m128d Interior = _mm_and_pd(V.Active, Kernel_Sse2IsInteriorPd(V.Cx.Hi, V.Cy.Hi));
+            V.Counts = Kernel_Sse2Select(_mm_castpd_si128(Interior), V.Counts, IterationCount);
+            V.Active = _mm_andnot_pd(Interior, V.Active);
+            int InteriorCount = __builtin_popcount(_mm_movemask_pd(Interior));
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (_mm_movemask_pd(V.Active))
+        {
+            Kernel_Sse2DoubleDoubleRun(View, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        Kernel_Sse2StoreCounts(Row->Iterations + x, V.Counts);
+        _mm_storeu_pd(Row->Zx + x, V.Zx.Hi);
+        _mm_storeu_pd(Row->ZxLo + x, V.Zx.Lo);
+        _mm_storeu_pd(Row->Zy + x, V.Zy.Hi);
+        _mm_storeu_pd(Row->ZyLo + x, V.Zy.Lo);
+        int Survivors = _mm_movemask_pd(V.Active);
+        if (Survivors)
+        {
+            double Cx[2], Cy[2], CxLo[2], CyLo[2];
+            _mm_storeu_pd(Cx, V.Cx.Hi);
+            _mm_storeu_pd(Cy, V.Cy.Hi);
+            _mm_storeu_pd(CxLo, V.Cx.Lo);
+            _mm_storeu_pd(CyLo, V.Cy.Lo);
+            Kernel_ListLanes(&Lanes, x, Survivors, Cx, Cy, CxLo, CyLo);
+        }
+    }
+
+    u32 ActiveLanes = Kernel_BeginList(&Lanes, View, Row);
+    while (ActiveLanes)
+    {
+        V.Cx = (ddouble2) { _mm_loadu_pd(Lanes.Cx), _mm_loadu_pd(Lanes.CxLo) };
+        V.Cy = (ddouble2) { _mm_loadu_pd(Lanes.Cy), _mm_loadu_pd(Lanes.CyLo) };
+        V.Zx = (ddouble2) { _mm_loadu_pd(Lanes.Zx), _mm_loadu_pd(Lanes.ZxLo) };
+        V.Zy = (ddouble2) { _mm_loadu_pd(Lanes.Zy), _mm_loadu_pd(Lanes.ZyLo) };
+        V.Counts = Kernel_Sse2LoadCounts(Lanes.Iterations);
+        V.Active = _mm_castsi128_pd(Kernel_Sse2CountsLess(V.Counts, IterationCount));
+        Kernel_Sse2DoubleDoubleRun(View, &V, Kernel_GetLaneStepCount(&Lanes, View, ActiveLanes), Kernel_GetRefillCount(&Lanes), false);
+        Kernel_Sse2StoreCounts(Lanes.Iterations, V.Counts);
+        _mm_storeu_pd(Lanes.Zx, V.Zx.Hi);
+        _mm_storeu_pd(Lanes.ZxLo, V.Zx.Lo);
+        _mm_storeu_pd(Lanes.Zy, V.Zy.Hi);
+        _mm_storeu_pd(Lanes.ZyLo, V.Zy.Lo);
+        ActiveLanes = Kernel_RefillLanes(&Lanes, View, Row, _mm_movemask_pd(V.Active));
+    }
+}
+
+
+KERNEL_TARGET("avx2,popcnt")
+static __m256 Kernel_Avx2IsInteriorPs(__m256 Cx, __m256 Cy)
+{
+    __m256 Xq = _mm256_sub_ps(Cx, _mm256_set1_ps(0.25f));
+    __m256 Y2 = _mm256_mul_ps(Cy, Cy);
+    __m256 q = _mm256_add_ps(_mm256_mul_ps(Xq, Xq), Y2);
+    __m256 Xb = _mm256_add_ps(Cx, _mm256_set1_ps(1.0f));
+    __m256 Cardioid = _mm256_cmp_ps(_mm256_mul_ps(q, _mm256_add_ps(q, Xq)), _mm256_mul_ps(_mm256_set1_ps(0.25f), Y2), _CMP_LE_OQ);
+    __m256 Bulb = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(Xb, Xb), Y2), _mm256_set1_ps(0.0625f), _CMP_LE_OQ);
+    return _mm256_or_ps(Cardioid, Bulb);
+}
+
+KERNEL_TARGET("avx2,popcnt")
+static __m256d Kernel_Avx2IsInteriorPd(__m256d Cx, __m256d Cy)
+{
+    __m256d Xq = _mm256_sub_pd(Cx, _mm256_set1_pd(0.25));
+    __m256d Y2 = _mm256_mul_pd(Cy, Cy);
+    __m256d q = _mm256_add_pd(_mm256_mul_pd(Xq, Xq), Y2);
+    __m256d Xb = _mm256_add_pd(Cx, _mm256_set1_pd(1.0));
+    __m256d Cardioid = _mm256_cmp_pd(_mm256_mul_pd(q, _mm256_add_pd(q, Xq)), _mm256_mul_pd(_mm256_set1_pd(0.25), Y2), _CMP_LE_OQ);
+    __m256d Bulb = _mm256_cmp_pd(_mm256_add_pd(_mm256_mul_pd(Xb, Xb), Y2), _mm256_set1_pd(0.0625), _CMP_LE_OQ);
+    return _mm256_or_pd(Cardioid, Bulb);
+}
+
+/* 8 floats from and to the doubles of a row or the lanes */
+KERNEL_TARGET("avx2,popcnt")
+static __m256 Kernel_Avx2LoadFloats(const double *Values)
+{
+    return _mm256_set_m128(_mm256_cvtpd_ps(_mm256_loadu_pd(Values + 4)), _mm256_cvtpd_ps(_mm256_loadu_pd(Values)));
+}
+
+KERNEL_TARGET("avx2,popcnt")
+static void Kernel_Avx2StoreFloats(double *Values, __m256 Floats)
+{
+    _mm256_storeu_pd(Values, _mm256_cvtps_pd(_mm256_castps256_ps128(Floats)));
+    _mm256_storeu_pd(Values + 4, _mm256_cvtps_pd(_mm256_extractf128_ps(Floats, 1)));
+}
+
+/* 4 counts from and to 64-bit lanes, to line up with the doubles */
+KERNEL_TARGET("avx2,popcnt")
+static __m256i Kernel_Avx2LoadCounts(const u32 *Counts)
+{
+    return _mm256_cvtepu32_epi64(_mm_loadu_si128((const __m128i *)Counts));
+}
+
+KERNEL_TARGET("avx2,popcnt")
+static void Kernel_Avx2StoreCounts(u32 *Counts, __m256i Lanes)
+{
+    /* gather the low half of every 64-bit count */
+    __m256i Packed = _mm256_permutevar8x32_epi32(Lanes, _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0));
+    _mm_storeu_si128((__m128i *)Counts, _mm256_castsi256_si128(Packed));
+}
+
+/* the vectors of Kernel_Avx2Float() */
+typedef struct kernel_avx2_float
+{
+    __m256 Active;
+    __m256 Cx, Cy;
+    __m256 Zx, Zy;
+    __m256 SavedZx, SavedZy;
+    __m256i Counts, SaveAt;
+} kernel_avx2_float;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("avx2,popcnt")
+static KERNEL_INLINE void Kernel_Avx2FloatRun(const render_view *View, kernel_row *Row, kernel_avx2_float *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m256 Four = _mm256_set1_ps(4.0f);
+    __m256 Two = _mm256_set1_ps(2.0f);
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    __m256 Tolerance = _mm256_set1_ps(View->PeriodicityTolerance * FLT_EPSILON);
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+    __m256i IterationCount = _mm256_set1_epi32(View->IterationCount);
+    __m256 Active = V->Active;
+    __m256 Cx = V->Cx, Cy = V->Cy;
+    __m256 Zx = V->Zx, Zy = V->Zy;
+    __m256 SavedZx = V->SavedZx, SavedZy = V->SavedZy;
+    __m256i Counts = V->Counts, SaveAt = V->SaveAt;
+    /* lanes caught in a cycle keep the z they were caught at, the others step on after they are off */
+    __m256 Caught = _mm256_setzero_ps();
+    __m256 CaughtZx = Zx, CaughtZy = Zy;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        __m256 Zx2 = _mm256_mul_ps(Zx, Zx);
+        __m256 Zy2 = _mm256_mul_ps(Zy, Zy);
+        Active = _mm256_and_ps(Active, _mm256_cmp_ps(_mm256_add_ps(Zx2, Zy2), Four, _CMP_LT_OQ));
+        if (Kernel_ShouldStop(_mm256_movemask_ps(Active), 8, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm256_sub_epi32(Counts, _mm256_castps_si256(Active));
+
+        __m256 Tmp = _mm256_add_ps(_mm256_sub_ps(Zx2, Zy2), Cx);
+        Zy = _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(Two, Zy), Zx), Cy);
+        Zx = Tmp;
+        if (ChecksPeriodicity)
+        {
+            __m256 CloseX = _mm256_cmp_ps(_mm256_andnot_ps(SignBit, _mm256_sub_ps(Zx, SavedZx)), Tolerance, _CMP_LT_OQ);
+            __m256 CloseY = _mm256_cmp_ps(_mm256_andnot_ps(SignBit, _mm256_sub_ps(Zy, SavedZy)), Tolerance, _CMP_LT_OQ);
+            __m256 Periodic = _mm256_and_ps(Active, _mm256_and_ps(CloseX, CloseY));
+            int PeriodicLanes = _mm256_movemask_ps(Periodic);
+            if (PeriodicLanes)
+            {
+                u32 LaneCounts[8];
+                _mm256_storeu_si256((__m256i *)LaneCounts, Counts);
+                Kernel_SkipPeriodicLanes(View, Row, LaneCounts, PeriodicLanes);
+                Counts = _mm256_blendv_epi8(Counts, IterationCount, _mm256_castps_si256(Periodic));
+                CaughtZx = _mm256_blendv_ps(CaughtZx, Zx, Periodic);
+                CaughtZy = _mm256_blendv_ps(CaughtZy, Zy, Periodic);
+                Caught = _mm256_or_ps(Caught, Periodic);
+                Active = _mm256_andnot_ps(Periodic, Active);
+            }
+            __m256 Saves = IsBlock? Active : _mm256_and_ps(Active, _mm256_castsi256_ps(_mm256_cmpeq_epi32(Counts, SaveAt)));
+            if (IsBlock? KERNEL_SAVES_Z_AFTER(Row->StartIteration + Step) : _mm256_movemask_ps(Saves))
+            {
+                SavedZx = _mm256_blendv_ps(SavedZx, Zx, Saves);
+                SavedZy = _mm256_blendv_ps(SavedZy, Zy, Saves);
+                SaveAt = _mm256_add_epi32(SaveAt, _mm256_and_si256(_mm256_castps_si256(Saves), SaveAt));
+            }
+        }
+    }
+    V->Active = _mm256_and_ps(Active, _mm256_castsi256_ps(_mm256_cmpgt_epi32(IterationCount, Counts)));
+    V->Zx = _mm256_blendv_ps(Zx, CaughtZx, Caught);
+    V->Zy = _mm256_blendv_ps(Zy, CaughtZy, Caught);
+    V->SavedZx = SavedZx;
+    V->SavedZy = SavedZy;
+    V->Counts = Counts;
+    V->SaveAt = SaveAt;
+}
+
+KERNEL_TARGET("avx2,popcnt")
+static void Kernel_Avx2Float(const render_view *View, kernel_row *Row)
+{
+    float Scale = View->ScreenToWorldScaleFactor;
+    float Left = View->WorldLeft;
+    float Bottom = View->WorldBottom;
+    __m256i LaneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i ColumnMask = _mm256_set1_epi32(Row->IsColumn? -1 : 0);
+    __m256i LaneX = _mm256_andnot_si256(ColumnMask, LaneIndex);
+    __m256i LaneY = _mm256_and_si256(ColumnMask, LaneIndex);
+    __m256i IterationCount = _mm256_set1_epi32(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 8, RENDER_PRECISION_FLOAT);
+    kernel_avx2_float V;
+    for (int x = 0; x < Row->Count; x += 8)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m256 PixelX = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(StartX), LaneX));
+        __m256 PixelY = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(StartY), LaneY));
+        V.Cx = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(PixelX, _mm256_set1_ps(0.5f)), _mm256_set1_ps(Scale)), _mm256_set1_ps(Left));
+        V.Cy = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(PixelY, _mm256_set1_ps(0.5f)), _mm256_set1_ps(Scale)), _mm256_set1_ps(Bottom));
+        V.Zx = Kernel_Avx2LoadFloats(Row->Zx + x);
+        V.Zy = Kernel_Avx2LoadFloats(Row->Zy + x);
+        V.SavedZx = Kernel_Avx2LoadFloats(Row->SavedZx + x);
+        V.SavedZy = Kernel_Avx2LoadFloats(Row->SavedZy + x);
+        V.Counts = _mm256_loadu_si256((__m256i *)(Row->Iterations + x));
+        V.SaveAt = _mm256_set1_epi32(Kernel_GetSaveAt(Row->StartIteration));
+        V.Active = _mm256_castsi256_ps(_mm256_cmpeq_epi32(V.Counts, _mm256_set1_epi32(Row->StartIteration)));
+        if (View->SkipsInterior)
+        {
+            __m256 Interior = _mm256_and_ps(V.Active, Kernel_Avx2IsInteriorPs(V.Cx, V.Cy));
+            V.Counts = _mm256_blendv_epi8(V.Counts, IterationCount, _mm256_castps_si256(Interior));
+            V.Active = _mm256_andnot_ps(Interior, V.Active);
+            int InteriorCount = __builtin_popcount(_mm256_movemask_ps(Interior));
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (_mm256_movemask_ps(V.Active))
+        {
+            Kernel_Avx2FloatRun(View, Row, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        _mm256_storeu_si256((__m256i *)(Row->Iterations + x), V.Counts);
+        Kernel_Avx2StoreFloats(Row->Zx + x, V.Zx);
+        Kernel_Avx2StoreFloats(Row->Zy + x, V.Zy);
+        Kernel_Avx2StoreFloats(Row->SavedZx + x, V.SavedZx);
+        Kernel_Avx2StoreFloats(Row->SavedZy + x, V.SavedZy);
+        int Survivors = _mm256_movemask_ps(V.Active);
+        if (Survivors)
+        {
+            double Cx[8], Cy[8];
+            Kernel_Avx2StoreFloats(Cx, V.Cx);
+            Kernel_Avx2StoreFloats(Cy, V.Cy);
+            Kernel_ListLanes(&Lanes, x, Survivors, Cx, Cy, NULL, NULL);
+        }
+    }
+
+    u32 ActiveLanes = Kernel_BeginList(&Lanes, View, Row);
+    while (ActiveLanes)
+    {
+        V.Cx = Kernel_Avx2LoadFloats(Lanes.Cx);
+        V.Cy = Kernel_Avx2LoadFloats(Lanes.Cy);
+        V.Zx = Kernel_Avx2LoadFloats(Lanes.Zx);
+        V.Zy = Kernel_Avx2LoadFloats(Lanes.Zy);
+        V.SavedZx = Kernel_Avx2LoadFloats(Lanes.SavedZx);
+        V.SavedZy = Kernel_Avx2LoadFloats(Lanes.SavedZy);
+        V.Counts = _mm256_loadu_si256((__m256i *)Lanes.Iterations);
+        V.SaveAt = _mm256_loadu_si256((__m256i *)Lanes.SaveAt);
+        V.Active = _mm256_castsi256_ps(_mm256_cmpgt_epi32(IterationCount, V.Counts));
+        Kernel_Avx2FloatRun(View, Row, &V, Kernel_GetLaneStepCount(&Lanes, View, ActiveLanes), Kernel_GetRefillCount(&Lanes), false);
+        _mm256_storeu_si256((__m256i *)Lanes.Iterations, V.Counts);
+        _mm256_storeu_si256((__m256i *)Lanes.SaveAt, V.SaveAt);
+        Kernel_Avx2StoreFloats(Lanes.Zx, V.Zx);
+        Kernel_Avx2StoreFloats(Lanes.Zy, V.Zy);
+        Kernel_Avx2StoreFloats(Lanes.SavedZx, V.SavedZx);
+        Kernel_Avx2StoreFloats(Lanes.SavedZy, V.SavedZy);
+        ActiveLanes = Kernel_RefillLanes(&Lanes, View, Row, _mm256_movemask_ps(V.Active));
+    }
+}
+
+/* the vectors of Kernel_Avx2Double() */
+typedef struct kernel_avx2_double
+{
+    __m256d Active;
+    __m256d Cx, Cy;
+    __m256d Zx, Zy;
+    __m256d SavedZx, SavedZy;
+    __m256i Counts, SaveAt; /* 64-bit, to line up with the doubles */
+} kernel_avx2_double;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("avx2,popcnt")
+static KERNEL_INLINE void Kernel_Avx2DoubleRun(const render_view *View, kernel_row *Row, kernel_avx2_double *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m256d Four = _mm256_set1_pd(4.0);
+    __m256d Two = _mm256_set1_pd(2.0);
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    __m256d Tolerance = _mm256_set1_pd(View->PeriodicityTolerance * DBL_EPSILON);
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256i IterationCount = _mm256_set1_epi64x(View->IterationCount);
+    __m256d Active = V->Active;
+    __m256d Cx = V->Cx, Cy = V->Cy;
+    __m256d Zx = V->Zx, Zy = V->Zy;
+    __m256d SavedZx = V->SavedZx, SavedZy = V->SavedZy;
+    __m256i Counts = V->Counts, SaveAt = V->SaveAt;
+    /* lanes caught in a cycle keep the z they were caught at, the others step on after they are off */
+    __m256d Caught = _mm256_setzero_pd();
+    __m256d CaughtZx = Zx, CaughtZy = Zy;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        __m256d Zx2 = _mm256_mul_pd(Zx, Zx);
+        __m256d Zy2 = _mm256_mul_pd(Zy, Zy);
+        Active = _mm256_and_pd(Active, _mm256_cmp_pd(_mm256_add_pd(Zx2, Zy2), Four, _CMP_LT_OQ));
+        if (Kernel_ShouldStop(_mm256_movemask_pd(Active), 4, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm256_sub_epi64(Counts, _mm256_castpd_si256(Active));
+
+        __m256d Tmp = _mm256_add_pd(_mm256_sub_pd(Zx2, Zy2), Cx);
+        Zy = _mm256_add_pd(_mm256_mul_pd(_mm256_mul_pd(Two, Zy), Zx), Cy);
+        Zx = Tmp;
+        if (ChecksPeriodicity)
+        {
+            __m256d CloseX = _mm256_cmp_pd(_mm256_andnot_pd(SignBit, _mm256_sub_pd(Zx, SavedZx)), Tolerance, _CMP_LT_OQ);
+            __m256d CloseY = _mm256_cmp_pd(_mm256_andnot_pd(SignBit, _mm256_sub_pd(Zy, SavedZy)), Tolerance, _CMP_LT_OQ);
+            __m256d Periodic = _mm256_and_pd(Active, _mm256_and_pd(CloseX, CloseY));
+            int PeriodicLanes = _mm256_movemask_pd(Periodic);
+            if (PeriodicLanes)
+            {
+                u32 LaneCounts[4];
+                Kernel_Avx2StoreCounts(LaneCounts, Counts);
+                Kernel_SkipPeriodicLanes(View, Row, LaneCounts, PeriodicLanes);
+                Counts = _mm256_blendv_epi8(Counts, IterationCount, _mm256_castpd_si256(Periodic));
+                CaughtZx = _mm256_blendv_pd(CaughtZx, Zx, Periodic);
+                CaughtZy = _mm256_blendv_pd(CaughtZy, Zy, Periodic);
+                Caught = _mm256_or_pd(Caught, Periodic);
+                Active = _mm256_andnot_pd(Periodic, Active);
+            }
+            __m256d Saves = IsBlock? Active : _mm256_and_pd(Active, _mm256_castsi256_pd(_mm256_cmpeq_epi64(Counts, SaveAt)));
+            if (IsBlock? KERNEL_SAVES_Z_AFTER(Row->StartIteration + Step) : _mm256_movemask_pd(Saves))
+            {
+                SavedZx = _mm256_blendv_pd(SavedZx, Zx, Saves);
+                SavedZy = _mm256_blendv_pd(SavedZy, Zy, Saves);
+                SaveAt = _mm256_add_epi64(SaveAt, _mm256_and_si256(_mm256_castpd_si256(Saves), SaveAt));
+            }
+        }
+    }
+    V->Active = _mm256_and_pd(Active, _mm256_castsi256_pd(_mm256_cmpgt_epi64(IterationCount, Counts)));
+    V->Zx = _mm256_blendv_pd(Zx, CaughtZx, Caught);
+    V->Zy = _mm256_blendv_pd(Zy, CaughtZy, Caught);
+    V->SavedZx = SavedZx;
+    V->SavedZy = SavedZy;
+    V->Counts = Counts;
+    V->SaveAt = SaveAt;
+}
+
+KERNEL_TARGET("avx2,popcnt")
+static void Kernel_Avx2Double(const render_view *View, kernel_row *Row)
+{
+    double Scale = View->ScreenToWorldScaleFactor;
+    __m128i ColumnMask = _mm_set1_epi32(Row->IsColumn? -1 : 0);
+    __m128i LaneX = _mm_andnot_si128(ColumnMask, _mm_setr_epi32(0, 1, 2, 3));
+    __m128i LaneY = _mm_and_si128(ColumnMask, _mm_setr_epi32(0, 1, 2, 3));
+    __m256i IterationCount = _mm256_set1_epi64x(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 4, RENDER_PRECISION_DOUBLE);
+    kernel_avx2_double V;
+    for (int x = 0; x < Row->Count; x += 4)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m256d PixelX = _mm256_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartX), LaneX));
+        __m256d PixelY = _mm256_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartY), LaneY));
+        V.Cx = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(PixelX, _mm256_set1_pd(0.5)), _mm256_set1_pd(Scale)), _mm256_set1_pd(View->WorldLeft));
+        V.Cy = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(PixelY, _mm256_set1_pd(0.5)), _mm256_set1_pd(Scale)), _mm256_set1_pd(View->WorldBottom));
+        V.Zx = _mm256_loadu_pd(Row->Zx + x);
+        V.Zy = _mm256_loadu_pd(Row->Zy + x);
+        V.SavedZx = _mm256_loadu_pd(Row->SavedZx + x);
+        V.SavedZy = _mm256_loadu_pd(Row->SavedZy + x);
+        V.Counts = Kernel_Avx2LoadCounts(Row->Iterations + x);
+        V.SaveAt = _mm256_set1_epi64x(Kernel_GetSaveAt(Row->StartIteration));
+        V.Active = _mm256_castsi256_pd(_mm256_cmpeq_epi64(V.Counts, _mm256_set1_epi64x(Row->StartIteration)));
+        if (View->SkipsInterior)
+        {
+            __m256d Interior = _mm256_and_pd(V.Active, Kernel_Avx2IsInteriorPd(V.Cx, V.Cy));
+            V.Counts = _mm256_blendv_epi8(V.Counts, IterationCount, _mm256_castpd_si256(Interior));
+            V.Active = _mm256_andnot_pd(Interior, V.Active);
+            int InteriorCount = __builtin_popcount(_mm256_movemask_pd(Interior));
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (_mm256_movemask_pd(V.Active))
+        {
+            Kernel_Avx2DoubleRun(View, Row, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        Kernel_Avx2StoreCounts(Row->Iterations + x, V.Counts);
+        _mm256_storeu_pd(Row->Zx + x, V.Zx);
+        _mm256_storeu_pd(Row->Zy + x, V.Zy);
+        _mm256_storeu_pd(Row->SavedZx + x, V.SavedZx);
+        _mm256_storeu_pd(Row->SavedZy + x, V.SavedZy);
+        int Survivors = _mm256_movemask_pd(V.Active);
+        if (Survivors)
+        {
+            double Cx[4], Cy[4];
+            _mm256_storeu_pd(Cx, V.Cx);
+            _mm256_storeu_pd(Cy, V.Cy);
+            Kernel_ListLanes(&Lanes, x, Survivors, Cx, Cy, NULL, NULL);
+        }
+    }
+
+    u32 ActiveLanes = Kernel_BeginList(&Lanes, View, Row);
+    while (ActiveLanes)
+    {
+        V.Cx = _mm256_loadu_pd(Lanes.Cx);
+        V.Cy = _mm256_loadu_pd(Lanes.Cy);
+        V.Zx = _mm256_loadu_pd(Lanes.Zx);
+        V.Zy = _mm256_loadu_pd(Lanes.Zy);
+        V.SavedZx = _mm256_loadu_pd(Lanes.SavedZx);
+        V.SavedZy = _mm256_loadu_pd(Lanes.SavedZy);
+        V.Counts = Kernel_Avx2LoadCounts(Lanes.Iterations);
+        V.SaveAt = Kernel_Avx2LoadCounts(Lanes.SaveAt);
+        V.Active = _mm256_castsi256_pd(_mm256_cmpgt_epi64(IterationCount, V.Counts));
+        Kernel_Avx2DoubleRun(View, Row, &V, Kernel_GetLaneStepCount(&Lanes, View, ActiveLanes), Kernel_GetRefillCount(&Lanes), false);
+        Kernel_Avx2StoreCounts(Lanes.Iterations, V.Counts);
+        Kernel_Avx2StoreCounts(Lanes.SaveAt, V.SaveAt);
+        _mm256_storeu_pd(Lanes.Zx, V.Zx);
+        _mm256_storeu_pd(Lanes.Zy, V.Zy);
+        _mm256_storeu_pd(Lanes.SavedZx, V.SavedZx);
+        _mm256_storeu_pd(Lanes.SavedZy, V.SavedZy);
+        ActiveLanes = Kernel_RefillLanes(&Lanes, View, Row, _mm256_movemask_pd(V.Active));
+    }
+}
+
+
+typedef struct ddouble4
+{
+    __m256d Hi, Lo;
+} ddouble4;
+
+KERNEL_TARGET("avx2,fma,popcnt")
+static inline ddouble4 Kernel_Avx2QuickTwoSum(__m256d A, __m256d B)
+{
+    __m256d Sum = _mm256_add_pd(A, B);
+    return (ddouble4) { Sum, _mm256_sub_pd(B, _mm256_sub_pd(Sum, A)) };
+}
+
+KERNEL_TARGET("avx2,fma,popcnt")
+static inline ddouble4 Kernel_Avx2TwoSum(__m256d A, __m256d B)
+{
+    __m256d Sum = _mm256_add_pd(A, B);
+    __m256d BVirtual = _mm256_sub_pd(Sum, A);
+    __m256d AVirtual = _mm256_sub_pd(Sum, BVirtual);
+    return (ddouble4) { Sum, _mm256_add_pd(_mm256_sub_pd(A, AVirtual), _mm256_sub_pd(B, BVirtual)) };
+}
+
+/* 
+    FMA rounds A*B - Product once, and it is exact, 
+    so this is the very same error Dekker's split gets to in seven more operations 
+*/
+KERNEL_TARGET("avx2,fma,popcnt")
+static inline ddouble4 Kernel_Avx2TwoProd(__m256d A, __m256d B)
+{
+    __m256d Product = _mm256_mul_pd(A, B);
+    return (ddouble4) { Product, _mm256_fmsub_pd(A, B, Product) };
+}
+
+KERNEL_TARGET("avx2,fma,popcnt")
+static inline ddouble4 Kernel_Avx2DDAdd(ddouble4 A, ddouble4 B)
+{
+    ddouble4 S = Kernel_Avx2TwoSum(A.Hi, B.Hi);
+    ddouble4 T = Kernel_Avx2TwoSum(A.Lo, B.Lo);
+    S = Kernel_Avx2QuickTwoSum(S.Hi, _mm256_add_pd(S.Lo, T.Hi));
+    return Kernel_Avx2QuickTwoSum(S.Hi, _mm256_add_pd(S.Lo, T.Lo));
+}
+
+KERNEL_TARGET("avx2,fma,popcnt")
+static inline ddouble4 Kernel_Avx2DDMul(ddouble4 A, ddouble4 B)
+{
+    ddouble4 P = Kernel_Avx2TwoProd(A.Hi, B.Hi);
+    __m256d Cross = _mm256_add_pd(_mm256_mul_pd(A.Hi, B.Lo), _mm256_mul_pd(A.Lo, B.Hi));
+    return Kernel_Avx2QuickTwoSum(P.Hi, _mm256_add_pd(P.Lo, Cross));
+}
+
+KERNEL_TARGET("avx2,fma,popcnt")
+static inline ddouble4 Kernel_Avx2DDSqr(ddouble4 A)
+{
+    ddouble4 P = Kernel_Avx2TwoProd(A.Hi, A.Hi);
+    __m256d Cross = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), A.Hi), A.Lo);
+    return Kernel_Avx2QuickTwoSum(P.Hi, _mm256_add_pd(P.Lo, Cross));
+}
+
+/* the vectors of Kernel_Avx2DoubleDouble() */
+typedef struct kernel_avx2_double_double
+{
+    __m256d Active;
+    ddouble4 Cx, Cy;
+    ddouble4 Zx, Zy;
+    __m256i Counts; /* 64-bit, to line up with the doubles */
+} kernel_avx2_double_double;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("avx2,fma,popcnt")
+static KERNEL_INLINE void Kernel_Avx2DoubleDoubleRun(const render_view *View, kernel_avx2_double_double *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m256d Four = _mm256_set1_pd(4.0);
+    __m256d Two = _mm256_set1_pd(2.0);
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256d Active = V->Active;
+    ddouble4 Cx = V->Cx, Cy = V->Cy;
+    ddouble4 Zx = V->Zx, Zy = V->Zy;
+    __m256i Counts = V->Counts;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        ddouble4 Zx2 = Kernel_Avx2DDSqr(Zx);
+        ddouble4 Zy2 = Kernel_Avx2DDSqr(Zy);
+        Active = _mm256_and_pd(Active, _mm256_cmp_pd(_mm256_add_pd(Zx2.Hi, Zy2.Hi), Four, _CMP_LT_OQ));
+        if (Kernel_ShouldStop(_mm256_movemask_pd(Active), 4, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm256_sub_epi64(Counts, _mm256_castpd_si256(Active));
+
+        ddouble4 MinusZy2 = { _mm256_xor_pd(Zy2.Hi, SignBit), _mm256_xor_pd(Zy2.Lo, SignBit) };
+        ddouble4 Tmp = Kernel_Avx2DDAdd(Kernel_Avx2DDAdd(Zx2, MinusZy2), Cx);
+        ddouble4 ZxZy = Kernel_Avx2DDMul(Zx, Zy);
+        ddouble4 TwoZxZy = { _mm256_mul_pd(Two, ZxZy.Hi), _mm256_mul_pd(Two, ZxZy.Lo) };
+        Zy = Kernel_Avx2DDAdd(TwoZxZy, Cy);
+        Zx = Tmp;
+    }
+    V->Active = _mm256_and_pd(Active, _mm256_castsi256_pd(_mm256_cmpgt_epi64(_mm256_set1_epi64x(View->IterationCount), Counts)));
+    V->Zx = Zx;
+    V->Zy = Zy;
+    V->Counts = Counts;
+}
+
+KERNEL_TARGET("avx2,fma,popcnt")
+static void Kernel_Avx2DoubleDouble(const render_view *View, kernel_row *Row)
+{
+    ddouble Left = DD_FromBigFix(&View->ExactWorldLeft);
+    ddouble Bottom = DD_FromBigFix(&View->ExactWorldBottom);
+    ddouble4 LeftLanes = { _mm256_set1_pd(Left.Hi), _mm256_set1_pd(Left.Lo) };
+    ddouble4 BottomLanes = { _mm256_set1_pd(Bottom.Hi), _mm256_set1_pd(Bottom.Lo) };
+    __m256d Scale = _mm256_set1_pd(View->ScreenToWorldScaleFactor);
+    __m128i ColumnMask = _mm_set1_epi32(Row->IsColumn? -1 : 0);
+    __m128i LaneX = _mm_andnot_si128(ColumnMask, _mm_setr_epi32(0, 1, 2, 3));
+    __m128i LaneY = _mm_and_si128(ColumnMask, _mm_setr_epi32(0, 1, 2, 3));
+    __m256i IterationCount = _mm256_set1_epi64x(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 4, RENDER_PRECISION_DOUBLE_DOUBLE);
+    kernel_avx2_double_double V;
+    for (int x = 0; x < Row->Count; x += 4)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m256d PixelX = _mm256_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartX), LaneX));
+        __m256d PixelY = _mm256_cvtepi32_pd(_mm_add_epi32(_mm_set1_epi32(StartY), LaneY));
+        V.Cx = Kernel_Avx2DDAdd(LeftLanes, Kernel_Avx2TwoProd(_mm256_add_pd(PixelX, _mm256_set1_pd(0.5)), Scale));
+        V.Cy = Kernel_Avx2DDAdd(BottomLanes, Kernel_Avx2TwoProd(_mm256_add_pd(PixelY, _mm256_set1_pd(0.5)), Scale));
+        V.Zx = (ddouble4) { _mm256_loadu_pd(Row->Zx + x), _mm256_loadu_pd(Row->ZxLo + x) };
+        V.Zy = (ddouble4) { _mm256_loadu_pd(Row->Zy + x), _mm256_loadu_pd(Row->ZyLo + x) };
+        V.Counts = Kernel_Avx2LoadCounts(Row->Iterations + x);
+        V.Active = _mm256_castsi256_pd(_mm256_cmpeq_epi64(V.Counts, _mm256_set1_epi64x(Row->StartIteration)));
+        if (View->SkipsInterior)
+        {
+            __m256d Interior = _mm256_and_pd(V.Active, Kernel_Avx2IsInteriorPd(V.Cx.Hi, V.Cy.Hi));
+            V.Counts = _mm256_blendv_epi8(V.Counts, IterationCount, _mm256_castpd_si256(Interior));
+            V.Active = _mm256_andnot_pd(Interior, V.Active);
+            int InteriorCount = __builtin_popcount(_mm256_movemask_pd(Interior));
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (_mm256_movemask_pd(V.Active))
+        {
+            Kernel_Avx2DoubleDoubleRun(View, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        Kernel_Avx2StoreCounts(Row->Iterations + x, V.Counts);
+        _mm256_storeu_pd(Row->Zx + x, V.Zx.Hi);
+        _mm256_storeu_pd(Row->ZxLo + x, V.Zx.Lo);
+        _mm256_storeu_pd(Row->Zy + x, V.Zy.Hi);
+        _mm256_storeu_pd(Row->ZyLo + x, V.Zy.Lo);
+        int Survivors = _mm256_movemask_pd(V.Active);
+        if (Survivors)
+        {
+            double Cx[4], Cy[4], CxLo[4], CyLo[4];
+            _mm256_storeu_pd(Cx, V.Cx.Hi);
+            _mm256_storeu_pd(Cy, V.Cy.Hi);
+            _mm256_storeu_pd(CxLo, V.Cx.Lo);
+            _mm256_storeu_pd(CyLo, V.Cy.Lo);
+            Kernel_ListLanes(&Lanes, x, Survivors, Cx, Cy, CxLo, CyLo);
+        }
+    }
+
+    u32 ActiveLanes = Kernel_BeginList(&Lanes, View, Row);
+    while (ActiveLanes)
+    {
+        V.Cx = (ddouble4) { _mm256_loadu_pd(Lanes.Cx), _mm256_loadu_pd(Lanes.CxLo) };
+        V.Cy = (ddouble4) { _mm256_loadu_pd(Lanes.Cy), _mm256_loadu_pd(Lanes.CyLo) };
+        V.Zx = (ddouble4) { _mm256_loadu_pd(Lanes.Zx), _mm256_loadu_pd(Lanes.ZxLo) };
+        V.Zy = (ddouble4) { _mm256_loadu_pd(Lanes.Zy), _mm256_loadu_pd(Lanes.ZyLo) };
+        V.Counts = Kernel_Avx2LoadCounts(Lanes.Iterations);
+        V.Active = _mm256_castsi256_pd(_mm256_cmpgt_epi64(IterationCount, V.Counts));
+        Kernel_Avx2DoubleDoubleRun(View, &V, Kernel_GetLaneStepCount(&Lanes, View, ActiveLanes), Kernel_GetRefillCount(&Lanes), false);
+        Kernel_Avx2StoreCounts(Lanes.Iterations, V.Counts);
+        _mm256_storeu_pd(Lanes.Zx, V.Zx.Hi);
+        _mm256_storeu_pd(Lanes.ZxLo, V.Zx.Lo);
+        _mm256_storeu_pd(Lanes.Zy, V.Zy.Hi);
+        _mm256_storeu_pd(Lanes.ZyLo, V.Zy.Lo);
+        ActiveLanes = Kernel_RefillLanes(&Lanes, View, Row, _mm256_movemask_pd(V.Active));
+    }
+}
+
+
+KERNEL_TARGET("avx512f")
+static __mmask16 Kernel_Avx512IsInteriorPs(__m512 Cx, __m512 Cy)
+{
+    __m512 Xq = _mm512_sub_ps(Cx, _mm512_set1_ps(0.25f));
+    __m512 Y2 = _mm512_mul_ps(Cy, Cy);
+    __m512 q = _mm512_add_ps(_mm512_mul_ps(Xq, Xq), Y2);
+    __m512 Xb = _mm512_add_ps(Cx, _mm512_set1_ps(1.0f));
+    __mmask16 Cardioid = _mm512_cmp_ps_mask(_mm512_mul_ps(q, _mm512_add_ps(q, Xq)), _mm512_mul_ps(_mm512_set1_ps(0.25f), Y2), _CMP_LE_OQ);
+    __mmask16 Bulb = _mm512_cmp_ps_mask(_mm512_add_ps(_mm512_mul_ps(Xb, Xb), Y2), _mm512_set1_ps(0.0625f), _CMP_LE_OQ);
+    return Cardioid | Bulb;
+}
+
+KERNEL_TARGET("avx512f")
+static __mmask8 Kernel_Avx512IsInteriorPd(__m512d Cx, __m512d Cy)
+{
+    __m512d Xq = _mm512_sub_pd(Cx, _mm512_set1_pd(0.25));
+    __m512d Y2 = _mm512_mul_pd(Cy, Cy);
+    __m512d q = _mm512_add_pd(_mm512_mul_pd(Xq, Xq), Y2);
+    __m512d Xb = _mm512_add_pd(Cx, _mm512_set1_pd(1.0));
+    __mmask8 Cardioid = _mm512_cmp_pd_mask(_mm512_mul_pd(q, _mm512_add_pd(q, Xq)), _mm512_mul_pd(_mm512_set1_pd(0.25), Y2), _CMP_LE_OQ);
+    __mmask8 Bulb = _mm512_cmp_pd_mask(_mm512_add_pd(_mm512_mul_pd(Xb, Xb), Y2), _mm512_set1_pd(0.0625), _CMP_LE_OQ);
+    return Cardioid | Bulb;
+}
+
+KERNEL_TARGET("avx512f")
+static __m512 Kernel_Avx512LoadFloats(const double *Values)
+{
+    __m256 Low = _mm512_cvtpd_ps(_mm512_loadu_pd(Values));
+    __m256 High = _mm512_cvtpd_ps(_mm512_loadu_pd(Values + 8));
+    __m512d Combined = _mm512_insertf64x4(_mm512_castpd256_pd512(_mm256_castps_pd(Low)), _mm256_castps_pd(High), 1);
+    return _mm512_castpd_ps(Combined);
+}
+
+KERNEL_TARGET("avx512f")
+static void Kernel_Avx512StoreFloats(double *Values, __m512 Floats)
+{
+    __m256 Low = _mm512_castps512_ps256(Floats);
+    __m256 High = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(Floats), 1));
+    _mm512_storeu_pd(Values, _mm512_cvtps_pd(Low));
+    _mm512_storeu_pd(Values + 8, _mm512_cvtps_pd(High));
+}
+
+/* the vectors of Kernel_Avx512Float() */
+typedef struct kernel_avx512_float
+{
+    __mmask16 Active;
+    __m512 Cx, Cy;
+    __m512 Zx, Zy;
+    __m512 SavedZx, SavedZy;
+    __m512i Counts, SaveAt;
+} kernel_avx512_float;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("avx512f")
+static KERNEL_INLINE void Kernel_Avx512FloatRun(const render_view *View, kernel_row *Row, kernel_avx512_float *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m512 Four = _mm512_set1_ps(4.0f);
+    __m512 Two = _mm512_set1_ps(2.0f);
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    __m512 Tolerance = _mm512_set1_ps(View->PeriodicityTolerance * FLT_EPSILON);
+    __m512i One = _mm512_set1_epi32(1);
+    __mmask16 Active = V->Active;
+    __m512 Cx = V->Cx, Cy = V->Cy;
+    __m512 Zx = V->Zx, Zy = V->Zy;
+    __m512 SavedZx = V->SavedZx, SavedZy = V->SavedZy;
+    __m512i Counts = V->Counts, SaveAt = V->SaveAt;
+    /* lanes caught in a cycle keep the z they were caught at, the others step on after they are off */
+    __mmask16 Caught = 0;
+    __m512 CaughtZx = Zx, CaughtZy = Zy;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        __m512 Zx2 = _mm512_mul_ps(Zx, Zx);
+        __m512 Zy2 = _mm512_mul_ps(Zy, Zy);
+        Active = _mm512_mask_cmp_ps_mask(Active, _mm512_add_ps(Zx2, Zy2), Four, _CMP_LT_OQ);
+        if (Kernel_ShouldStop(Active, 16, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm512_mask_add_epi32(Counts, Active, Counts, One);
+
+        __m512 Tmp = _mm512_add_ps(_mm512_sub_ps(Zx2, Zy2), Cx);
+        Zy = _mm512_add_ps(_mm512_mul_ps(_mm512_mul_ps(Two, Zy), Zx), Cy);
+        Zx = Tmp;
+        if (ChecksPeriodicity)
+        {
+            __mmask16 CloseX = _mm512_mask_cmp_ps_mask(Active, _mm512_abs_ps(_mm512_sub_ps(Zx, SavedZx)), Tolerance, _CMP_LT_OQ);
+            __mmask16 Periodic = _mm512_mask_cmp_ps_mask(CloseX, _mm512_abs_ps(_mm512_sub_ps(Zy, SavedZy)), Tolerance, _CMP_LT_OQ);
+            if (Periodic)
+            {
+                u32 LaneCounts[16];
+                _mm512_storeu_si512(LaneCounts, Counts);
+                Kernel_SkipPeriodicLanes(View, Row, LaneCounts, Periodic);
+                Counts = _mm512_mask_mov_epi32(Counts, Periodic, _mm512_set1_epi32(View->IterationCount));
+                CaughtZx = _mm512_mask_mov_ps(CaughtZx, Periodic, Zx);
+                CaughtZy = _mm512_mask_mov_ps(CaughtZy, Periodic, Zy);
+                Caught |= Periodic;
+                Active &= ~Periodic;
+            }
+            __mmask16 Saves = IsBlock? Active : _mm512_mask_cmpeq_epi32_mask(Active, Counts, SaveAt);
+            if (IsBlock? KERNEL_SAVES_Z_AFTER(Row->StartIteration + Step) : Saves)
+            {
+                SavedZx = _mm512_mask_mov_ps(SavedZx, Saves, Zx);
+                SavedZy = _mm512_mask_mov_ps(SavedZy, Saves, Zy);
+                SaveAt = _mm512_mask_add_epi32(SaveAt, Saves, SaveAt, SaveAt);
+            }
+        }
+    }
+    V->Active = _mm512_mask_cmplt_epi32_mask(Active, Counts, _mm512_set1_epi32(View->IterationCount));
+    V->Zx = _mm512_mask_mov_ps(Zx, Caught, CaughtZx);
+    V->Zy = _mm512_mask_mov_ps(Zy, Caught, CaughtZy);
+    V->SavedZx = SavedZx;
+    V->SavedZy = SavedZy;
+    V->Counts = Counts;
+    V->SaveAt = SaveAt;
+}
+
+KERNEL_TARGET("avx512f")
+static void Kernel_Avx512Float(const render_view *View, kernel_row *Row)
+{
+    float Scale = View->ScreenToWorldScaleFactor;
+    float Left = View->WorldLeft;
+    float Bottom = View->WorldBottom;
+    __m512i LaneIndex = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m512i ColumnMask = _mm512_set1_epi32(Row->IsColumn? -1 : 0);
+    __m512i LaneX = _mm512_andnot_si512(ColumnMask, LaneIndex);
+    __m512i LaneY = _mm512_and_si512(ColumnMask, LaneIndex);
+    __m512i IterationCount = _mm512_set1_epi32(View->IterationCount);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 16, RENDER_PRECISION_FLOAT);
+    kernel_avx512_float V;
+    for (int x = 0; x < Row->Count; x += 16)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m512 PixelX = _mm512_cvtepi32_ps(_mm512_add_epi32(_mm512_set1_epi32(StartX), LaneX));
+        __m512 PixelY = _mm512_cvtepi32_ps(_mm512_add_epi32(_mm512_set1_epi32(StartY), LaneY));
+        V.Cx = _mm512_add_ps(_mm512_mul_ps(_mm512_add_ps(PixelX, _mm512_set1_ps(0.5f)), _mm512_set1_ps(Scale)), _mm512_set1_ps(Left));
+        V.Cy = _mm512_add_ps(_mm512_mul_ps(_mm512_add_ps(PixelY, _mm512_set1_ps(0.5f)), _mm512_set1_ps(Scale)), _mm512_set1_ps(Bottom));
+        V.Zx = Kernel_Avx512LoadFloats(Row->Zx + x);
+        V.Zy = Kernel_Avx512LoadFloats(Row->Zy + x);
+        V.SavedZx = Kernel_Avx512LoadFloats(Row->SavedZx + x);
+        V.SavedZy = Kernel_Avx512LoadFloats(Row->SavedZy + x);
+        V.Counts = _mm512_loadu_si512(Row->Iterations + x);
+        V.SaveAt = _mm512_set1_epi32(Kernel_GetSaveAt(Row->StartIteration));
+        V.Active = _mm512_cmpeq_epi32_mask(V.Counts, _mm512_set1_epi32(Row->StartIteration));
+        if (View->SkipsInterior)
+        {
+            __mmask16 Interior = V.Active & Kernel_Avx512IsInteriorPs(V.Cx, V.Cy);
+            V.Counts = _mm512_mask_mov_epi32(V.Counts, Interior, IterationCount);
+            V.Active &= ~Interior;
+            int InteriorCount = __builtin_popcount(Interior);
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (V.Active)
+        {
+            Kernel_Avx512FloatRun(View, Row, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        _mm512_storeu_si512(Row->Iterations + x, V.Counts);
+        Kernel_Avx512StoreFloats(Row->Zx + x, V.Zx);
+        Kernel_Avx512StoreFloats(Row->Zy + x, V.Zy);
+        Kernel_Avx512StoreFloats(Row->SavedZx + x, V.SavedZx);
+        Kernel_Avx512StoreFloats(Row->SavedZy + x, V.SavedZy);
+        if (V.Active)
+        {
+            double Cx[16], Cy[16];
+            Kernel_Avx512StoreFloats(Cx, V.Cx);
+            Kernel_Avx512StoreFloats(Cy, V.Cy);
+            Kernel_ListLanes(&Lanes, x, V.Active, Cx, Cy, NULL, NULL);
+        }
+    }
+
+    V.Active = Kernel_BeginList(&Lanes, View, Row);
+    while (V.Active)
+    {
+        V.Cx = Kernel_Avx512LoadFloats(Lanes.Cx);
+        V.Cy = Kernel_Avx512LoadFloats(Lanes.Cy);
+        V.Zx = Kernel_Avx512LoadFloats(Lanes.Zx);
+        V.Zy = Kernel_Avx512LoadFloats(Lanes.Zy);
+        V.SavedZx = Kernel_Avx512LoadFloats(Lanes.SavedZx);
+        V.SavedZy = Kernel_Avx512LoadFloats(Lanes.SavedZy);
+        V.Counts = _mm512_loadu_si512(Lanes.Iterations);
+        V.SaveAt = _mm512_loadu_si512(Lanes.SaveAt);
+        Kernel_Avx512FloatRun(View, Row, &V, Kernel_GetLaneStepCount(&Lanes, View, V.Active), Kernel_GetRefillCount(&Lanes), false);
+        _mm512_storeu_si512(Lanes.Iterations, V.Counts);
+        _mm512_storeu_si512(Lanes.SaveAt, V.SaveAt);
+        Kernel_Avx512StoreFloats(Lanes.Zx, V.Zx);
+        Kernel_Avx512StoreFloats(Lanes.Zy, V.Zy);
+        Kernel_Avx512StoreFloats(Lanes.SavedZx, V.SavedZx);
+        Kernel_Avx512StoreFloats(Lanes.SavedZy, V.SavedZy);
+        V.Active = Kernel_RefillLanes(&Lanes, View, Row, V.Active);
+    }
+}
+
+/* the vectors of Kernel_Avx512Double() */
+typedef struct kernel_avx512_double
+{
+    __mmask8 Active;
+    __m512d Cx, Cy;
+    __m512d Zx, Zy;
+    __m512d SavedZx, SavedZy;
+    __m512i Counts, SaveAt; /* 64-bit, to compare in the lanes of the doubles */
+} kernel_avx512_double;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("avx512f")
+static KERNEL_INLINE void Kernel_Avx512DoubleRun(const render_view *View, kernel_row *Row, kernel_avx512_double *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m512d Four = _mm512_set1_pd(4.0);
+    __m512d Two = _mm512_set1_pd(2.0);
+    bool8 ChecksPeriodicity = View->PeriodicityTolerance > 0;
+    __m512d Tolerance = _mm512_set1_pd(View->PeriodicityTolerance * DBL_EPSILON);
+    __m512i One = _mm512_set1_epi64(1);
+    __mmask8 Active = V->Active;
+    __m512d Cx = V->Cx, Cy = V->Cy;
+    __m512d Zx = V->Zx, Zy = V->Zy;
+    __m512d SavedZx = V->SavedZx, SavedZy = V->SavedZy;
+    __m512i Counts = V->Counts, SaveAt = V->SaveAt;
+    /* lanes caught in a cycle keep the z they were caught at, the others step on after they are off */
+    __mmask8 Caught = 0;
+    __m512d CaughtZx = Zx, CaughtZy = Zy;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        __m512d Zx2 = _mm512_mul_pd(Zx, Zx);
+        __m512d Zy2 = _mm512_mul_pd(Zy, Zy);
+        Active = _mm512_mask_cmp_pd_mask(Active, _mm512_add_pd(Zx2, Zy2), Four, _CMP_LT_OQ);
+        if (Kernel_ShouldStop(Active, 8, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm512_mask_add_epi64(Counts, Active, Counts, One);
+
+        __m512d Tmp = _mm512_add_pd(_mm512_sub_pd(Zx2, Zy2), Cx);
+        Zy = _mm512_add_pd(_mm512_mul_pd(_mm512_mul_pd(Two, Zy), Zx), Cy);
+        Zx = Tmp;
+        if (ChecksPeriodicity)
+        {
+            __mmask8 CloseX = _mm512_mask_cmp_pd_mask(Active, _mm512_abs_pd(_mm512_sub_pd(Zx, SavedZx)), Tolerance, _CMP_LT_OQ);
+            __mmask8 Periodic = _mm512_mask_cmp_pd_mask(CloseX, _mm512_abs_pd(_mm512_sub_pd(Zy, SavedZy)), Tolerance, _CMP_LT_OQ);
+            if (Periodic)
+            {
+                u32 LaneCounts[8];
+                _mm256_storeu_si256((__m256i *)LaneCounts, _mm512_cvtepi64_epi32(Counts));
+                Kernel_SkipPeriodicLanes(View, Row, LaneCounts, Periodic);
+                Counts = _mm512_mask_mov_epi64(Counts, Periodic, _mm512_set1_epi64(View->IterationCount));
+                CaughtZx = _mm512_mask_mov_pd(CaughtZx, Periodic, Zx);
+                CaughtZy = _mm512_mask_mov_pd(CaughtZy, Periodic, Zy);
+                Caught |= Periodic;
+                Active &= ~Periodic;
+            }
+            __mmask8 Saves = IsBlock? Active : _mm512_mask_cmpeq_epi64_mask(Active, Counts, SaveAt);
+            if (IsBlock? KERNEL_SAVES_Z_AFTER(Row->StartIteration + Step) : Saves)
+            {
+                SavedZx = _mm512_mask_mov_pd(SavedZx, Saves, Zx);
+                SavedZy = _mm512_mask_mov_pd(SavedZy, Saves, Zy);
+                SaveAt = _mm512_mask_add_epi64(SaveAt, Saves, SaveAt, SaveAt);
+            }
+        }
+    }
+    V->Active = _mm512_mask_cmplt_epi64_mask(Active, Counts, _mm512_set1_epi64(View->IterationCount));
+    V->Zx = _mm512_mask_mov_pd(Zx, Caught, CaughtZx);
+    V->Zy = _mm512_mask_mov_pd(Zy, Caught, CaughtZy);
+    V->SavedZx = SavedZx;
+    V->SavedZy = SavedZy;
+    V->Counts = Counts;
+    V->SaveAt = SaveAt;
+}
+
+KERNEL_TARGET("avx512f")
+static void Kernel_Avx512Double(const render_view *View, kernel_row *Row)
+{
+    double Scale = View->ScreenToWorldScaleFactor;
+    __m256i LaneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i ColumnMask = _mm256_set1_epi32(Row->IsColumn? -1 : 0);
+    __m256i LaneX = _mm256_andnot_si256(ColumnMask, LaneIndex);
+    __m256i LaneY = _mm256_and_si256(ColumnMask, LaneIndex);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 8, RENDER_PRECISION_DOUBLE);
+    kernel_avx512_double V;
+    for (int x = 0; x < Row->Count; x += 8)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m512d PixelX = _mm512_cvtepi32_pd(_mm256_add_epi32(_mm256_set1_epi32(StartX), LaneX));
+        __m512d PixelY = _mm512_cvtepi32_pd(_mm256_add_epi32(_mm256_set1_epi32(StartY), LaneY));
+        V.Cx = _mm512_add_pd(_mm512_mul_pd(_mm512_add_pd(PixelX, _mm512_set1_pd(0.5)), _mm512_set1_pd(Scale)), _mm512_set1_pd(View->WorldLeft));
+        V.Cy = _mm512_add_pd(_mm512_mul_pd(_mm512_add_pd(PixelY, _mm512_set1_pd(0.5)), _mm512_set1_pd(Scale)), _mm512_set1_pd(View->WorldBottom));
+        V.Zx = _mm512_loadu_pd(Row->Zx + x);
+        V.Zy = _mm512_loadu_pd(Row->Zy + x);
+        V.SavedZx = _mm512_loadu_pd(Row->SavedZx + x);
+        V.SavedZy = _mm512_loadu_pd(Row->SavedZy + x);
+        V.Counts = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i *)(Row->Iterations + x)));
+        V.SaveAt = _mm512_set1_epi64(Kernel_GetSaveAt(Row->StartIteration));
+        V.Active = _mm512_cmpeq_epi64_mask(V.Counts, _mm512_set1_epi64(Row->StartIteration));
+        if (View->SkipsInterior)
+        {
+            __mmask8 Interior = V.Active & Kernel_Avx512IsInteriorPd(V.Cx, V.Cy);
+            V.Counts = _mm512_mask_mov_epi64(V.Counts, Interior, _mm512_set1_epi64(View->IterationCount));
+            V.Active &= ~Interior;
+            int InteriorCount = __builtin_popcount(Interior);
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (V.Active)
+        {
+            Kernel_Avx512DoubleRun(View, Row, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+        _mm256_storeu_si256((__m256i *)(Row->Iterations + x), _mm512_cvtepi64_epi32(V.Counts));
+        _mm512_storeu_pd(Row->Zx + x, V.Zx);
+        _mm512_storeu_pd(Row->Zy + x, V.Zy);
+        _mm512_storeu_pd(Row->SavedZx + x, V.SavedZx);
+        _mm512_storeu_pd(Row->SavedZy + x, V.SavedZy);
+        if (V.Active)
+        {
+            double Cx[8], Cy[8];
+            _mm512_storeu_pd(Cx, V.Cx);
+            _mm512_storeu_pd(Cy, V.Cy);
+            Kernel_ListLanes(&Lanes, x, V.Active, Cx, Cy, NULL, NULL);
+        }
+    }
+
+    V.Active = Kernel_BeginList(&Lanes, View, Row);
+    while (V.Active)
+    {
+        V.Cx = _mm512_loadu_pd(Lanes.Cx);
+        V.Cy = _mm512_loadu_pd(Lanes.Cy);
+        V.Zx = _mm512_loadu_pd(Lanes.Zx);
+        V.Zy = _mm512_loadu_pd(Lanes.Zy);
+        V.SavedZx = _mm512_loadu_pd(Lanes.SavedZx);
+        V.SavedZy = _mm512_loadu_pd(Lanes.SavedZy);
+        V.Counts = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i *)Lanes.Iterations));
+        V.SaveAt = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i *)Lanes.SaveAt));
+        Kernel_Avx512DoubleRun(View, Row, &V, Kernel_GetLaneStepCount(&Lanes, View, V.Active), Kernel_GetRefillCount(&Lanes), false);
+        _mm256_storeu_si256((__m256i *)Lanes.Iterations, _mm512_cvtepi64_epi32(V.Counts));
+        _mm256_storeu_si256((__m256i *)Lanes.SaveAt, _mm512_cvtepi64_epi32(V.SaveAt));
+        _mm512_storeu_pd(Lanes.Zx, V.Zx);
+        _mm512_storeu_pd(Lanes.Zy, V.Zy);
+        _mm512_storeu_pd(Lanes.SavedZx, V.SavedZx);
+        _mm512_storeu_pd(Lanes.SavedZy, V.SavedZy);
+        V.Active = Kernel_RefillLanes(&Lanes, View, Row, V.Active);
+    }
+}
+
+
+typedef struct ddouble8
+{
+    __m512d Hi, Lo;
+} ddouble8;
+
+KERNEL_TARGET("avx512f")
+static inline ddouble8 Kernel_Avx512QuickTwoSum(__m512d A, __m512d B)
+{
+    __m512d Sum = _mm512_add_pd(A, B);
+    return (ddouble8) { Sum, _mm512_sub_pd(B, _mm512_sub_pd(Sum, A)) };
+}
+
+KERNEL_TARGET("avx512f")
+static inline ddouble8 Kernel_Avx512TwoSum(__m512d A, __m512d B)
+{
+    __m512d Sum = _mm512_add_pd(A, B);
+    __m512d BVirtual = _mm512_sub_pd(Sum, A);
+    __m512d AVirtual = _mm512_sub_pd(Sum, BVirtual);
+    return (ddouble8) { Sum, _mm512_add_pd(_mm512_sub_pd(A, AVirtual), _mm512_sub_pd(B, BVirtual)) };
+}
+
+KERNEL_TARGET("avx512f")
+static inline ddouble8 Kernel_Avx512TwoProd(__m512d A, __m512d B)
+{
+    __m512d Product = _mm512_mul_pd(A, B);
+    return (ddouble8) { Product, _mm512_fmsub_pd(A, B, Product) };
+}
+
+KERNEL_TARGET("avx512f")
+static inline ddouble8 Kernel_Avx512DDAdd(ddouble8 A, ddouble8 B)
+{
+    ddouble8 S = Kernel_Avx512TwoSum(A.Hi, B.Hi);
+    ddouble8 T = Kernel_Avx512TwoSum(A.Lo, B.Lo);
+    S = Kernel_Avx512QuickTwoSum(S.Hi, _mm512_add_pd(S.Lo, T.Hi));
+    return Kernel_Avx512QuickTwoSum(S.Hi, _mm512_add_pd(S.Lo, T.Lo));
+}
+
+KERNEL_TARGET("avx512f")
+static inline ddouble8 Kernel_Avx512DDMul(ddouble8 A, ddouble8 B)
+{
+    ddouble8 P = Kernel_Avx512TwoProd(A.Hi, B.Hi);
+    __m512d Cross = _mm512_add_pd(_mm512_mul_pd(A.Hi, B.Lo), _mm512_mul_pd(A.Lo, B.Hi));
+    return Kernel_Avx512QuickTwoSum(P.Hi, _mm512_add_pd(P.Lo, Cross));
+}
+
+KERNEL_TARGET("avx512f")
+static inline ddouble8 Kernel_Avx512DDSqr(ddouble8 A)
+{
+    ddouble8 P = Kernel_Avx512TwoProd(A.Hi, A.Hi);
+    __m512d Cross = _mm512_mul_pd(_mm512_mul_pd(_mm512_set1_pd(2.0), A.Hi), A.Lo);
+    return Kernel_Avx512QuickTwoSum(P.Hi, _mm512_add_pd(P.Lo, Cross));
+}
+
+/* the vectors of Kernel_Avx512DoubleDouble() */
+typedef struct kernel_avx512_double_double
+{
+    __mmask8 Active;
+    ddouble8 Cx, Cy;
+    ddouble8 Zx, Zy;
+    __m512i Counts; /* 64-bit, to compare in the lanes of the doubles */
+} kernel_avx512_double_double;
+
+/* iterates until the lanes are done, StepCount runs out or RefillCount lanes are off, see Kernel_ShouldStop() */
+KERNEL_TARGET("avx512f")
+static KERNEL_INLINE void Kernel_Avx512DoubleDoubleRun(const render_view *View, kernel_avx512_double_double *V, int StepCount, int RefillCount, bool8 IsBlock)
+{
+    __m512d Four = _mm512_set1_pd(4.0);
+    __m512d Two = _mm512_set1_pd(2.0);
+    /* no _mm512_xor_pd without AVX-512DQ */
+    __m512i SignBit = _mm512_set1_epi64(0x8000000000000000ull);
+    __m512i One = _mm512_set1_epi64(1);
+    __mmask8 Active = V->Active;
+    ddouble8 Cx = V->Cx, Cy = V->Cy;
+    ddouble8 Zx = V->Zx, Zy = V->Zy;
+    __m512i Counts = V->Counts;
+    for (int Step = 0; Step < StepCount; Step++)
+    {
+        ddouble8 Zx2 = Kernel_Avx512DDSqr(Zx);
+        ddouble8 Zy2 = Kernel_Avx512DDSqr(Zy);
+        Active = _mm512_mask_cmp_pd_mask(Active, _mm512_add_pd(Zx2.Hi, Zy2.Hi), Four, _CMP_LT_OQ);
+        if (Kernel_ShouldStop(Active, 8, RefillCount, Step, IsBlock))
+            break;
+        Counts = _mm512_mask_add_epi64(Counts, Active, Counts, One);
+
+        ddouble8 MinusZy2 = {
+            _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(Zy2.Hi), SignBit)),
+            _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(Zy2.Lo), SignBit)),
+        };
+        ddouble8 Tmp = Kernel_Avx512DDAdd(Kernel_Avx512DDAdd(Zx2, MinusZy2), Cx);
+        ddouble8 ZxZy = Kernel_Avx512DDMul(Zx, Zy);
+        ddouble8 TwoZxZy = { _mm512_mul_pd(Two, ZxZy.Hi), _mm512_mul_pd(Two, ZxZy.Lo) };
+        Zy = Kernel_Avx512DDAdd(TwoZxZy, Cy);
+        Zx = Tmp;
+    }
+    V->Active = _mm512_mask_cmplt_epi64_mask(Active, Counts, _mm512_set1_epi64(View->IterationCount));
+    V->Zx = Zx;
+    V->Zy = Zy;
+    V->Counts = Counts;
+}
+
+KERNEL_TARGET("avx512f")
+static void Kernel_Avx512DoubleDouble(const render_view *View, kernel_row *Row)
+{
+    ddouble Left = DD_FromBigFix(&View->ExactWorldLeft);
+    ddouble Bottom = DD_FromBigFix(&View->ExactWorldBottom);
+    ddouble8 LeftLanes = { _mm512_set1_pd(Left.Hi), _mm512_set1_pd(Left.Lo) };
+    ddouble8 BottomLanes = { _mm512_set1_pd(Bottom.Hi), _mm512_set1_pd(Bottom.Lo) };
+    __m512d Scale = _mm512_set1_pd(View->ScreenToWorldScaleFactor);
+    __m256i LaneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i ColumnMask = _mm256_set1_epi32(Row->IsColumn? -1 : 0);
+    __m256i LaneX = _mm256_andnot_si256(ColumnMask, LaneIndex);
+    __m256i LaneY = _mm256_and_si256(ColumnMask, LaneIndex);
+    kernel_lanes Lanes;
+    Kernel_BeginLanes(&Lanes, Row, 8, RENDER_PRECISION_DOUBLE_DOUBLE);
+    kernel_avx512_double_double V;
+    for (int x = 0; x < Row->Count; x += 8)
+    {
+        int StartX = Row->StartX + (Row->IsColumn? 0 : x);
+        int StartY = Row->Y + (Row->IsColumn? x : 0);
+        __m512d PixelX = _mm512_cvtepi32_pd(_mm256_add_epi32(_mm256_set1_epi32(StartX), LaneX));
+        __m512d PixelY = _mm512_cvtepi32_pd(_mm256_add_epi32(_mm256_set1_epi32(StartY), LaneY));
+        V.Cx = Kernel_Avx512DDAdd(LeftLanes, Kernel_Avx512TwoProd(_mm512_add_pd(PixelX, _mm512_set1_pd(0.5)), Scale));
+        V.Cy = Kernel_Avx512DDAdd(BottomLanes, Kernel_Avx512TwoProd(_mm512_add_pd(PixelY, _mm512_set1_pd(0.5)), Scale));
+        V.Zx = (ddouble8) { _mm512_loadu_pd(Row->Zx + x), _mm512_loadu_pd(Row->ZxLo + x) };
+        V.Zy = (ddouble8) { _mm512_loadu_pd(Row->Zy + x), _mm512_loadu_pd(Row->ZyLo + x) };
+        V.Counts = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i *)(Row->Iterations + x)));
+        V.Active = _mm512_cmpeq_epi64_mask(V.Counts, _mm512_set1_epi64(Row->StartIteration));
+        if (View->SkipsInterior)
+        {
+            __mmask8 Interior = V.Active & Kernel_Avx512IsInteriorPd(V.Cx.Hi, V.Cy.Hi);
+            V.Counts = _mm512_mask_mov_epi64(V.Counts, Interior, _mm512_set1_epi64(View->IterationCount));
+            V.Active &= ~Interior;
+            int InteriorCount = __builtin_popcount(Interior);
+            Row->EarlyExitCount += InteriorCount;
+            Row->SkippedIterationCount += (i64)InteriorCount * (View->IterationCount - Row->StartIteration);
+        }
+        if (V.Active)
+        {
+            Kernel_Avx512DoubleDoubleRun(View, &V, View->IterationCount - Row->StartIteration, Lanes.RefillCount, true);
+        }
+
+        _mm256_storeu_si256((__m256i *)(Row->Iterations + x), _mm512_cvtepi64_epi32(V.Counts));
+        _mm512_storeu_pd(Row->Zx + x, V.Zx.Hi);
+        _mm512_storeu_pd(Row->ZxLo + x, V.Zx.Lo);
+        _mm512_storeu_pd(Row->Zy + x, V.Zy.Hi);
+        _mm512_storeu_pd(Row->ZyLo + x, V.Zy.Lo);
+        if (V.Active)
+        {
+            double Cx[8], Cy[8], CxLo[8], CyLo[8];
+            _mm512_storeu_pd(Cx, V.Cx.Hi);
+            _mm512_storeu_pd(Cy, V.Cy.Hi);
+            _mm512_storeu_pd(CxLo, V.Cx.Lo);
+            _mm512_storeu_pd(CyLo, V.Cy.Lo);
+            Kernel_ListLanes(&Lanes, x, V.Active, Cx, Cy, CxLo, CyLo);
+        }
+    }
+
+    V.Active = Kernel_BeginList(&Lanes, View, Row);
+    while (V.Active)
+    {
+        V.Cx = (ddouble8) { _mm512_loadu_pd(Lanes.Cx), _mm512_loadu_pd(Lanes.CxLo) };
+        V.Cy = (ddouble8) { _mm512_loadu_pd(Lanes.Cy), _mm512_loadu_pd(Lanes.CyLo) };
+        V.Zx = (ddouble8) { _mm512_loadu_pd(Lanes.Zx), _mm512_loadu_pd(Lanes.ZxLo) };
+        V.Zy = (ddouble8) { _mm512_loadu_pd(Lanes.Zy), _mm512_loadu_pd(Lanes.ZyLo) };
+        V.Counts = _mm512_cvtepu32_epi64(_mm256_loadu_si256((__m256i *)Lanes.Iterations));
+        Kernel_Avx512DoubleDoubleRun(View, &V, Kernel_GetLaneStepCount(&Lanes, View, V.Active), Kernel_GetRefillCount(&Lanes), false);
+        _mm256_storeu_si256((__m256i *)Lanes.Iterations, _mm512_cvtepi64_epi32(V.Counts));
+        _mm512_storeu_pd(Lanes.Zx, V.Zx.Hi);
+        _mm512_storeu_pd(Lanes.ZxLo, V.Zx.Lo);
+        _mm512_storeu_pd(Lanes.Zy, V.Zy.Hi);
+        _mm512_storeu_pd(Lanes.ZyLo, V.Zy.Lo);
+        V.Active = Kernel_RefillLanes(&Lanes, View, Row, V.Active);
+    }
+}
+
+
+static u64 Kernel_GetXcr0(void)
+{
+    u32 Low, High;
+    __asm__ volatile ("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+    return (u64)High << 32 | Low;
+}
+
+kernel_isa Kernel_GetBestIsa(void)
+{
+    unsigned Eax, Ebx, Ecx, Edx;
+    if (!__get_cpuid(1, &Eax, &Ebx, &Ecx, &Edx) || !(Edx & bit_SSE2))
+        return KERNEL_ISA_SCALAR;
+
+    /* the OS must save ymm/zmm state on context switches, otherwise the CPU flags mean nothing */
+    u64 Xcr0 = (Ecx & bit_OSXSAVE)? Kernel_GetXcr0() : 0;
+    bool8 HasFma = (Ecx & bit_FMA) != 0;
+    bool8 HasPopcnt = (Ecx & bit_POPCNT) != 0;
+    bool8 OsSavesYmm = (Xcr0 & 0x06) == 0x06;
+    bool8 OsSavesZmm = (Xcr0 & 0xE6) == 0xE6;
+    if (!OsSavesYmm || !__get_cpuid_count(7, 0, &Eax, &Ebx, &Ecx, &Edx))
+        return KERNEL_ISA_SSE2;
+
+    if (OsSavesZmm && (Ebx & bit_AVX512F))
+        return KERNEL_ISA_AVX512;
+    /* the double-double kernel needs FMA and the refill test POPCNT, both come with AVX2 on every CPU anyway */
+    if ((Ebx & bit_AVX2) && HasFma && HasPopcnt)
+        return KERNEL_ISA_AVX2;
+    return KERNEL_ISA_SSE2;
+}
+
+#else
+
+kernel_isa Kernel_GetBestIsa(void)
+{
+    return KERNEL_ISA_SCALAR;
+}
+
+#endif /* KERNEL_HAS_X86_SIMD */
+
+
+
+const char *Kernel_GetIsaName(kernel_isa Isa)
+{
+    static const char *Names[KERNEL_ISA_COUNT] = {
+        [KERNEL_ISA_SCALAR] = "scalar",
+        [KERNEL_ISA_SSE2] = "sse2",
+        [KERNEL_ISA_AVX2] = "avx2",
+        [KERNEL_ISA_AVX512] = "avx512",
+    };
+    return Names[Isa];
+}
+
+kernel_row_fn *Kernel_GetRowFunction(kernel_isa Isa, render_precision Precision)
+{
+    static kernel_row_fn *RowFunctions[KERNEL_ISA_COUNT][RENDER_PRECISION_COUNT] = {
+        [KERNEL_ISA_SCALAR] = { 
+            [RENDER_PRECISION_FLOAT] = Kernel_ScalarFloat, 
+            [RENDER_PRECISION_DOUBLE] = Kernel_ScalarDouble,
+            [RENDER_PRECISION_DOUBLE_DOUBLE] = Kernel_ScalarDoubleDouble,
+        },
+#if KERNEL_HAS_X86_SIMD
+        [KERNEL_ISA_SSE2] = { 
+            [RENDER_PRECISION_FLOAT] = Kernel_Sse2Float, 
+            [RENDER_PRECISION_DOUBLE] = Kernel_Sse2Double,
+            [RENDER_PRECISION_DOUBLE_DOUBLE] = Kernel_Sse2DoubleDouble,
+        },
+        [KERNEL_ISA_AVX2] = { 
+            [RENDER_PRECISION_FLOAT] = Kernel_Avx2Float, 
+            [RENDER_PRECISION_DOUBLE] = Kernel_Avx2Double,
+            [RENDER_PRECISION_DOUBLE_DOUBLE] = Kernel_Avx2DoubleDouble,
+        },
+        [KERNEL_ISA_AVX512] = { 
+            [RENDER_PRECISION_FLOAT] = Kernel_Avx512Float, 
+            [RENDER_PRECISION_DOUBLE] = Kernel_Avx512Double,
+            [RENDER_PRECISION_DOUBLE_DOUBLE] = Kernel_Avx512DoubleDouble,
+        },
+#endif /* KERNEL_HAS_X86_SIMD */
+    };
+    /* not every precision has every ISA, take the next best one */
+    while (Isa > KERNEL_ISA_SCALAR && !RowFunctions[Isa][Precision] && RowFunctions[KERNEL_ISA_SCALAR][Precision])
+        Isa--;
+    return RowFunctions[Isa][Precision];
+}
+
+void Kernel_SetIsa(kernel_isa Isa)
+{
+    sKernel_Isa = MIN(Isa, Kernel_GetBestIsa());
+}
+
+kernel_isa Kernel_GetIsa(void)
+{
+    if (sKernel_Isa < 0)
+    {
+        sKernel_Isa = Kernel_GetBestIsa();
+    }
+    return sKernel_Isa;
+}
+
@@ -0,0 +1,78 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "Common.h"
+#include "Renderer.h"
+
+
+typedef enum 
+{
+    KERNEL_ISA_SCALAR,
+    KERNEL_ISA_SSE2,
+    KERNEL_ISA_AVX2,
+    KERNEL_ISA_AVX512,
+    KERNEL_ISA_COUNT,
+} kernel_isa;
+
+/* widest SIMD vector, the arrays of kernel_row have room for Count rounded up to this */
+#define KERNEL_MAX_LANE_COUNT 16
+/* longest kernel_row, the renderer's rows are at most a tile */
+#define KERNEL_MAX_ROW_COUNT RENDERER_TILE_SIZE
+
+/* 
+    Count pixels of row Y (counting up like gl_FragCoord.y), starting at StartX, 
+    or of column StartX going up from Y when IsColumn.
+    A pixel is iterated only when its count is StartIteration, the others escaped already,
+    and it picks up from its stored z. From scratch that is StartIteration 0, z 0.
+*/
+typedef struct kernel_row
+{
+    int StartX, Y, Count;
+    bool8 IsColumn;
+    int StartIteration;
+    u32 *Iterations; /* in: count so far, out: escape count, or View->IterationCount if it didn't escape */
+    double *Zx, *Zy; /* in/out: z of every pixel (dz for perturbation), junk once the pixel escaped or was found interior */
+    double *ZxLo, *ZyLo; /* double-double only */
+    i32 *OrbitIndex; /* perturbation only */
+    /* 
+        in/out: Brent's cycle detection, z is compared against the one saved at the last power of two iterations.
+        Only the float and double kernels use them.
+    */
+    double *SavedZx, *SavedZy;
+    /* out: pixels found interior by their c or a cycle, and the iterations their count jumped over to View->IterationCount */
+    int EarlyExitCount;
+    i64 SkippedIterationCount;
+} kernel_row;
+
+/* Every ISA returns the exact same counts and z as the scalar kernel of the same precision. */
+typedef void kernel_row_fn(const render_view *View, kernel_row *Row);
+
+
+/* 
+    Inside the main cardioid or the period-2 bulb, which never escape (View->SkipsInterior). 
+    The kernels evaluate it in this exact order so that every ISA agrees. 
+*/
+static inline bool8 Kernel_IsInterior(double Cx, double Cy)
+{
+    double Xq = Cx - 0.25;
+    double Y2 = Cy*Cy;
+    double q = Xq*Xq + Y2;
+    double Xb = Cx + 1.0;
+    return q*(q + Xq) <= 0.25*Y2 || Xb*Xb + Y2 <= 0.0625;
+}
+
+
+/* from CPUID, also checks that the OS saves the wider registers */
+kernel_isa Kernel_GetBestIsa(void);
+/* the renderer uses the best ISA unless set otherwise */
+void Kernel_SetIsa(kernel_isa Isa);
+kernel_isa Kernel_GetIsa(void);
+const char *Kernel_GetIsaName(kernel_isa Isa);
+/* 
+    falls back to a lower ISA when a precision doesn't have this one or it isn't compiled in,
+    NULL for perturbation, which needs its reference orbit 
+*/
+kernel_row_fn *Kernel_GetRowFunction(kernel_isa Isa, render_precision Precision);
+
+#endif /* KERNEL_H */
+
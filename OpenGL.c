@@ -1,6 +1,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "glad/glad.h"
@@ -8,6 +9,7 @@
 
 #include "Platform.h"
 #include "Common.h"
+#include "WorkQueue.h"
 
 
 static uint32_t sStackAllocatorMemory[4*MB / sizeof(uint32_t)]; 
@@ -19,6 +21,22 @@ static app_state sAppState;
 static GLFWwindow *sWindow;
 static bool8 sLastKeyState[256], sCurrentKeyState[256];
 
+
+void Platform_PushWork(platform_work_callback *Callback, void *Data)
+{
+    WorkQueue_Push(Callback, Data);
+}
+
+void Platform_CompleteAllWork(void)
+{
+    WorkQueue_CompleteAll();
+}
+
+int Platform_GetThreadCount(void)
+{
+    return WorkQueue_GetThreadCount();
+}
+
 void *Platform_PushMemory(int *PlatformMemory, int SizeBytes)
 {
     int32_t AlignedSize = 0;
@@ -100,6 +118,13 @@ static void OnFrameBufferResize(GLFWwindow *Window, int Width, int Height)
     glViewport(0, 0, Width, Height);
 }
 
+/* the window got uncovered or resized, the app only redraws on its own changes */
+static void OnWindowRefresh(GLFWwindow *Window)
+{
+    (void)Window;
+    Platform_RequestRedraw();
+}
+
 static void OnMouseMove(GLFWwindow *Window, double X, double Y)
 {
     mouse_data Mouse = {
@@ -136,6 +161,10 @@ static void OnKeyInput(GLFWwindow *Window, int GlfwKey, int Scancode, int Action
     case GLFW_KEY_LEFT_SHIFT: Key = PLATFORM_KEY_LEFT_SHIFT; break;
     case GLFW_KEY_UP: Key = PLATFORM_KEY_UP_ARROW; break;
     case GLFW_KEY_DOWN: Key = PLATFORM_KEY_DOWN_ARROW; break;
+    case GLFW_KEY_I: Key = PLATFORM_KEY_I; break;
+    case GLFW_KEY_M: Key = PLATFORM_KEY_M; break;
+    case GLFW_KEY_T: Key = PLATFORM_KEY_T; break;
+    case GLFW_KEY_A: Key = PLATFORM_KEY_A; break;
     default: return;
     }
 
@@ -164,7 +193,7 @@ platform_window_dimensions Platform_GetWindowDimensions(void)
 double Platform_GetElapsedTimeMs(void)
 {
     double Now = glfwGetTime();
-    return (Now - sStartTimeS) * 0.001;
+    return (Now - sStartTimeS) * 1000.0;
 }
 
 double Platform_GetFrameTimeMs(void)
@@ -172,17 +201,51 @@ double Platform_GetFrameTimeMs(void)
     return sFrameTimeMs;
 }
 
+platform_framebuffer Platform_GetSoftwareFramebuffer(void)
+{
+    return (platform_framebuffer) { 0 };
+}
+
+frame_time_stats Platform_GetFrameTimeStats(void)
+{
+    return Profiler_GetStats();
+}
+
+
+void Platform_BeginScope(const char *Name)
+{
+    Profiler_BeginScope(Name, Platform_GetElapsedTimeMs());
+}
+
+void Platform_EndScope(void)
+{
+    Profiler_EndScope(Platform_GetElapsedTimeMs());
+}
+
+bool8 Platform_WriteTrace(const char *FileName)
+{
+    return Profiler_WriteTrace(FileName);
+}
+
+
 void Platform_RequestRedraw(void)
 {
     platform_window_dimensions Window = Platform_GetWindowDimensions();
+    profiler_phase Phase = Profiler_SetPhase(PROFILER_PHASE_RENDER, Platform_GetElapsedTimeMs());
     App_OnRedrawRequest(&sAppState, Window.Width, Window.Height);
+    Profiler_SetPhase(PROFILER_PHASE_SWAP, Platform_GetElapsedTimeMs());
     glfwSwapBuffers(sWindow);
+    Profiler_SetPhase(Phase, Platform_GetElapsedTimeMs());
 }
 
 
 
 int main(void)
 {
+    int ThreadCount = sysconf(_SC_NPROCESSORS_ONLN);
+    /* for when the GPU can't keep up and the CPU has to render */
+    WorkQueue_StartThreads(MAX(ThreadCount, 1));
+
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
@@ -211,6 +274,7 @@ int main(void)
         return 1;
     }
     glfwSetFramebufferSizeCallback(sWindow, OnFrameBufferResize);
+    glfwSetWindowRefreshCallback(sWindow, OnWindowRefresh);
     glfwSetScrollCallback(sWindow, OnMouseWheel);
     glfwSetCursorPosCallback(sWindow, OnMouseMove);
     glfwSetKeyCallback(sWindow, OnKeyInput);
@@ -221,33 +285,58 @@ int main(void)
     sAppState = App_OnEntry();
 
     double FrameTimeStart = glfwGetTime();
-    double IdleTimeMs = 0;
+    double LastStatusTime = 0;
     while (!glfwWindowShouldClose(sWindow))
     {
-        double LoopStart = glfwGetTime();
+        Profiler_SetPhase(PROFILER_PHASE_UPDATE, Platform_GetElapsedTimeMs());
         App_OnLoop(&sAppState);
-        double LoopTimeMs = (glfwGetTime() - LoopStart) * 1000.0;
 
         double Now = glfwGetTime();
         double FrameTimeNowS = Now - FrameTimeStart;
-        if (FrameTimeNowS < sFrameTimeTargetS)
+        /* a key is only pressed for the one loop right after its release */
+        memcpy(sLastKeyState, sCurrentKeyState, sizeof sLastKeyState);
+        Profiler_SetPhase(PROFILER_PHASE_IDLE, Platform_GetElapsedTimeMs());
+        if (App_IsIdle(&sAppState))
         {
-            IdleTimeMs = (sFrameTimeTargetS - FrameTimeNowS) * 1000.0;
-            usleep(IdleTimeMs * 1000.0);
+            /* sleep in the event queue instead of polling it until something happens */
+            glfwWaitEvents();
+            FrameTimeStart = glfwGetTime();
         }
         else
         {
-            sFrameTimeMs = FrameTimeNowS * 1000.0;
-            FrameTimeStart = Now;
+            if (FrameTimeNowS < sFrameTimeTargetS)
+            {
+                usleep((sFrameTimeTargetS - FrameTimeNowS) * 1000000.0);
+            }
+            else
+            {
+                sFrameTimeMs = FrameTimeNowS * 1000.0;
+                FrameTimeStart = Now;
+            }
+            Profiler_SetPhase(PROFILER_PHASE_INPUT, Platform_GetElapsedTimeMs());
+            glfwPollEvents();
+        }
+        Profiler_EndFrame(Platform_GetElapsedTimeMs());
+
+        /* printing is a syscall, and the percentiles sort every kept frame */
+        if (glfwGetTime() - LastStatusTime > 0.5)
+        {
+            LastStatusTime = glfwGetTime();
+            frame_time_stats Frames = Profiler_GetStats();
+            const render_stats *Stats = &sAppState.RenderStats;
+            printf("\rt_busy p50|p95|p99: %3.3f|%3.3f|%3.3f, t_frame p50: %3.3f, tier: %s%s %3.3fns/iter, early exits: %2.1f%%, tiles hit|miss: %u|%u      ", 
+                Frames.Busy.P50, 
+                Frames.Busy.P95, 
+                Frames.Busy.P99, 
+                Frames.Frame.P50,
+                Renderer_GetPrecisionName(Stats->Precision),
+                Stats->OnGpu? " (gpu)" : "",
+                Stats->NsPerIteration,
+                Stats->PixelCount? 100.0 * Stats->EarlyExitCount / Stats->PixelCount : 0.0,
+                Stats->TileHitCount, Stats->TileMissCount
+            );
+            fflush(stdout);
         }
-        glfwPollEvents();
-
-        printf("\rt_idle|t_loop|t_frame: %3.3f|%3.3f|%3.3f, fps: %3.3f", 
-            IdleTimeMs, 
-            LoopTimeMs, 
-            sFrameTimeMs, 
-            1000.0 / sFrameTimeMs
-        );
     }
 
     App_OnExit(&sAppState);
@@ -0,0 +1,143 @@
+
+#include <stdlib.h>
+#include <string.h>
+#include "Perturbation.h"
+#include "BigFix.h"
+
+
+void Perturbation_ComputeReference(reference_orbit *Orbit, const render_view *View)
+{
+    int Capacity = View->IterationCount + 1;
+    if (Orbit->Capacity < Capacity)
+    {
+        Orbit->Zx = realloc(Orbit->Zx, Capacity * sizeof(double));
+        Orbit->Zy = realloc(Orbit->Zy, Capacity * sizeof(double));
+        Orbit->Capacity = Capacity;
+        ASSERT(Orbit->Zx && Orbit->Zy, "Out of memory");
+    }
+
+    /* reference point at the center of the view */
+    double PixelX = View->Width / 2;
+    double PixelY = View->Height / 2;
+    bigfix Cx = View->ExactWorldLeft;
+    bigfix Cy = View->ExactWorldBottom;
+    BigFix_AddDouble(&Cx, PixelX * View->ScreenToWorldScaleFactor);
+    BigFix_AddDouble(&Cy, PixelY * View->ScreenToWorldScaleFactor);
+
+    int LimbCount = BigFix_GetLimbCount(View->ScreenToWorldScaleFactor);
+    bool8 SameReference = Orbit->Count > 0 
+        && LimbCount == Orbit->LimbCount
+        && PixelX == Orbit->PixelX && PixelY == Orbit->PixelY
+        && 0 == memcmp(&Cx, &Orbit->Cx, sizeof Cx) 
+        && 0 == memcmp(&Cy, &Orbit->Cy, sizeof Cy);
+    int i = 0;
+    bigfix Zx = { 0 }, Zy = { 0 };
+    if (SameReference)
+    {
+        /* the orbit is the same up to where it stopped, pick up from there */
+        if (Orbit->Escaped)
+            return;
+        i = Orbit->Count - 1;
+        Zx = Orbit->LastZx;
+        Zy = Orbit->LastZy;
+    }
+    else
+    {
+        Orbit->PixelX = PixelX;
+        Orbit->PixelY = PixelY;
+        Orbit->Cx = Cx;
+        Orbit->Cy = Cy;
+        Orbit->LimbCount = LimbCount;
+        Orbit->Escaped = false;
+        Orbit->Zx[0] = 0;
+        Orbit->Zy[0] = 0;
+    }
+
+    while (i < View->IterationCount)
+    {
+        BigFix_SquareAdd(&Zx, &Zy, &Cx, &Cy, LimbCount);
+        i++;
+
+        double X = BigFix_ToDouble(&Zx);
+        double Y = BigFix_ToDouble(&Zy);
+        Orbit->Zx[i] = X;
+        Orbit->Zy[i] = Y;
+        if (X*X + Y*Y >= 4.0)
+        {
+            Orbit->Escaped = true;
+            break;
+        }
+    }
+    Orbit->LastZx = Zx;
+    Orbit->LastZy = Zy;
+    Orbit->Count = i + 1;
+}
+
+void Perturbation_FreeReference(reference_orbit *Orbit)
+{
+    free(Orbit->Zx);
+    free(Orbit->Zy);
+    *Orbit = (reference_orbit) { 0 };
+}
+
+
+void Perturbation_Row(const render_view *View, const reference_orbit *Orbit, kernel_row *Row)
+{
+    double Scale = View->ScreenToWorldScaleFactor;
+    double ReferenceCx = BigFix_ToDouble(&Orbit->Cx);
+    double ReferenceCy = BigFix_ToDouble(&Orbit->Cy);
+    int LastOrbitIndex = Orbit->Count - 1;
+    for (int x = 0; x < Row->Count; x++)
+    {
+        if (Row->Iterations[x] != (u32)Row->StartIteration)
+            continue;
+
+        int PixelX = Row->StartX + (Row->IsColumn? 0 : x);
+        int PixelY = Row->Y + (Row->IsColumn? x : 0);
+        double Dcx = ((double)PixelX + 0.5 - Orbit->PixelX) * Scale;
+        double Dcy = ((double)PixelY + 0.5 - Orbit->PixelY) * Scale;
+        /* c in double is plenty, points that close to the boundary don't escape in any sane iteration count */
+        if (View->SkipsInterior && Kernel_IsInterior(ReferenceCx + Dcx, ReferenceCy + Dcy))
+        {
+            Row->Iterations[x] = View->IterationCount;
+            Row->EarlyExitCount++;
+            Row->SkippedIterationCount += View->IterationCount - Row->StartIteration;
+            continue;
+        }
+        double Dzx = Row->Zx[x], Dzy = Row->Zy[x];
+        int n = Row->OrbitIndex[x]; /* index into the reference orbit */
+        int i;
+        for (i = Row->StartIteration; i < View->IterationCount; i++)
+        {
+            double Zx = Orbit->Zx[n] + Dzx;
+            double Zy = Orbit->Zy[n] + Dzy;
+            double Magnitude = Zx*Zx + Zy*Zy;
+            if (Magnitude >= 4.0)
+                break;
+
+            /* 
+                Rebase onto the start of the orbit (Z_0 = 0) once the pixel's own z gets smaller than its delta,
+                which is where the delta would lose all its precision (the so-called glitches), 
+                or when the reference escaped before this pixel did.
+            */
+            if (Magnitude < Dzx*Dzx + Dzy*Dzy || n == LastOrbitIndex)
+            {
+                Dzx = Zx;
+                Dzy = Zy;
+                n = 0;
+            }
+
+            /* dz' = (2Z + dz)*dz + dc */
+            double Tx = 2.0*Orbit->Zx[n] + Dzx;
+            double Ty = 2.0*Orbit->Zy[n] + Dzy;
+            double NewDzx = Tx*Dzx - Ty*Dzy + Dcx;
+            Dzy = Tx*Dzy + Ty*Dzx + Dcy;
+            Dzx = NewDzx;
+            n++;
+        }
+        Row->Iterations[x] = i;
+        Row->Zx[x] = Dzx;
+        Row->Zy[x] = Dzy;
+        Row->OrbitIndex[x] = n;
+    }
+}
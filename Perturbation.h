@@ -0,0 +1,38 @@
+#ifndef PERTURBATION_H
+#define PERTURBATION_H
+
+#include "Common.h"
+#include "Renderer.h"
+#include "Kernel.h"
+
+
+/* 
+    Orbit of the view's center pixel in full precision, rounded to double.
+    Every other pixel only iterates its small difference to this orbit in double:
+        dz' = 2*Z*dz + dz^2 + dc
+    so the cost per pixel no longer depends on the zoom depth.
+*/
+typedef struct reference_orbit
+{
+    double *Zx, *Zy; /* Z_0 .. Z_(Count - 1), the last one either escaped or hit the iteration count */
+    int Count;
+    int Capacity;
+    double PixelX, PixelY; /* where the reference point is, in pixels */
+    bigfix Cx, Cy; /* the reference point */
+    int LimbCount; /* of the products that iterated it, see BigFix_GetLimbCount() */
+    bigfix LastZx, LastZy; /* Z_(Count - 1) in full precision, to extend the orbit from */
+    bool8 Escaped;
+} reference_orbit;
+
+
+/* 
+    Grows Orbit's buffers as needed, free with Perturbation_FreeReference().
+    When Orbit already has the same reference point, it only iterates what View->IterationCount adds.
+*/
+void Perturbation_ComputeReference(reference_orbit *Orbit, const render_view *View);
+void Perturbation_FreeReference(reference_orbit *Orbit);
+/* same contract as kernel_row_fn, Zx/Zy being dz and OrbitIndex the index n into the orbit */
+void Perturbation_Row(const render_view *View, const reference_orbit *Orbit, kernel_row *Row);
+
+#endif /* PERTURBATION_H */
+
@@ -4,6 +4,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "Common.h"
+#include "BigFix.h"
+#include "Renderer.h"
+#include "TileCache.h"
+#include "Profiler.h"
 #include "glad/glad.h"
 
 
@@ -12,6 +16,10 @@ typedef enum
     PLATFORM_KEY_LEFT_SHIFT,
     PLATFORM_KEY_DOWN_ARROW,
     PLATFORM_KEY_UP_ARROW,
+    PLATFORM_KEY_I,
+    PLATFORM_KEY_M,
+    PLATFORM_KEY_T,
+    PLATFORM_KEY_A,
     PLATFORM_KEY_COUNT,
 } platform_key;
 
@@ -41,22 +49,92 @@ typedef struct
     i32 Width, Height;
 } platform_window_dimensions;
 
+typedef struct
+{
+    /* row 0 is the top row, each pixel is R, G, B, A in memory order */
+    u32 *Pixels;
+    i32 Width, Height;
+} platform_framebuffer;
+
+typedef void platform_work_callback(void *Data);
+
 
 typedef struct 
 {
-    float ScreenToWorldScaleFactor;
-    float WorldBottom, WorldHeight;
-    float WorldLeft, WorldWidth;
+    double ScreenToWorldScaleFactor;
+    /* ScreenToWorldScaleFactor is ZoomBaseScale / 1.1^ZoomLevel, the same every time a zoom level comes back */
+    int ZoomLevel;
+    double ZoomBaseScale;
+    bigfix WorldBottom; /* full precision so that deep zooms can still pan */
+    bigfix WorldLeft;
+    double WorldHeight, WorldWidth;
     int IterationCount;
-    float TimeSinceLastIterationCountChange;
+    double TimeSinceLastIterationCountChange;
+    bool8 SkipsInterior; /* toggled with I, see render_view */
+    float PeriodicityTolerance; /* see render_view */
+    render_method RenderMethod; /* toggled with M */
+    bool8 Supersamples; /* toggled with A, antialiases the view once it has every count, see Renderer_Supersample() */
+    int SupersampleThreshold; /* see Renderer_Supersample() */
     float MouseX, MouseY;
+    bool8 NeedsRedraw; /* the view, iteration count or shaders changed since the last frame */
+    int RedrawWidth, RedrawHeight; /* of the last frame */
+    /* 
+        Dragging moves the view by whole pixels away from where it was at this zoom level, 
+        so that the CPU renderer can keep the pixels still in view.
+    */
+    bool8 HasPanOrigin;
+    bigfix PanOriginLeft, PanOriginBottom;
+    int PanPixelX, PanPixelY;
+    float PanRemainderX, PanRemainderY; /* less than a pixel, waits for the next move */
 
     const char *FragmentShaderFileName;
     const char *VertexShaderFileName;
     float *ColorPalette;
     int ColorPaletteCount;
-    GLuint ShaderProgramID;
+    const char *ColorFragmentShaderFileName;
+    const char *SupersampleFragmentShaderFileName;
+    GLuint ShaderProgramID; /* escape counts into IterationTextures */
+    GLuint ColorShaderProgramID; /* colors IterationTextures on screen, or SumTextures */
+    GLuint SupersampleShaderProgramID; /* more samples of the float views into SumTextures */
     GLuint VAO;
+    /* 
+        Counts of IterationView, from the shader or the CPU renderer.
+        Only recomputed when the view or a higher iteration count needs it, 
+        every frame just colors them.
+        They get there a slice at a time: every frame takes the pixels still iterating a few more iterations, 
+        so that no frame takes long whatever the iteration count. IterationView has the count reached so far.
+        The shader's slices go back and forth between two sets of textures, one read and the other written.
+    */
+    GLuint IterationTextures[2];
+    GLuint StateTextures[2]; /* Zx, Zy, SavedZx, SavedZy of every pixel of the shader, to pick up from */
+    GLuint IterationFramebuffers[2];
+    int IterationTextureIndex; /* the latest counts */
+    int IterationTextureWidth, IterationTextureHeight;
+    bool8 HasIterations;
+    render_view IterationView;
+    /* iterations per frame of every pixel still iterating, follow the time the slices take, the CPU's at full resolution */
+    int CpuIterationSlice, GpuIterationSlice;
+    int MovingSampleShift; /* of the CPU frames while the view moves, see render_view */
+    GLuint SliceQuery; /* GPU time of a slice, read back frames later */
+    bool8 IsSliceQueryPending;
+    int QueriedSlice;
+    bool8 IsSoftwareRendered;
+    iteration_buffer IterationBuffer; /* of the CPU frames, so that they only iterate what changed */
+    tile_cache TileCache; /* of the CPU frames of every tier but perturbation, which only use IterationBuffer */
+    /* 
+        Colors of the samples of every pixel of SumView, added up, with their count (negative once they differ).
+        The shader's samples go back and forth between the two textures like the counts, 
+        the CPU's come averaged already from SupersampleBuffer, as a count of 1.
+    */
+    GLuint SumTextures[2];
+    GLuint SumFramebuffers[2];
+    int SumTextureIndex; /* the latest sums */
+    bool8 HasSums;
+    render_view SumView;
+    int SumSampleIndex; /* the next one to take, RENDERER_SUPERSAMPLE_COUNT once every pixel has all it gets */
+    supersample_buffer SupersampleBuffer; /* of the CPU frames */
+    u32 *SupersamplePixels; /* the CPU's colors on their way to SumTextures */
+    render_stats RenderStats; /* of the last frame */
 } app_state;
 
 
@@ -73,6 +151,8 @@ void App_OnMouseEvent(app_state *State, const mouse_data *Mouse);
 void App_OnRedrawRequest(app_state *State, int Width, int Height);
 /* getter */
 const char *App_GetName(app_state *State);
+/* nothing changes before the next input event, the platform can block until then */
+bool8 App_IsIdle(app_state *State);
 
 
 // ==========================================
@@ -89,10 +169,25 @@ double Platform_GetElapsedTimeMs(void); /* starting from right before App_OnEntr
 double Platform_GetFrameTimeMs(void);
 bool8 Platform_IsKeyDown(platform_key Key);
 bool8 Platform_IsKeyPressed(platform_key Key);
+/* percentiles of the last frames, see frame_time_stats */
+frame_time_stats Platform_GetFrameTimeStats(void);
+/* Pixels is NULL when the platform presents through OpenGL instead */
+platform_framebuffer Platform_GetSoftwareFramebuffer(void);
+int Platform_GetThreadCount(void); /* including the main thread */
+
+/* profiling, main thread only: the app's own scopes go next to the platform's phases in the trace */
+void Platform_BeginScope(const char *Name);
+void Platform_EndScope(void);
+bool8 Platform_WriteTrace(const char *FileName);
 
 /* event request */
 void Platform_RequestRedraw(void);
 
+/* work queue, only the main thread may push or complete work */
+void Platform_PushWork(platform_work_callback *Callback, void *Data);
+/* the main thread helps with the queued work until all of it is done */
+void Platform_CompleteAllWork(void);
+
 /* misc */
 int Platform_BeginTempMemory(void);
 char *Platform_PushNullTerminatedFileContentBlocking(int *PlatformMemory, const char *FileName);
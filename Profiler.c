@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Profiler.h"
+
+
+typedef struct profiler_frame
+{
+    double PhaseMs[PROFILER_PHASE_COUNT];
+} profiler_frame;
+
+typedef struct profiler_event
+{
+    const char *Name;
+    double StartMs, DurationMs;
+    bool8 IsScope; /* scopes get a track of their own, they can span phases */
+} profiler_event;
+
+static profiler_frame sProfiler_Frames[PROFILER_FRAME_COUNT];
+static i64 sProfiler_FrameCount; /* ever ended, the ring has the last PROFILER_FRAME_COUNT */
+static profiler_frame sProfiler_CurrentFrame;
+static profiler_phase sProfiler_Phase;
+static double sProfiler_PhaseStartMs;
+
+static profiler_event sProfiler_Events[PROFILER_EVENT_COUNT];
+static i64 sProfiler_EventCount; /* ever pushed, the ring has the last PROFILER_EVENT_COUNT */
+static const char *sProfiler_ScopeNames[PROFILER_MAX_SCOPE_DEPTH];
+static double sProfiler_ScopeStartMs[PROFILER_MAX_SCOPE_DEPTH];
+static int sProfiler_ScopeDepth;
+
+static double sProfiler_SortScratch[PROFILER_FRAME_COUNT];
+
+
+static void Profiler_PushEvent(const char *Name, double StartMs, double DurationMs, bool8 IsScope)
+{
+    sProfiler_Events[sProfiler_EventCount % PROFILER_EVENT_COUNT] = (profiler_event) {
+        .Name = Name,
+        .StartMs = StartMs,
+        .DurationMs = DurationMs,
+        .IsScope = IsScope,
+    };
+    sProfiler_EventCount++;
+}
+
+static void Profiler_EndPhase(double NowMs)
+{
+    double DurationMs = NowMs - sProfiler_PhaseStartMs;
+    sProfiler_CurrentFrame.PhaseMs[sProfiler_Phase] += DurationMs;
+    if (DurationMs > 0)
+    {
+        Profiler_PushEvent(Profiler_GetPhaseName(sProfiler_Phase), sProfiler_PhaseStartMs, DurationMs, false);
+    }
+    sProfiler_PhaseStartMs = NowMs;
+}
+
+profiler_phase Profiler_SetPhase(profiler_phase Phase, double NowMs)
+{
+    profiler_phase Previous = sProfiler_Phase;
+    if (Phase != Previous)
+    {
+        Profiler_EndPhase(NowMs);
+        sProfiler_Phase = Phase;
+    }
+    return Previous;
+}
+
+void Profiler_EndFrame(double NowMs)
+{
+    Profiler_EndPhase(NowMs);
+    sProfiler_Frames[sProfiler_FrameCount % PROFILER_FRAME_COUNT] = sProfiler_CurrentFrame;
+    sProfiler_FrameCount++;
+    sProfiler_CurrentFrame = (profiler_frame) { 0 };
+}
+
+void Profiler_BeginScope(const char *Name, double NowMs)
+{
+    ASSERT(sProfiler_ScopeDepth < PROFILER_MAX_SCOPE_DEPTH, "Scopes nest too deep");
+    sProfiler_ScopeNames[sProfiler_ScopeDepth] = Name;
+    sProfiler_ScopeStartMs[sProfiler_ScopeDepth] = NowMs;
+    sProfiler_ScopeDepth++;
+}
+
+void Profiler_EndScope(double NowMs)
+{
+    ASSERT(sProfiler_ScopeDepth > 0, "No scope to end");
+    sProfiler_ScopeDepth--;
+    double StartMs = sProfiler_ScopeStartMs[sProfiler_ScopeDepth];
+    Profiler_PushEvent(sProfiler_ScopeNames[sProfiler_ScopeDepth], StartMs, NowMs - StartMs, true);
+}
+
+
+static int Profiler_CompareDoubles(const void *A, const void *B)
+{
+    double a = *(const double *)A, b = *(const double *)B;
+    return (a > b) - (a < b);
+}
+
+/* of the sum of the phases in PhaseMask over the kept frames, nearest rank */
+static profiler_percentiles Profiler_GetPercentiles(int FrameCount, u32 PhaseMask)
+{
+    for (int i = 0; i < FrameCount; i++)
+    {
+        double Ms = 0;
+        for (int Phase = 0; Phase < PROFILER_PHASE_COUNT; Phase++)
+        {
+            Ms += PhaseMask & (1u << Phase)? sProfiler_Frames[i].PhaseMs[Phase] : 0;
+        }
+        sProfiler_SortScratch[i] = Ms;
+    }
+    qsort(sProfiler_SortScratch, FrameCount, sizeof(sProfiler_SortScratch[0]), Profiler_CompareDoubles);
+
+    int Percents[3] = { 50, 95, 99 };
+    double Values[3];
+    for (int i = 0; i < 3; i++)
+    {
+        int Rank = (Percents[i]*FrameCount + 99) / 100;
+        Values[i] = sProfiler_SortScratch[MIN(MAX(Rank, 1), FrameCount) - 1];
+    }
+    return (profiler_percentiles) { .P50 = Values[0], .P95 = Values[1], .P99 = Values[2] };
+}
+
+frame_time_stats Profiler_GetStats(void)
+{
+    frame_time_stats Stats = {
+        .FrameCount = MIN(sProfiler_FrameCount, PROFILER_FRAME_COUNT),
+    };
+    if (Stats.FrameCount == 0)
+        return Stats;
+
+    u32 AllPhases = (1u << PROFILER_PHASE_COUNT) - 1;
+    Stats.Frame = Profiler_GetPercentiles(Stats.FrameCount, AllPhases);
+    Stats.Busy = Profiler_GetPercentiles(Stats.FrameCount, AllPhases & ~(1u << PROFILER_PHASE_IDLE));
+    for (int Phase = 0; Phase < PROFILER_PHASE_COUNT; Phase++)
+    {
+        Stats.Phases[Phase] = Profiler_GetPercentiles(Stats.FrameCount, 1u << Phase);
+    }
+    return Stats;
+}
+
+bool8 Profiler_WriteTrace(const char *FileName)
+{
+    FILE *f = fopen(FileName, "wb");
+    if (!f)
+    {
+        return false;
+    }
+
+    /* ts and dur are in microseconds */
+    fprintf(f,
+        "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n"
+        "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"phases\"}},\n"
+        "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"scopes\"}}"
+    );
+    i64 FirstEvent = MAX(sProfiler_EventCount - PROFILER_EVENT_COUNT, 0);
+    for (i64 i = FirstEvent; i < sProfiler_EventCount; i++)
+    {
+        const profiler_event *Event = &sProfiler_Events[i % PROFILER_EVENT_COUNT];
+        fprintf(f, ",\n{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 1, \"tid\": %d}",
+            Event->Name,
+            Event->StartMs * 1000.0,
+            Event->DurationMs * 1000.0,
+            Event->IsScope? 2 : 1
+        );
+    }
+    fprintf(f, "\n]}\n");
+
+    bool8 Ok = !ferror(f);
+    return fclose(f) == 0 && Ok;
+}
+
+const char *Profiler_GetPhaseName(profiler_phase Phase)
+{
+    static const char *Names[PROFILER_PHASE_COUNT] = {
+        [PROFILER_PHASE_INPUT] = "input",
+        [PROFILER_PHASE_UPDATE] = "update",
+        [PROFILER_PHASE_RENDER] = "render",
+        [PROFILER_PHASE_SWAP] = "swap",
+        [PROFILER_PHASE_IDLE] = "idle",
+    };
+    return Names[Phase];
+}
@@ -0,0 +1,57 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include "Common.h"
+
+/* frames kept for the percentiles, and trace events kept for Profiler_WriteTrace() */
+#define PROFILER_FRAME_COUNT 512
+#define PROFILER_EVENT_COUNT 8192
+#define PROFILER_MAX_SCOPE_DEPTH 32
+
+
+/* what the main thread of the platform is doing, every moment of a frame goes to exactly one */
+typedef enum
+{
+    PROFILER_PHASE_INPUT, /* events, and the app's handlers of them */
+    PROFILER_PHASE_UPDATE, /* App_OnLoop() aside from the redraw */
+    PROFILER_PHASE_RENDER, /* App_OnRedrawRequest() */
+    PROFILER_PHASE_SWAP,
+    PROFILER_PHASE_IDLE, /* sleeping to the frame time target, or blocked until the next event */
+    PROFILER_PHASE_COUNT,
+} profiler_phase;
+
+typedef struct profiler_percentiles
+{
+    double P50, P95, P99;
+} profiler_percentiles;
+
+/* in ms, over the last FrameCount frames */
+typedef struct frame_time_stats
+{
+    int FrameCount; /* up to PROFILER_FRAME_COUNT */
+    profiler_percentiles Frame;
+    profiler_percentiles Busy; /* the frame without PROFILER_PHASE_IDLE */
+    profiler_percentiles Phases[PROFILER_PHASE_COUNT];
+} frame_time_stats;
+
+
+/*
+    Fixed-size rings, nothing is allocated. Main thread only,
+    times are ms from any fixed point, like Platform_GetElapsedTimeMs().
+*/
+/* the time from the last call goes to the phase that was running, returns it */
+profiler_phase Profiler_SetPhase(profiler_phase Phase, double NowMs);
+/* the frame ends at NowMs and the next one starts there, in the same phase */
+void Profiler_EndFrame(double NowMs);
+/* nest, Name must stay valid until the trace is written */
+void Profiler_BeginScope(const char *Name, double NowMs);
+void Profiler_EndScope(double NowMs);
+
+/* sorts copies of the frame times, only call it once in a while */
+frame_time_stats Profiler_GetStats(void);
+/* the kept phases and scopes in Chrome's trace_event format, for chrome://tracing or Perfetto */
+bool8 Profiler_WriteTrace(const char *FileName);
+const char *Profiler_GetPhaseName(profiler_phase Phase);
+
+#endif /* PROFILER_H */
+
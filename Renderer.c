@@ -0,0 +1,1053 @@
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Platform.h"
+#include "Renderer.h"
+#include "Kernel.h"
+#include "Perturbation.h"
+
+#define RENDERER_MAX_PALETTE_SIZE 256
+
+/* supersample_buffer's SampleCounts, the count in the low bits */
+#define RENDERER_SAMPLE_COUNT_MASK 0x1F
+#define RENDERER_SAMPLES_REFINE 0x40 /* the pixel takes more samples than its center */
+#define RENDERER_SAMPLES_DIFFER 0x80 /* and the rotated grid's didn't all get one color */
+
+static reference_orbit sRenderer_Orbit;
+static render_stats sRenderer_Stats;
+/* 
+    ns per iteration, starts as a guess from an AVX-512 machine 
+    and follows the measurements of the frames that used the tier 
+*/
+static double sRenderer_NsPerIteration[RENDER_PRECISION_COUNT] = {
+    [RENDER_PRECISION_FLOAT] = 0.4,
+    [RENDER_PRECISION_DOUBLE] = 0.8,
+    [RENDER_PRECISION_DOUBLE_DOUBLE] = 5.5,
+    [RENDER_PRECISION_PERTURBATION] = 6.0,
+};
+/* 
+    Of every sample after the center, in 64ths of a pixel from it: 
+    a rotated grid for the ones every refined pixel takes, then the other cells of a 4x4 grid, jittered, farthest first.
+*/
+static const i8 sRenderer_SampleOffsets[RENDERER_SUPERSAMPLE_COUNT - 1][2] = {
+    { -24, 8 }, { -8, -24 }, { 8, 24 }, { 24, -8 },
+    { -25, -28 }, { 8, -20 }, { 18, -29 }, { -22, -13 }, { 23, 11 }, { -30, 26 }, 
+    { -11, 18 }, { 19, 24 }, { -8, -13 }, { 5, -13 }, { -6, 8 },
+};
+
+
+typedef struct renderer_job
+{
+    const render_view *View;
+    iteration_buffer *Buffer;
+    kernel_row_fn *RowFunction;
+    const reference_orbit *Orbit; /* perturbation only */
+    int MinX, MinY, MaxX, MaxY; /* the part of the view to go over */
+    bool8 StartsOver; /* Buffer holds nothing of it yet */
+    bool8 Iterates; /* otherwise Buffer already has every count View needs */
+    bool8 Fills; /* pixels that aren't samples take their sample's count, see render_view */
+    supersample_buffer *Supersamples; /* goes over Buffer's counts for Renderer_Supersample() instead */
+    int SampleIndex; /* of the round, 0 sets the centers, RENDERER_SUPERSAMPLE_COUNT only colors */
+    int Threshold;
+    int StartIteration;
+    u32 *Pixels;
+    u32 Palette[RENDERER_MAX_PALETTE_SIZE];
+    int PaletteSize;
+    int TileCountX;
+    i32 TileCount;
+    volatile i32 NextTile;
+    volatile i64 IterationCount;
+    volatile i64 PixelCount;
+    volatile i64 EarlyExitCount;
+} renderer_job;
+
+/* what a tile did, added to the job's counts once it is done */
+typedef struct renderer_tally
+{
+    i64 IterationCount;
+    i64 PixelCount;
+    i64 EarlyExitCount;
+} renderer_tally;
+
+
+static u32 Renderer_PackColor(float R, float G, float B)
+{
+    u32 Red = R * 255.0f + 0.5f;
+    u32 Green = G * 255.0f + 0.5f;
+    u32 Blue = B * 255.0f + 0.5f;
+    return Red | Green << 8 | Blue << 16 | (u32)0xFF << 24;
+}
+
+/* 
+    The kernels only do whole vectors and write back every lane, 
+    so they get a copy of the row, padded with lanes that never match StartIteration.
+*/
+typedef struct renderer_row
+{
+    u32 Iterations[RENDERER_TILE_SIZE];
+    double Zx[RENDERER_TILE_SIZE], Zy[RENDERER_TILE_SIZE];
+    double SavedZx[RENDERER_TILE_SIZE], SavedZy[RENDERER_TILE_SIZE];
+    double ZxLo[RENDERER_TILE_SIZE], ZyLo[RENDERER_TILE_SIZE];
+    i32 OrbitIndex[RENDERER_TILE_SIZE];
+} renderer_row;
+
+static void Renderer_AddColor(u16 *Sum, u32 Color)
+{
+    Sum[0] += Color & 0xFF;
+    Sum[1] += Color >> 8 & 0xFF;
+    Sum[2] += Color >> 16 & 0xFF;
+}
+
+/* whether Sum, which holds Center and Count more samples, is Center and Count times Color */
+static bool8 Renderer_IsSumOf(const u16 *Sum, u32 Center, u32 Color, int Count)
+{
+    for (int Channel = 0; Channel < 3; Channel++)
+    {
+        int Shift = 8*Channel;
+        if (Sum[Channel] - (Center >> Shift & 0xFF) != Count * (Color >> Shift & 0xFF))
+            return false;
+    }
+    return true;
+}
+
+/* whether line i of the view (a column or a row) has samples, Offset is the view's PixelOffsetX/Y */
+static bool8 Renderer_IsSampleLine(int i, int Offset, int SampleShift)
+{
+    return ((i + Offset) & ((1 << SampleShift) - 1)) == 0;
+}
+
+/* the line that line i takes its count from, the next one when its own is out of the Count lines of the view */
+static int Renderer_GetSampleLine(int i, int Offset, int SampleShift, int Count)
+{
+    int Size = 1 << SampleShift;
+    int Sample = i - ((i + Offset) & (Size - 1));
+    if (Sample < 0)
+    {
+        Sample += Size;
+    }
+    return MIN(Sample, Count - 1);
+}
+
+static u32 Renderer_GetColor(const renderer_job *Job, u32 Iterations)
+{
+    if (Iterations < (u32)Job->View->IterationCount)
+        return Job->Palette[Iterations % Job->PaletteSize];
+    return 0xFF000000;
+}
+
+static void Renderer_ClearPixel(renderer_row *Row, int x, u32 Iterations)
+{
+    Row->Iterations[x] = Iterations;
+    Row->Zx[x] = 0;
+    Row->Zy[x] = 0;
+    Row->SavedZx[x] = 0;
+    Row->SavedZy[x] = 0;
+    Row->ZxLo[x] = 0;
+    Row->ZyLo[x] = 0;
+    Row->OrbitIndex[x] = 0;
+}
+
+static void Renderer_RunKernel(renderer_job *Job, renderer_row *Row, int StartX, int Y, int PaddedCount, bool8 IsColumn, int StartIteration, renderer_tally *Tally)
+{
+    const render_view *View = Job->View;
+    /* the kernels see the view's pixels as counted from WorldLeft/WorldBottom */
+    kernel_row KernelRow = {
+        .StartX = StartX + View->PixelOffsetX,
+        .Y = Y + View->PixelOffsetY,
+        .Count = PaddedCount,
+        .IsColumn = IsColumn,
+        .StartIteration = StartIteration,
+        .Iterations = Row->Iterations,
+        .Zx = Row->Zx, 
+        .Zy = Row->Zy,
+        .ZxLo = Row->ZxLo, 
+        .ZyLo = Row->ZyLo,
+        .OrbitIndex = Row->OrbitIndex,
+        .SavedZx = Row->SavedZx,
+        .SavedZy = Row->SavedZy,
+    };
+    for (int x = 0; x < PaddedCount; x++)
+    {
+        Tally->PixelCount += Row->Iterations[x] == (u32)StartIteration;
+    }
+    if (Job->Orbit)
+    {
+        Perturbation_Row(View, Job->Orbit, &KernelRow);
+    }
+    else
+    {
+        Job->RowFunction(View, &KernelRow);
+    }
+    Tally->EarlyExitCount += KernelRow.EarlyExitCount;
+    Tally->IterationCount -= KernelRow.SkippedIterationCount;
+}
+
+/* Count pixels from (StartX, Y) going right, or up for a column, StartsOver ignores what Buffer has for them */
+static void Renderer_IterateRow(renderer_job *Job, int StartX, int Y, int Count, bool8 IsColumn, bool8 StartsOver, renderer_tally *Tally)
+{
+    const render_view *View = Job->View;
+    iteration_buffer *Buffer = Job->Buffer;
+    size_t Offset = (size_t)Y * View->Width + StartX;
+    size_t Stride = IsColumn? View->Width : 1;
+    bool8 IsDoubleDouble = View->Precision == RENDER_PRECISION_DOUBLE_DOUBLE;
+    bool8 IsPerturbation = View->Precision == RENDER_PRECISION_PERTURBATION;
+
+    renderer_row Row;
+    renderer_row Guessed; /* pixels filled in by Renderer_GuessRect(), only active when HasGuesses */
+    bool8 HasGuesses = false;
+    int PaddedCount = (Count + KERNEL_MAX_LANE_COUNT - 1) / KERNEL_MAX_LANE_COUNT * KERNEL_MAX_LANE_COUNT;
+    for (int x = 0; x < PaddedCount; x++)
+    {
+        /* pixels that aren't samples are as good as padding */
+        bool8 IsSample = x < Count 
+            && Renderer_IsSampleLine(StartX + (IsColumn? 0 : x), View->PixelOffsetX, View->SampleShift)
+            && Renderer_IsSampleLine(Y + (IsColumn? x : 0), View->PixelOffsetY, View->SampleShift);
+        Renderer_ClearPixel(&Row, x, IsSample? 0 : UINT32_MAX);
+        if (!IsSample || StartsOver)
+            continue;
+
+        if (Buffer->Iterations[Offset + x*Stride] == (u32)Job->StartIteration && isnan(Buffer->Zx[Offset + x*Stride]))
+        {
+            /* a guess has no z to continue from, it starts over from 0 in a pass of its own */
+            if (!HasGuesses)
+            {
+                for (int i = 0; i < PaddedCount; i++)
+                {
+                    Renderer_ClearPixel(&Guessed, i, UINT32_MAX);
+                }
+                HasGuesses = true;
+            }
+            Guessed.Iterations[x] = 0;
+            continue;
+        }
+        Row.Iterations[x] = Buffer->Iterations[Offset + x*Stride];
+        Row.Zx[x] = Buffer->Zx[Offset + x*Stride];
+        Row.Zy[x] = Buffer->Zy[Offset + x*Stride];
+        Row.SavedZx[x] = Buffer->SavedZx[Offset + x*Stride];
+        Row.SavedZy[x] = Buffer->SavedZy[Offset + x*Stride];
+        Row.ZxLo[x] = IsDoubleDouble? Buffer->ZxLo[Offset + x*Stride] : 0;
+        Row.ZyLo[x] = IsDoubleDouble? Buffer->ZyLo[Offset + x*Stride] : 0;
+        Row.OrbitIndex[x] = IsPerturbation? Buffer->OrbitIndex[Offset + x*Stride] : 0;
+    }
+
+    if (HasGuesses)
+    {
+        Renderer_RunKernel(Job, &Guessed, StartX, Y, PaddedCount, IsColumn, 0, Tally);
+        for (int x = 0; x < Count; x++)
+        {
+            if (Guessed.Iterations[x] != UINT32_MAX)
+            {
+                /* the next pass leaves it be unless it escaped right at StartIteration, which ends it again */
+                Row.Iterations[x] = Guessed.Iterations[x];
+                Row.Zx[x] = Guessed.Zx[x];
+                Row.Zy[x] = Guessed.Zy[x];
+                Row.SavedZx[x] = Guessed.SavedZx[x];
+                Row.SavedZy[x] = Guessed.SavedZy[x];
+                Row.ZxLo[x] = Guessed.ZxLo[x];
+                Row.ZyLo[x] = Guessed.ZyLo[x];
+                Row.OrbitIndex[x] = Guessed.OrbitIndex[x];
+            }
+        }
+    }
+    Renderer_RunKernel(Job, &Row, StartX, Y, PaddedCount, IsColumn, Job->StartIteration, Tally);
+
+    /* only what this frame adds */
+    for (int x = 0; x < Count; x++)
+    {
+        if (Row.Iterations[x] == UINT32_MAX)
+            continue;
+
+        bool8 WasGuessed = HasGuesses && Guessed.Iterations[x] != UINT32_MAX;
+        Tally->IterationCount += Row.Iterations[x] - (StartsOver || WasGuessed? 0 : (i64)Buffer->Iterations[Offset + x*Stride]);
+        Buffer->Iterations[Offset + x*Stride] = Row.Iterations[x];
+        Buffer->Zx[Offset + x*Stride] = Row.Zx[x];
+        Buffer->Zy[Offset + x*Stride] = Row.Zy[x];
+        Buffer->SavedZx[Offset + x*Stride] = Row.SavedZx[x];
+        Buffer->SavedZy[Offset + x*Stride] = Row.SavedZy[x];
+        if (IsDoubleDouble)
+        {
+            Buffer->ZxLo[Offset + x*Stride] = Row.ZxLo[x];
+            Buffer->ZyLo[Offset + x*Stride] = Row.ZyLo[x];
+        }
+        if (IsPerturbation)
+        {
+            Buffer->OrbitIndex[Offset + x*Stride] = Row.OrbitIndex[x];
+        }
+    }
+}
+
+/* 
+    Mariani-Silver: the border of the rectangle is done already.
+    When all of it has the same count the inside is taken to have it too, 
+    which always holds for the set itself (it is connected) and almost always for the bands around it.
+    Otherwise it is cut in two across its longer side and both halves go again.
+    Filled pixels get a NaN z, which makes Renderer_IterateRow() start them over when they need continuing.
+*/
+static void Renderer_GuessRect(renderer_job *Job, int MinX, int MinY, int MaxX, int MaxY, renderer_tally *Tally)
+{
+    if (MaxX - MinX <= 2 || MaxY - MinY <= 2)
+        return;
+
+    iteration_buffer *Buffer = Job->Buffer;
+    int Width = Job->View->Width;
+    u32 Count = Buffer->Iterations[(size_t)MinY * Width + MinX];
+    bool8 IsUniform = true;
+    for (int x = MinX; x < MaxX && IsUniform; x++)
+    {
+        IsUniform = Buffer->Iterations[(size_t)MinY * Width + x] == Count 
+            && Buffer->Iterations[(size_t)(MaxY - 1) * Width + x] == Count;
+    }
+    for (int y = MinY + 1; y < MaxY - 1 && IsUniform; y++)
+    {
+        IsUniform = Buffer->Iterations[(size_t)y * Width + MinX] == Count 
+            && Buffer->Iterations[(size_t)y * Width + MaxX - 1] == Count;
+    }
+
+    if (IsUniform)
+    {
+        for (int y = MinY + 1; y < MaxY - 1; y++)
+        {
+            for (int x = MinX + 1; x < MaxX - 1; x++)
+            {
+                size_t i = (size_t)y * Width + x;
+                /* the pixels that were already done keep their count */
+                if (Buffer->Iterations[i] == (u32)Job->StartIteration)
+                {
+                    Buffer->Iterations[i] = Count;
+                    Buffer->Zx[i] = NAN;
+                    Buffer->Zy[i] = NAN;
+                }
+            }
+        }
+    }
+    else if (MaxX - MinX <= KERNEL_MAX_LANE_COUNT + 2 && MaxY - MinY <= KERNEL_MAX_LANE_COUNT + 2)
+    {
+        /* the inside fits the widest vector, more borders would only leave its lanes empty */
+        for (int y = MinY + 1; y < MaxY - 1; y++)
+        {
+            Renderer_IterateRow(Job, MinX + 1, y, MaxX - MinX - 2, false, false, Tally);
+        }
+    }
+    else if (MaxX - MinX >= MaxY - MinY)
+    {
+        int MidX = (MinX + MaxX) / 2;
+        Renderer_IterateRow(Job, MidX, MinY + 1, MaxY - MinY - 2, true, false, Tally);
+        Renderer_GuessRect(Job, MinX, MinY, MidX + 1, MaxY, Tally);
+        Renderer_GuessRect(Job, MidX, MinY, MaxX, MaxY, Tally);
+    }
+    else
+    {
+        int MidY = (MinY + MaxY) / 2;
+        Renderer_IterateRow(Job, MinX + 1, MidY, MaxX - MinX - 2, false, false, Tally);
+        Renderer_GuessRect(Job, MinX, MinY, MaxX, MidY + 1, Tally);
+        Renderer_GuessRect(Job, MinX, MidY, MaxX, MaxY, Tally);
+    }
+}
+
+static void Renderer_GuessTile(renderer_job *Job, int MinX, int MinY, int MaxX, int MaxY, renderer_tally *Tally)
+{
+    iteration_buffer *Buffer = Job->Buffer;
+    int Width = Job->View->Width;
+    if (Job->StartsOver)
+    {
+        /* from here on the tile continues from z = 0 like any other, so that the rows can tell what is done */
+        for (int y = MinY; y < MaxY; y++)
+        {
+            for (int x = MinX; x < MaxX; x++)
+            {
+                size_t i = (size_t)y * Width + x;
+                Buffer->Iterations[i] = 0;
+                Buffer->Zx[i] = 0;
+                Buffer->Zy[i] = 0;
+                Buffer->SavedZx[i] = 0;
+                Buffer->SavedZy[i] = 0;
+                if (Buffer->ZxLo)
+                {
+                    Buffer->ZxLo[i] = 0;
+                    Buffer->ZyLo[i] = 0;
+                }
+                if (Buffer->OrbitIndex)
+                {
+                    Buffer->OrbitIndex[i] = 0;
+                }
+            }
+        }
+    }
+
+    Renderer_IterateRow(Job, MinX, MinY, MaxX - MinX, false, false, Tally);
+    if (MaxY - MinY > 1)
+    {
+        Renderer_IterateRow(Job, MinX, MaxY - 1, MaxX - MinX, false, false, Tally);
+    }
+    Renderer_IterateRow(Job, MinX, MinY + 1, MaxY - MinY - 2, true, false, Tally);
+    if (MaxX - MinX > 1)
+    {
+        Renderer_IterateRow(Job, MaxX - 1, MinY + 1, MaxY - MinY - 2, true, false, Tally);
+    }
+    Renderer_GuessRect(Job, MinX, MinY, MaxX, MaxY, Tally);
+}
+
+static void Renderer_RenderTile(renderer_job *Job, int TileX, int TileY)
+{
+    const render_view *View = Job->View;
+    int StartX = Job->MinX + TileX * RENDERER_TILE_SIZE;
+    int StartY = Job->MinY + TileY * RENDERER_TILE_SIZE;
+    int EndX = MIN(StartX + RENDERER_TILE_SIZE, Job->MaxX);
+    int EndY = MIN(StartY + RENDERER_TILE_SIZE, Job->MaxY);
+    renderer_tally Tally = { 0 };
+
+    /* the borders of coarse samples say nothing about the pixels in between, they only go brute force */
+    bool8 Guesses = View->Method == RENDER_METHOD_MARIANI_SILVER && View->SampleShift == 0;
+    if (Job->Iterates && Guesses)
+    {
+        Renderer_GuessTile(Job, StartX, StartY, EndX, EndY, &Tally);
+    }
+    for (int y = StartY; y < EndY; y++)
+    {
+        if (Job->Iterates && !Guesses && Renderer_IsSampleLine(y, View->PixelOffsetY, View->SampleShift))
+        {
+            Renderer_IterateRow(Job, StartX, y, EndX - StartX, false, Job->StartsOver, &Tally);
+        }
+
+        if (Job->Fills)
+        {
+            /* only reads samples, which no tile writes in this pass */
+            u32 *Iterations = Job->Buffer->Iterations;
+            size_t SampleRow = (size_t)Renderer_GetSampleLine(y, View->PixelOffsetY, View->SampleShift, View->Height) * View->Width;
+            for (int x = StartX; x < EndX; x++)
+            {
+                size_t Sample = SampleRow + Renderer_GetSampleLine(x, View->PixelOffsetX, View->SampleShift, View->Width);
+                size_t i = (size_t)y * View->Width + x;
+                if (Sample != i)
+                {
+                    Iterations[i] = Iterations[Sample];
+                }
+            }
+        }
+
+        if (Job->Pixels)
+        {
+            /* y goes up like gl_FragCoord, the framebuffer's row 0 is the top row */
+            const u32 *Iterations = Job->Buffer->Iterations + (size_t)y * View->Width + StartX;
+            u32 *Pixels = Job->Pixels + (size_t)(View->Height - 1 - y) * View->Width + StartX;
+            for (int x = 0; x < EndX - StartX; x++)
+            {
+                Pixels[x] = Renderer_GetColor(Job, Iterations[x]);
+            }
+        }
+    }
+    AtomicAddI64(&Job->IterationCount, Tally.IterationCount);
+    AtomicAddI64(&Job->PixelCount, Tally.PixelCount);
+    AtomicAddI64(&Job->EarlyExitCount, Tally.EarlyExitCount);
+}
+
+/* the next sample of the pixels from (StartX, Y) going right that are still refining, see Renderer_Supersample() */
+static void Renderer_SampleRow(renderer_job *Job, int StartX, int Y, int Count, renderer_tally *Tally)
+{
+    const render_view *View = Job->View;
+    supersample_buffer *Buffer = Job->Supersamples;
+    size_t Offset = (size_t)Y * View->Width + StartX;
+    bool8 TakesAll = Job->Threshold < 0 || Job->SampleIndex < RENDERER_SUPERSAMPLE_MIN_COUNT;
+
+    renderer_row Row;
+    bool8 HasSamples = false;
+    int PaddedCount = (Count + KERNEL_MAX_LANE_COUNT - 1) / KERNEL_MAX_LANE_COUNT * KERNEL_MAX_LANE_COUNT;
+    for (int x = 0; x < PaddedCount; x++)
+    {
+        u8 Samples = x < Count? Buffer->SampleCounts[Offset + x] : 0;
+        bool8 Takes = (Samples & RENDERER_SAMPLES_REFINE) && (TakesAll || (Samples & RENDERER_SAMPLES_DIFFER));
+        Renderer_ClearPixel(&Row, x, Takes? 0 : UINT32_MAX);
+        HasSamples = HasSamples || Takes;
+    }
+    if (!HasSamples)
+        return;
+
+    Renderer_RunKernel(Job, &Row, StartX, Y, PaddedCount, false, 0, Tally);
+    for (int x = 0; x < Count; x++)
+    {
+        if (Row.Iterations[x] == UINT32_MAX)
+            continue;
+
+        /* 
+            the rotated grid disagrees once a sample doesn't get the color of the ones before it, 
+            which make up all of the sum but the center until then 
+        */
+        size_t i = Offset + x;
+        u32 Color = Renderer_GetColor(Job, Row.Iterations[x]);
+        u32 Center = Renderer_GetColor(Job, Job->Buffer->Iterations[i]);
+        int Before = Job->SampleIndex - 1;
+        bool8 Differs = Before > 0 && Job->SampleIndex < RENDERER_SUPERSAMPLE_MIN_COUNT 
+            && !Renderer_IsSumOf(Buffer->Sums + 3*i, Center, Color, Before);
+        Renderer_AddColor(Buffer->Sums + 3*i, Color);
+        Buffer->SampleCounts[i] = (Buffer->SampleCounts[i] + 1) | (Differs? RENDERER_SAMPLES_DIFFER : 0);
+        Tally->IterationCount += Row.Iterations[x];
+    }
+}
+
+/* 
+    A round of Renderer_Supersample() over one tile: 
+    the centers and which pixels refine at sample 0, one more sample of the pixels still refining after that, 
+    and the average of every pixel's samples when there are Pixels.
+*/
+static void Renderer_SupersampleTile(renderer_job *Job, int TileX, int TileY)
+{
+    const render_view *View = Job->View;
+    supersample_buffer *Buffer = Job->Supersamples;
+    const u32 *Iterations = Job->Buffer->Iterations;
+    int StartX = Job->MinX + TileX * RENDERER_TILE_SIZE;
+    int StartY = Job->MinY + TileY * RENDERER_TILE_SIZE;
+    int EndX = MIN(StartX + RENDERER_TILE_SIZE, Job->MaxX);
+    int EndY = MIN(StartY + RENDERER_TILE_SIZE, Job->MaxY);
+    renderer_tally Tally = { 0 };
+
+    for (int y = StartY; y < EndY; y++)
+    {
+        if (Job->SampleIndex == 0)
+        {
+            for (int x = StartX; x < EndX; x++)
+            {
+                /* counts past the view's, which the buffer keeps from higher iteration counts, are as inside as it */
+                size_t i = (size_t)y * View->Width + x;
+                u32 Count = MIN(Iterations[i], (u32)View->IterationCount);
+                bool8 Refines = Job->Threshold < 0;
+                for (int Ny = MAX(y - 1, 0); Ny <= MIN(y + 1, View->Height - 1) && !Refines; Ny++)
+                {
+                    for (int Nx = MAX(x - 1, 0); Nx <= MIN(x + 1, View->Width - 1) && !Refines; Nx++)
+                    {
+                        u32 Neighbour = MIN(Iterations[(size_t)Ny * View->Width + Nx], (u32)View->IterationCount);
+                        Refines = (Count > Neighbour? Count - Neighbour : Neighbour - Count) > (u32)Job->Threshold;
+                    }
+                }
+                u16 *Sum = Buffer->Sums + 3*i;
+                Sum[0] = Sum[1] = Sum[2] = 0;
+                Renderer_AddColor(Sum, Renderer_GetColor(Job, Count));
+                Buffer->SampleCounts[i] = 1 | (Refines? RENDERER_SAMPLES_REFINE : 0);
+            }
+        }
+        else if (Job->SampleIndex < RENDERER_SUPERSAMPLE_COUNT)
+        {
+            Renderer_SampleRow(Job, StartX, y, EndX - StartX, &Tally);
+        }
+
+        if (Job->Pixels)
+        {
+            u32 *Pixels = Job->Pixels + (size_t)(View->Height - 1 - y) * View->Width;
+            for (int x = StartX; x < EndX; x++)
+            {
+                size_t i = (size_t)y * View->Width + x;
+                const u16 *Sum = Buffer->Sums + 3*i;
+                u32 SampleCount = Buffer->SampleCounts[i] & RENDERER_SAMPLE_COUNT_MASK;
+                u32 Red = (Sum[0] + SampleCount/2) / SampleCount;
+                u32 Green = (Sum[1] + SampleCount/2) / SampleCount;
+                u32 Blue = (Sum[2] + SampleCount/2) / SampleCount;
+                Pixels[x] = Red | Green << 8 | Blue << 16 | (u32)0xFF << 24;
+            }
+        }
+    }
+    AtomicAddI64(&Job->IterationCount, Tally.IterationCount);
+    AtomicAddI64(&Job->PixelCount, Tally.PixelCount);
+    AtomicAddI64(&Job->EarlyExitCount, Tally.EarlyExitCount);
+}
+
+static void Renderer_TileWorker(void *Data)
+{
+    renderer_job *Job = Data;
+    i32 Tile;
+    /* every worker grabs the next tile until there are none left, so faster threads just take more tiles */
+    while ((Tile = AtomicAddI32(&Job->NextTile, 1)) < Job->TileCount)
+    {
+        if (Job->Supersamples)
+        {
+            Renderer_SupersampleTile(Job, Tile % Job->TileCountX, Tile / Job->TileCountX);
+        }
+        else
+        {
+            Renderer_RenderTile(Job, Tile % Job->TileCountX, Tile / Job->TileCountX);
+        }
+    }
+}
+
+static void Renderer_RunTiles(renderer_job *Job, int MinX, int MinY, int MaxX, int MaxY)
+{
+    if (MinX >= MaxX || MinY >= MaxY)
+        return;
+
+    Job->MinX = MinX;
+    Job->MinY = MinY;
+    Job->MaxX = MaxX;
+    Job->MaxY = MaxY;
+    Job->NextTile = 0;
+    Job->TileCountX = (MaxX - MinX + RENDERER_TILE_SIZE - 1) / RENDERER_TILE_SIZE;
+    Job->TileCount = Job->TileCountX * ((MaxY - MinY + RENDERER_TILE_SIZE - 1) / RENDERER_TILE_SIZE);
+
+    int ThreadCount = Platform_GetThreadCount();
+    for (int i = 0; i < ThreadCount; i++)
+    {
+        Platform_PushWork(Renderer_TileWorker, Job);
+    }
+    Platform_CompleteAllWork();
+}
+
+bool8 Renderer_IsSameView(const render_view *A, const render_view *B)
+{
+    return A->ScreenToWorldScaleFactor == B->ScreenToWorldScaleFactor
+        && A->WorldLeft == B->WorldLeft
+        && A->WorldBottom == B->WorldBottom
+        && 0 == memcmp(&A->ExactWorldLeft, &B->ExactWorldLeft, sizeof(bigfix))
+        && 0 == memcmp(&A->ExactWorldBottom, &B->ExactWorldBottom, sizeof(bigfix))
+        && A->Width == B->Width
+        && A->Height == B->Height
+        && A->Precision == B->Precision
+        && A->SkipsInterior == B->SkipsInterior
+        && A->PeriodicityTolerance == B->PeriodicityTolerance
+        && A->Method == B->Method;
+}
+
+static void Renderer_ReserveBuffer(iteration_buffer *Buffer, const render_view *View)
+{
+    size_t Capacity = (size_t)View->Width * View->Height;
+    if (Buffer->Capacity < Capacity)
+    {
+        Buffer->Iterations = realloc(Buffer->Iterations, Capacity * sizeof(u32));
+        Buffer->Zx = realloc(Buffer->Zx, Capacity * sizeof(double));
+        Buffer->Zy = realloc(Buffer->Zy, Capacity * sizeof(double));
+        Buffer->SavedZx = realloc(Buffer->SavedZx, Capacity * sizeof(double));
+        Buffer->SavedZy = realloc(Buffer->SavedZy, Capacity * sizeof(double));
+        ASSERT(Buffer->Iterations && Buffer->Zx && Buffer->Zy && Buffer->SavedZx && Buffer->SavedZy, "Out of memory");
+        /* the ones only some tiers need come back when they do */
+        free(Buffer->ZxLo);
+        free(Buffer->ZyLo);
+        free(Buffer->OrbitIndex);
+        Buffer->ZxLo = NULL;
+        Buffer->ZyLo = NULL;
+        Buffer->OrbitIndex = NULL;
+        Buffer->Capacity = Capacity;
+    }
+    if (View->Precision == RENDER_PRECISION_DOUBLE_DOUBLE && !Buffer->ZxLo)
+    {
+        Buffer->ZxLo = malloc(Buffer->Capacity * sizeof(double));
+        Buffer->ZyLo = malloc(Buffer->Capacity * sizeof(double));
+        ASSERT(Buffer->ZxLo && Buffer->ZyLo, "Out of memory");
+    }
+    if (View->Precision == RENDER_PRECISION_PERTURBATION && !Buffer->OrbitIndex)
+    {
+        Buffer->OrbitIndex = malloc(Buffer->Capacity * sizeof(i32));
+        ASSERT(Buffer->OrbitIndex, "Out of memory");
+    }
+}
+
+/* pixel (x, y) becomes what was pixel (x + Dx, y + Dy) */
+static void Renderer_ScrollArray(void *Array, size_t ElementSize, int Width, int Height, int Dx, int Dy)
+{
+    u8 *Bytes = Array;
+    int DstX = MAX(-Dx, 0);
+    int SrcX = MAX(Dx, 0);
+    size_t RowSize = (size_t)(Width - ABSI(Dx)) * ElementSize;
+    /* rows are moved in the order that never overwrites one that is still to be read */
+    for (int i = 0; i < Height - ABSI(Dy); i++)
+    {
+        int DstY = Dy >= 0? i : Height - 1 - i;
+        int SrcY = DstY + Dy;
+        memmove(
+            Bytes + ((size_t)DstY * Width + DstX) * ElementSize, 
+            Bytes + ((size_t)SrcY * Width + SrcX) * ElementSize, 
+            RowSize
+        );
+    }
+}
+
+static void Renderer_ScrollBuffer(iteration_buffer *Buffer, int Dx, int Dy)
+{
+    const render_view *View = &Buffer->View;
+    Renderer_ScrollArray(Buffer->Iterations, sizeof(u32), View->Width, View->Height, Dx, Dy);
+    Renderer_ScrollArray(Buffer->Zx, sizeof(double), View->Width, View->Height, Dx, Dy);
+    Renderer_ScrollArray(Buffer->Zy, sizeof(double), View->Width, View->Height, Dx, Dy);
+    Renderer_ScrollArray(Buffer->SavedZx, sizeof(double), View->Width, View->Height, Dx, Dy);
+    Renderer_ScrollArray(Buffer->SavedZy, sizeof(double), View->Width, View->Height, Dx, Dy);
+    if (View->Precision == RENDER_PRECISION_DOUBLE_DOUBLE)
+    {
+        Renderer_ScrollArray(Buffer->ZxLo, sizeof(double), View->Width, View->Height, Dx, Dy);
+        Renderer_ScrollArray(Buffer->ZyLo, sizeof(double), View->Width, View->Height, Dx, Dy);
+    }
+    if (View->Precision == RENDER_PRECISION_PERTURBATION)
+    {
+        Renderer_ScrollArray(Buffer->OrbitIndex, sizeof(i32), View->Width, View->Height, Dx, Dy);
+    }
+}
+
+/* 
+    The samples View has and Buffer doesn't get a NaN z like Mariani-Silver's guesses, 
+    which makes Renderer_IterateRow() start them over and bring them up to the count of the others.
+*/
+static void Renderer_AddSamples(iteration_buffer *Buffer, const render_view *View)
+{
+    const render_view *Old = &Buffer->View;
+    for (int y = 0; y < View->Height; y++)
+    {
+        if (!Renderer_IsSampleLine(y, View->PixelOffsetY, View->SampleShift))
+            continue;
+
+        bool8 HadSamples = Renderer_IsSampleLine(y, Old->PixelOffsetY, Old->SampleShift);
+        for (int x = 0; x < View->Width; x++)
+        {
+            if (!Renderer_IsSampleLine(x, View->PixelOffsetX, View->SampleShift)
+            || (HadSamples && Renderer_IsSampleLine(x, Old->PixelOffsetX, Old->SampleShift)))
+                continue;
+
+            size_t i = (size_t)y * View->Width + x;
+            Buffer->Iterations[i] = Old->IterationCount;
+            Buffer->Zx[i] = NAN;
+            Buffer->Zy[i] = NAN;
+        }
+    }
+}
+
+static void Renderer_RunJob(renderer_job *Job)
+{
+    const render_view *View = Job->View;
+    iteration_buffer *Buffer = Job->Buffer;
+    double StartTimeMs = Platform_GetElapsedTimeMs();
+    render_view JobView = *View;
+    bool8 Fills = false;
+    if (View->Precision == RENDER_PRECISION_PERTURBATION)
+    {
+        /* 
+            One reference orbit for the whole frame, before any tile needs it.
+            It's at the center of the unpanned view, so panning keeps it.
+        */
+        render_view OrbitView = *View;
+        if (Buffer->IsValid && Renderer_IsSameView(&Buffer->View, View))
+        {
+            OrbitView.IterationCount = MAX(View->IterationCount, Buffer->View.IterationCount);
+        }
+        Perturbation_ComputeReference(&sRenderer_Orbit, &OrbitView);
+        Job->Orbit = &sRenderer_Orbit;
+    }
+    else
+    {
+        Job->RowFunction = Kernel_GetRowFunction(Kernel_GetIsa(), View->Precision);
+    }
+
+    int Dx = View->PixelOffsetX - Buffer->View.PixelOffsetX;
+    int Dy = View->PixelOffsetY - Buffer->View.PixelOffsetY;
+    if (Buffer->IsValid && Renderer_IsSameView(&Buffer->View, View)
+    && ABSI(Dx) < View->Width && ABSI(Dy) < View->Height)
+    {
+        if (Dx || Dy)
+        {
+            /* 
+                Keep what is still in view and bring the newly exposed strips 
+                up to the iteration count of the rest of the buffer.
+            */
+            Renderer_ScrollBuffer(Buffer, Dx, Dy);
+            Buffer->View.PixelOffsetX = View->PixelOffsetX;
+            Buffer->View.PixelOffsetY = View->PixelOffsetY;
+
+            renderer_job StripJob = *Job;
+            StripJob.View = &Buffer->View;
+            StripJob.Pixels = NULL;
+            StripJob.StartsOver = true;
+            StripJob.Iterates = true;
+            StripJob.StartIteration = 0;
+            StripJob.IterationCount = 0;
+            StripJob.PixelCount = 0;
+            StripJob.EarlyExitCount = 0;
+            int KeptMinX = MAX(-Dx, 0), KeptMaxX = View->Width - MAX(Dx, 0);
+            int KeptMinY = MAX(-Dy, 0), KeptMaxY = View->Height - MAX(Dy, 0);
+            Renderer_RunTiles(&StripJob, 0, 0, KeptMinX, View->Height);
+            Renderer_RunTiles(&StripJob, KeptMaxX, 0, View->Width, View->Height);
+            Renderer_RunTiles(&StripJob, KeptMinX, 0, KeptMaxX, KeptMinY);
+            Renderer_RunTiles(&StripJob, KeptMinX, KeptMaxY, KeptMaxX, View->Height);
+            Job->IterationCount = StripJob.IterationCount;
+            Job->PixelCount = StripJob.PixelCount;
+            Job->EarlyExitCount = StripJob.EarlyExitCount;
+        }
+
+        /* 
+            A coarser view keeps the samples the buffer has, a finer one adds its own, 
+            which can only catch up with the count of the others, never go back on it.
+        */
+        JobView.SampleShift = MIN(View->SampleShift, Buffer->View.SampleShift);
+        bool8 AddsSamples = JobView.SampleShift < Buffer->View.SampleShift;
+        if (AddsSamples)
+        {
+            JobView.IterationCount = MAX(View->IterationCount, Buffer->View.IterationCount);
+            Renderer_AddSamples(Buffer, &JobView);
+        }
+
+        /* the pixels that didn't escape by the count already computed pick up from there */
+        Job->StartIteration = Buffer->View.IterationCount;
+        Job->Iterates = View->IterationCount > Buffer->View.IterationCount || AddsSamples;
+        Fills = JobView.SampleShift > 0 && (Job->Iterates || Dx || Dy);
+    }
+    else
+    {
+        Renderer_ReserveBuffer(Buffer, View);
+        Job->StartsOver = true;
+        Job->Iterates = true;
+        Fills = JobView.SampleShift > 0;
+    }
+    if (Job->Iterates)
+    {
+        Buffer->View = JobView;
+        Buffer->IsValid = true;
+    }
+
+    /* the colors wait for the pixels that aren't samples, and for the view's count when new samples went past it */
+    render_view ColorView = JobView;
+    ColorView.IterationCount = View->IterationCount;
+    u32 *Pixels = Job->Pixels;
+    bool8 ColorsLater = Fills || (Pixels && JobView.IterationCount != View->IterationCount);
+    Job->View = &JobView;
+    Job->Pixels = ColorsLater? NULL : Pixels;
+    Renderer_RunTiles(Job, 0, 0, View->Width, View->Height);
+    if (ColorsLater)
+    {
+        Job->View = &ColorView;
+        Job->Iterates = false;
+        Job->Fills = Fills;
+        Job->Pixels = Pixels;
+        Renderer_RunTiles(Job, 0, 0, View->Width, View->Height);
+    }
+
+    render_stats *Stats = &sRenderer_Stats;
+    Stats->Precision = View->Precision;
+    Stats->OnGpu = false;
+    Stats->TimeMs = Platform_GetElapsedTimeMs() - StartTimeMs;
+    Stats->IterationCount = Job->IterationCount;
+    Stats->PixelCount = Job->PixelCount;
+    Stats->EarlyExitCount = Job->EarlyExitCount;
+    /* frames that only recolored the buffer say nothing about the tier */
+    Stats->NsPerIteration = Stats->IterationCount? Stats->TimeMs * 1e6 / Stats->IterationCount : 0;
+    /* tiny frames are mostly overhead */
+    if (Stats->IterationCount > 1000000)
+    {
+        double *Cost = &sRenderer_NsPerIteration[View->Precision];
+        *Cost = 0.75 * *Cost + 0.25 * Stats->NsPerIteration;
+    }
+}
+
+
+static void Renderer_SetPalette(renderer_job *Job, const float *ColorPalette, int ColorPaletteSize)
+{
+    ASSERT(IN_RANGE(1, ColorPaletteSize, RENDERER_MAX_PALETTE_SIZE), "Invalid color palette size");
+    Job->PaletteSize = ColorPaletteSize;
+    for (int i = 0; i < ColorPaletteSize; i++)
+    {
+        const float *Rgb = ColorPalette + i*3;
+        Job->Palette[i] = Renderer_PackColor(Rgb[0], Rgb[1], Rgb[2]);
+    }
+}
+
+void Renderer_Render(iteration_buffer *Buffer, const render_view *View, const float *ColorPalette, int ColorPaletteSize, u32 *Pixels)
+{
+    renderer_job Job = {
+        .View = View,
+        .Buffer = Buffer,
+        .Pixels = Pixels,
+    };
+    Renderer_SetPalette(&Job, ColorPalette, ColorPaletteSize);
+    Renderer_RunJob(&Job);
+}
+
+void Renderer_ColorIterations(const u32 *Iterations, const render_view *View, const float *ColorPalette, int ColorPaletteSize, u32 *Pixels)
+{
+    /* a job that doesn't iterate only reads the counts of its buffer */
+    iteration_buffer Counts = { .Iterations = (u32 *)Iterations };
+    renderer_job Job = {
+        .View = View,
+        .Buffer = &Counts,
+        .Pixels = Pixels,
+    };
+    Renderer_SetPalette(&Job, ColorPalette, ColorPaletteSize);
+    Renderer_RunTiles(&Job, 0, 0, View->Width, View->Height);
+}
+
+bool8 Renderer_Supersample(supersample_buffer *Buffer, const u32 *Iterations, const render_view *View, int Threshold,
+                           const float *ColorPalette, int ColorPaletteSize, u32 *Pixels, double BudgetMs)
+{
+    double StartTimeMs = Platform_GetElapsedTimeMs();
+    bool8 HasView = Buffer->IsValid 
+        && Renderer_IsSameView(&Buffer->View, View)
+        && Buffer->View.PixelOffsetX == View->PixelOffsetX
+        && Buffer->View.PixelOffsetY == View->PixelOffsetY
+        && Buffer->View.IterationCount == View->IterationCount
+        && Buffer->Threshold == Threshold;
+    if (!HasView)
+    {
+        size_t Capacity = (size_t)View->Width * View->Height;
+        if (Buffer->Capacity < Capacity)
+        {
+            Buffer->Sums = realloc(Buffer->Sums, 3 * Capacity * sizeof(u16));
+            Buffer->SampleCounts = realloc(Buffer->SampleCounts, Capacity * sizeof(u8));
+            ASSERT(Buffer->Sums && Buffer->SampleCounts, "Out of memory");
+            Buffer->Capacity = Capacity;
+        }
+        Buffer->View = *View;
+        Buffer->Threshold = Threshold;
+        Buffer->SampleIndex = 0;
+        Buffer->IsValid = true;
+    }
+
+    /* a job that doesn't iterate only reads the counts of its buffer */
+    iteration_buffer Counts = { .Iterations = (u32 *)Iterations };
+    renderer_job Job = {
+        .View = View,
+        .Buffer = &Counts,
+        .Supersamples = Buffer,
+        .Threshold = Threshold,
+    };
+    Renderer_SetPalette(&Job, ColorPalette, ColorPaletteSize);
+    if (View->Precision == RENDER_PRECISION_PERTURBATION)
+    {
+        Perturbation_ComputeReference(&sRenderer_Orbit, View);
+    }
+    else
+    {
+        Job.RowFunction = Kernel_GetRowFunction(Kernel_GetIsa(), View->Precision);
+    }
+
+    while (Buffer->SampleIndex < RENDERER_SUPERSAMPLE_COUNT)
+    {
+        /* 
+            Every sample has a view of its own, moved by its offset, 
+            perturbation keeps the frame's reference and sees it moved the other way instead.
+        */
+        double OffsetX, OffsetY;
+        Renderer_GetSampleOffset(Buffer->SampleIndex, &OffsetX, &OffsetY);
+        render_view SampleView = *View;
+        SampleView.WorldLeft += OffsetX * View->ScreenToWorldScaleFactor;
+        SampleView.WorldBottom += OffsetY * View->ScreenToWorldScaleFactor;
+        BigFix_AddDouble(&SampleView.ExactWorldLeft, OffsetX * View->ScreenToWorldScaleFactor);
+        BigFix_AddDouble(&SampleView.ExactWorldBottom, OffsetY * View->ScreenToWorldScaleFactor);
+        reference_orbit Orbit = sRenderer_Orbit;
+        Orbit.PixelX -= OffsetX;
+        Orbit.PixelY -= OffsetY;
+        Job.View = &SampleView;
+        Job.Orbit = View->Precision == RENDER_PRECISION_PERTURBATION? &Orbit : NULL;
+        Job.SampleIndex = Buffer->SampleIndex;
+
+        i64 PixelCount = Job.PixelCount;
+        Renderer_RunTiles(&Job, 0, 0, View->Width, View->Height);
+        Buffer->SampleIndex++;
+        /* past the samples every refined pixel takes, once none of them differ no later sample has any pixel to take */
+        if (Buffer->SampleIndex > RENDERER_SUPERSAMPLE_MIN_COUNT && Job.PixelCount == PixelCount)
+        {
+            Buffer->SampleIndex = RENDERER_SUPERSAMPLE_COUNT;
+        }
+        if (Platform_GetElapsedTimeMs() - StartTimeMs > BudgetMs)
+            break;
+    }
+
+    Job.View = View;
+    Job.SampleIndex = RENDERER_SUPERSAMPLE_COUNT;
+    Job.Pixels = Pixels;
+    Renderer_RunTiles(&Job, 0, 0, View->Width, View->Height);
+
+    /* the samples only go where the image needs them, which says nothing of the tier's cost */
+    render_stats *Stats = &sRenderer_Stats;
+    Stats->Precision = View->Precision;
+    Stats->OnGpu = false;
+    Stats->TimeMs = Platform_GetElapsedTimeMs() - StartTimeMs;
+    Stats->IterationCount = Job.IterationCount;
+    Stats->PixelCount = Job.PixelCount;
+    Stats->EarlyExitCount = Job.EarlyExitCount;
+    Stats->NsPerIteration = Stats->IterationCount? Stats->TimeMs * 1e6 / Stats->IterationCount : 0;
+    return Buffer->SampleIndex == RENDERER_SUPERSAMPLE_COUNT;
+}
+
+void Renderer_FreeSupersampleBuffer(supersample_buffer *Buffer)
+{
+    free(Buffer->Sums);
+    free(Buffer->SampleCounts);
+    *Buffer = (supersample_buffer) { 0 };
+}
+
+void Renderer_GetSampleOffset(int Index, double *OffsetX, double *OffsetY)
+{
+    *OffsetX = Index > 0? sRenderer_SampleOffsets[Index - 1][0] / 64.0 : 0;
+    *OffsetY = Index > 0? sRenderer_SampleOffsets[Index - 1][1] / 64.0 : 0;
+}
+
+void Renderer_RenderIterations(iteration_buffer *Buffer, const render_view *View)
+{
+    renderer_job Job = {
+        .View = View,
+        .Buffer = Buffer,
+    };
+    Renderer_RunJob(&Job);
+}
+
+void Renderer_InvalidateBuffer(iteration_buffer *Buffer)
+{
+    Buffer->IsValid = false;
+}
+
+void Renderer_FreeBuffer(iteration_buffer *Buffer)
+{
+    free(Buffer->Iterations);
+    free(Buffer->Zx);
+    free(Buffer->Zy);
+    free(Buffer->SavedZx);
+    free(Buffer->SavedZy);
+    free(Buffer->ZxLo);
+    free(Buffer->ZyLo);
+    free(Buffer->OrbitIndex);
+    *Buffer = (iteration_buffer) { 0 };
+}
+
+
+render_precision Renderer_ChoosePrecision(const render_view *View, render_precision MinPrecision)
+{
+    /* a pixel is resolved when it is a few ulps of the largest coordinate in view */
+    static const double Epsilon[RENDER_PRECISION_COUNT] = {
+        [RENDER_PRECISION_FLOAT] = FLT_EPSILON,
+        [RENDER_PRECISION_DOUBLE] = DBL_EPSILON,
+        [RENDER_PRECISION_DOUBLE_DOUBLE] = DBL_EPSILON * DBL_EPSILON,
+        [RENDER_PRECISION_PERTURBATION] = 0, /* only limited by the reference orbit */
+    };
+    double Left = View->WorldLeft + View->PixelOffsetX * View->ScreenToWorldScaleFactor;
+    double Bottom = View->WorldBottom + View->PixelOffsetY * View->ScreenToWorldScaleFactor;
+    double Right = Left + View->Width * View->ScreenToWorldScaleFactor;
+    double Top = Bottom + View->Height * View->ScreenToWorldScaleFactor;
+    double Magnitude = MAX(MAX(AbsF(Left), AbsF(Right)), MAX(AbsF(Bottom), AbsF(Top)));
+
+    render_precision Cheapest = RENDER_PRECISION_PERTURBATION;
+    for (render_precision Precision = MinPrecision; Precision < RENDER_PRECISION_COUNT; Precision++)
+    {
+        bool8 CanResolvePixels = View->ScreenToWorldScaleFactor > 4.0 * Epsilon[Precision] * Magnitude;
+        if (CanResolvePixels && sRenderer_NsPerIteration[Precision] < sRenderer_NsPerIteration[Cheapest])
+        {
+            Cheapest = Precision;
+        }
+    }
+    return Cheapest;
+}
+
+const char *Renderer_GetPrecisionName(render_precision Precision)
+{
+    static const char *Names[RENDER_PRECISION_COUNT] = {
+        [RENDER_PRECISION_FLOAT] = "float",
+        [RENDER_PRECISION_DOUBLE] = "double",
+        [RENDER_PRECISION_DOUBLE_DOUBLE] = "double-double",
+        [RENDER_PRECISION_PERTURBATION] = "perturbation",
+    };
+    return Names[Precision];
+}
+
+const char *Renderer_GetMethodName(render_method Method)
+{
+    static const char *Names[RENDER_METHOD_COUNT] = {
+        [RENDER_METHOD_BRUTE_FORCE] = "brute-force",
+        [RENDER_METHOD_MARIANI_SILVER] = "mariani-silver",
+    };
+    return Names[Method];
+}
+
+render_stats Renderer_GetStats(void)
+{
+    return sRenderer_Stats;
+}
+
@@ -0,0 +1,159 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "Common.h"
+#include "BigFix.h"
+
+#define RENDERER_TILE_SIZE 64
+
+
+typedef enum 
+{
+    RENDER_PRECISION_FLOAT, /* same as FragmentShader.glsl */
+    RENDER_PRECISION_DOUBLE,
+    RENDER_PRECISION_DOUBLE_DOUBLE, /* emulated, about 106 bits */
+    RENDER_PRECISION_PERTURBATION, /* deltas in double against a full precision reference orbit */
+    RENDER_PRECISION_COUNT,
+} render_precision;
+
+typedef enum
+{
+    RENDER_METHOD_BRUTE_FORCE, /* iterates every pixel */
+    /* 
+        Mariani-Silver: iterates the border of every tile, fills it when the whole border has one count 
+        and splits it in two otherwise. CPU only, the GPU always iterates every pixel. 
+    */
+    RENDER_METHOD_MARIANI_SILVER,
+    RENDER_METHOD_COUNT,
+} render_method;
+
+/* same parameters as the uniforms of FragmentShader.glsl */
+typedef struct render_view
+{
+    double ScreenToWorldScaleFactor;
+    double WorldLeft, WorldBottom;
+    bigfix ExactWorldLeft, ExactWorldBottom; /* only perturbation needs more than double */
+    int PixelOffsetX, PixelOffsetY; /* the view's pixel (0, 0) counted from WorldLeft/WorldBottom, whole pixels so that panning can reuse pixels */
+    /* 
+        Only the pixels on multiples of 2^SampleShift, counted from WorldLeft/WorldBottom like PixelOffsetX/Y, are iterated, 
+        the others take the count of the sample at or before them. Samples stay samples at every finer shift, 
+        so refining a view only iterates the new ones, and panning keeps them. CPU only, the shader iterates every pixel.
+    */
+    int SampleShift;
+    int IterationCount;
+    int Width, Height;
+    render_precision Precision;
+    bool8 SkipsInterior; /* the main cardioid and the period-2 bulb get their count without iterating */
+    /* 
+        Orbits that come back within this many epsilons of the tier (FLT_EPSILON or DBL_EPSILON) 
+        of an earlier z are caught in a cycle and get their count without iterating further, 0 doesn't check.
+        Double-double and perturbation never check, they resolve pixels closer than double could tell their orbits apart.
+    */
+    float PeriodicityTolerance;
+    render_method Method;
+} render_view;
+
+/* 
+    Every pixel's escape state of the last views rendered, kept across frames 
+    so that a higher iteration count only continues the pixels that hadn't escaped yet, 
+    a lower one is answered from the counts alone 
+    and a pan by PixelOffsetX/Y only computes the newly exposed pixels.
+    Width*Height, bottom row first (y goes up like gl_FragCoord).
+*/
+typedef struct iteration_buffer
+{
+    render_view View; /* IterationCount is the highest one computed so far, SampleShift the finest */
+    bool8 IsValid;
+    size_t Capacity; /* in pixels */
+    u32 *Iterations; /* escape count, or View.IterationCount if it didn't escape */
+    double *Zx, *Zy; /* see kernel_row */
+    double *SavedZx, *SavedZy; /* see kernel_row */
+    double *ZxLo, *ZyLo; /* double-double only */
+    i32 *OrbitIndex; /* perturbation only */
+} iteration_buffer;
+
+/* samples of a pixel, its center and the jittered ones, same as SupersampleFragmentShader.glsl */
+#define RENDERER_SUPERSAMPLE_COUNT 16
+/* 
+    every pixel that is refined takes this many of them, the center and a rotated grid, 
+    only the ones whose rotated grid didn't all get one color take the rest 
+*/
+#define RENDERER_SUPERSAMPLE_MIN_COUNT 5
+
+/*
+    Colors of a view averaged over several samples per pixel, see Renderer_Supersample().
+    Sums and SampleCounts are Width*Height, bottom row first like iteration_buffer.
+*/
+typedef struct supersample_buffer
+{
+    render_view View;
+    int Threshold;
+    bool8 IsValid;
+    int SampleIndex; /* the next one every pixel that still refines takes, RENDERER_SUPERSAMPLE_COUNT once they are all done */
+    size_t Capacity; /* in pixels */
+    u16 *Sums; /* R, G, B of every sample so far, added up */
+    u8 *SampleCounts; /* the samples in Sums, along with the flags of Renderer.c */
+} supersample_buffer;
+
+typedef struct render_stats
+{
+    render_precision Precision;
+    bool8 OnGpu; /* nothing below is measured then */
+    double TimeMs;
+    u64 IterationCount; /* summed over every pixel, only the ones done this frame */
+    u64 PixelCount; /* iterated this frame */
+    u64 EarlyExitCount; /* of those, found interior before the iteration count */
+    double NsPerIteration; /* cost of the tier, wall time over every thread */
+    u32 TileHitCount, TileMissCount; /* of a frame through a tile_cache, the tiles it had and the ones it iterated */
+    u32 TileSkipCount; /* and the ones it had no time left for, see TileCache_Render() */
+} render_stats;
+
+
+/* 
+    Runs the escape-time iteration of FragmentShader.glsl on the CPU, 
+    split in tiles across every thread of the platform's work queue.
+    Only iterates what Buffer doesn't already have for View, see iteration_buffer.
+    A Buffer with finer samples than View keeps them, one with coarser ones gets the rest.
+    Pixels is Width*Height, top row first, same format as platform_framebuffer.
+    ColorPalette is ColorPaletteSize RGB triplets in [0, 1]. 
+*/
+void Renderer_Render(iteration_buffer *Buffer, const render_view *View, const float *ColorPalette, int ColorPaletteSize, u32 *Pixels);
+/* same as above, but only brings Buffer up to date */
+void Renderer_RenderIterations(iteration_buffer *Buffer, const render_view *View);
+/* only the colors of Renderer_Render(), Iterations is Width*Height, bottom row first like iteration_buffer */
+void Renderer_ColorIterations(const u32 *Iterations, const render_view *View, const float *ColorPalette, int ColorPaletteSize, u32 *Pixels);
+/*
+    Adaptive antialiasing of Iterations, every count of View (SampleShift 0) like Renderer_ColorIterations() takes them.
+    Pixels with a count more than Threshold away from one of their 8 neighbours' are refined:
+    they take a rotated grid of samples within their area on top of their center, RENDERER_SUPERSAMPLE_MIN_COUNT in all,
+    and the ones whose grid samples didn't all get one color go on up to RENDERER_SUPERSAMPLE_COUNT with jittered ones.
+    A negative Threshold refines every pixel with every sample, which is plain supersampling.
+    Takes one sample of every pixel still refining at a time, for as long as BudgetMs allows and at least once,
+    Buffer keeps them for the next call of the same view.
+    Pixels gets the average color of every pixel's samples so far, same format as Renderer_Render().
+    Returns whether every pixel has all the samples it gets, the calls after that only color.
+*/
+bool8 Renderer_Supersample(supersample_buffer *Buffer, const u32 *Iterations, const render_view *View, int Threshold,
+                           const float *ColorPalette, int ColorPaletteSize, u32 *Pixels, double BudgetMs);
+void Renderer_FreeSupersampleBuffer(supersample_buffer *Buffer);
+/* the offset of sample Index from the center of its pixel, in pixels, 0 being the center itself */
+void Renderer_GetSampleOffset(int Index, double *OffsetX, double *OffsetY);
+/* the next render starts over from z = 0 */
+void Renderer_InvalidateBuffer(iteration_buffer *Buffer);
+/* same pixel size, origin and precision, iteration count, PixelOffsetX/Y and SampleShift aside */
+bool8 Renderer_IsSameView(const render_view *A, const render_view *B);
+void Renderer_FreeBuffer(iteration_buffer *Buffer);
+
+/* 
+    The cheapest precision that can still tell neighbouring pixels apart at the view's zoom, 
+    going by the measured cost per iteration of each tier (or a guess until it was used once).
+    MinPrecision skips the tiers below it, like when the GPU already covers float.
+*/
+render_precision Renderer_ChoosePrecision(const render_view *View, render_precision MinPrecision);
+const char *Renderer_GetPrecisionName(render_precision Precision);
+const char *Renderer_GetMethodName(render_method Method);
+/* of the last Renderer_Render*() call */
+render_stats Renderer_GetStats(void);
+
+#endif /* RENDERER_H */
+
@@ -0,0 +1,102 @@
+#version 400 core
+
+#define COLOR_PALETTE_SIZE 16
+/* RENDERER_SUPERSAMPLE_COUNT and RENDERER_SUPERSAMPLE_MIN_COUNT, same rules as Renderer_Supersample() */
+#define SAMPLE_COUNT 16
+#define MIN_SAMPLE_COUNT 5
+
+/* same as FragmentShader.glsl */
+uniform float u_ScreenToWorldScaleFactor;
+uniform float u_WorldBottom;
+uniform float u_WorldLeft;
+uniform int u_IterationCount;
+uniform bool u_SkipsInterior;
+uniform float u_PeriodicityTolerance;
+/* every count of the view, and the last pass' sums */
+uniform usampler2D u_Iterations;
+uniform sampler2D u_LastSums;
+uniform vec3 u_ColorPalette[COLOR_PALETTE_SIZE];
+/* from the center of the pixel, sample 0 being the center itself */
+uniform vec2 u_SampleOffsets[SAMPLE_COUNT];
+/* one pass: samples u_FirstSample up to u_FirstSample + u_SampleCount of the pixels still refining */
+uniform int u_FirstSample;
+uniform int u_SampleCount;
+uniform int u_Threshold;
+/* colors of the samples so far added up, and their count, negative once the rotated grid didn't all get one color */
+out vec4 Sums;
+
+vec3 GetColor(uint i)
+{
+    return i < uint(u_IterationCount)? u_ColorPalette[i & uint(COLOR_PALETTE_SIZE - 1)] : vec3(0.0f);
+}
+
+/* the count at Offset from the center of the pixel, same iteration as FragmentShader.glsl from z = 0 */
+uint Iterate(vec2 Offset)
+{
+    float Zix = (gl_FragCoord.x + Offset.x) * u_ScreenToWorldScaleFactor + u_WorldLeft;
+    float Ziy = (gl_FragCoord.y + Offset.y) * u_ScreenToWorldScaleFactor + u_WorldBottom;
+    if (u_SkipsInterior)
+    {
+        float Xq = Zix - 0.25f;
+        float Y2 = Ziy*Ziy;
+        float q = Xq*Xq + Y2;
+        float Xb = Zix + 1.0f;
+        if (q*(q + Xq) <= 0.25f*Y2 || Xb*Xb + Y2 <= 0.0625f)
+            return uint(u_IterationCount);
+    }
+
+    float Zx = 0.0f, Zy = 0.0f, SavedZx = 0.0f, SavedZy = 0.0f;
+    int i = 0;
+    for (;
+         i < u_IterationCount
+         && (Zx*Zx + Zy*Zy) < 4.0f;
+         i++)
+    {
+        float Tmp = Zx*Zx - Zy*Zy + Zix;
+        Zy = 2.0*Zy*Zx + Ziy;
+        Zx = Tmp;
+
+        if (abs(Zx - SavedZx) < u_PeriodicityTolerance && abs(Zy - SavedZy) < u_PeriodicityTolerance)
+            return uint(u_IterationCount);
+        if (((i + 1) & i) == 0)
+        {
+            SavedZx = Zx;
+            SavedZy = Zy;
+        }
+    }
+    return uint(i);
+}
+
+void main()
+{
+    /* counts past the view's are as inside as it, like the colors have them */
+    ivec2 Pixel = ivec2(gl_FragCoord.xy);
+    ivec2 Size = textureSize(u_Iterations, 0);
+    uint Count = min(texelFetch(u_Iterations, Pixel, 0).r, uint(u_IterationCount));
+    bool Refines = u_Threshold < 0;
+    for (int y = max(Pixel.y - 1, 0); y <= min(Pixel.y + 1, Size.y - 1); y++)
+    {
+        for (int x = max(Pixel.x - 1, 0); x <= min(Pixel.x + 1, Size.x - 1); x++)
+        {
+            uint Neighbour = min(texelFetch(u_Iterations, ivec2(x, y), 0).r, uint(u_IterationCount));
+            Refines = Refines || abs(int(Count) - int(Neighbour)) > u_Threshold;
+        }
+    }
+
+    vec3 Center = GetColor(Count);
+    Sums = u_FirstSample == 0? vec4(Center, 1.0f) : texelFetch(u_LastSums, Pixel, 0);
+    for (int s = max(u_FirstSample, 1); s < min(u_FirstSample + u_SampleCount, SAMPLE_COUNT) && Refines; s++)
+    {
+        bool Differs = Sums.w < 0.0f;
+        if (s >= MIN_SAMPLE_COUNT && !Differs && u_Threshold >= 0)
+            break;
+
+        /* the grid samples before this one make up all of the sum but the center */
+        vec3 Color = GetColor(Iterate(u_SampleOffsets[s]));
+        float SampleCount = abs(Sums.w) + 1.0f;
+        Differs = Differs || (s >= 2 && s < MIN_SAMPLE_COUNT 
+            && any(greaterThan(abs(Sums.rgb - Center - float(s - 1)*Color), vec3(1e-3f))));
+        Sums.rgb += Color;
+        Sums.w = Differs? -SampleCount : SampleCount;
+    }
+}
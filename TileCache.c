@@ -0,0 +1,343 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Platform.h"
+#include "TileCache.h"
+
+
+struct tile_cache_entry
+{
+    tile_key Key;
+    iteration_buffer Buffer; /* of the tile's view, its IterationCount is the highest one computed */
+    size_t Bytes;
+    tile_cache_entry *NextInBucket;
+    tile_cache_entry *MoreRecent, *LessRecent;
+};
+
+
+bool8 TileCache_CanRender(const render_view *View)
+{
+    return View->Precision != RENDER_PRECISION_PERTURBATION;
+}
+
+/* FNV-1a */
+static u32 TileCache_Hash(const tile_key *Key)
+{
+    const u8 *Bytes = (const u8 *)Key;
+    u32 Hash = 2166136261u;
+    for (size_t i = 0; i < sizeof *Key; i++)
+    {
+        Hash = (Hash ^ Bytes[i]) * 16777619u;
+    }
+    return Hash;
+}
+
+static size_t TileCache_GetBufferBytes(const iteration_buffer *Buffer)
+{
+    size_t BytesPerPixel = sizeof(u32) + 4*sizeof(double)
+        + (Buffer->ZxLo? 2*sizeof(double) : 0)
+        + (Buffer->OrbitIndex? sizeof(i32) : 0);
+    return sizeof(tile_cache_entry) + Buffer->Capacity * BytesPerPixel;
+}
+
+static void TileCache_Unlink(tile_cache *Cache, tile_cache_entry *Entry)
+{
+    if (Entry->MoreRecent)
+        Entry->MoreRecent->LessRecent = Entry->LessRecent;
+    else
+        Cache->MostRecent = Entry->LessRecent;
+    if (Entry->LessRecent)
+        Entry->LessRecent->MoreRecent = Entry->MoreRecent;
+    else
+        Cache->LeastRecent = Entry->MoreRecent;
+    Entry->MoreRecent = NULL;
+    Entry->LessRecent = NULL;
+}
+
+static void TileCache_PushMostRecent(tile_cache *Cache, tile_cache_entry *Entry)
+{
+    Entry->LessRecent = Cache->MostRecent;
+    if (Cache->MostRecent)
+        Cache->MostRecent->MoreRecent = Entry;
+    else
+        Cache->LeastRecent = Entry;
+    Cache->MostRecent = Entry;
+}
+
+static void TileCache_Evict(tile_cache *Cache, tile_cache_entry *Entry)
+{
+    tile_cache_entry **Link = &Cache->Buckets[TileCache_Hash(&Entry->Key) % TILE_CACHE_BUCKET_COUNT];
+    while (*Link != Entry)
+    {
+        Link = &(*Link)->NextInBucket;
+    }
+    *Link = Entry->NextInBucket;
+    TileCache_Unlink(Cache, Entry);
+    Cache->UsedBytes -= Entry->Bytes;
+    Cache->EntryCount--;
+    Renderer_FreeBuffer(&Entry->Buffer);
+    free(Entry);
+}
+
+/* least recently used first, Keep stays whatever it costs */
+static void TileCache_EvictOverBudget(tile_cache *Cache, const tile_cache_entry *Keep)
+{
+    while (Cache->UsedBytes > Cache->BudgetBytes && Cache->LeastRecent && Cache->LeastRecent != Keep)
+    {
+        TileCache_Evict(Cache, Cache->LeastRecent);
+    }
+}
+
+static u32 TileCache_GetFormula(render_precision Precision, const render_view *View)
+{
+    return Precision | (u32)View->SkipsInterior << 8 | (u32)View->Method << 16;
+}
+
+static tile_cache_entry *TileCache_Find(tile_cache *Cache, const tile_key *Key)
+{
+    if (!Cache->Buckets)
+    {
+        Cache->Buckets = calloc(TILE_CACHE_BUCKET_COUNT, sizeof(tile_cache_entry *));
+        ASSERT(Cache->Buckets, "Out of memory");
+    }
+    tile_cache_entry *Entry = Cache->Buckets[TileCache_Hash(Key) % TILE_CACHE_BUCKET_COUNT];
+    while (Entry && memcmp(&Entry->Key, Key, sizeof *Key) != 0)
+    {
+        Entry = Entry->NextInBucket;
+    }
+    return Entry;
+}
+
+/* the most recent from now on, new ones start out empty */
+static tile_cache_entry *TileCache_Get(tile_cache *Cache, const tile_key *Key)
+{
+    tile_cache_entry *Entry = TileCache_Find(Cache, Key);
+    if (Entry)
+    {
+        TileCache_Unlink(Cache, Entry);
+    }
+    else
+    {
+        Entry = calloc(1, sizeof *Entry);
+        ASSERT(Entry, "Out of memory");
+        Entry->Key = *Key;
+        Entry->Bytes = TileCache_GetBufferBytes(&Entry->Buffer);
+        tile_cache_entry **Bucket = &Cache->Buckets[TileCache_Hash(Key) % TILE_CACHE_BUCKET_COUNT];
+        Entry->NextInBucket = *Bucket;
+        *Bucket = Entry;
+        Cache->UsedBytes += Entry->Bytes;
+        Cache->EntryCount++;
+    }
+    TileCache_PushMostRecent(Cache, Entry);
+    return Entry;
+}
+
+/* bottom left corner of the view's pixel (0, 0) */
+static void TileCache_GetCorner(const render_view *View, bigfix *Left, bigfix *Bottom)
+{
+    *Left = View->ExactWorldLeft;
+    *Bottom = View->ExactWorldBottom;
+    BigFix_AddDouble(Left, View->PixelOffsetX * View->ScreenToWorldScaleFactor);
+    BigFix_AddDouble(Bottom, View->PixelOffsetY * View->ScreenToWorldScaleFactor);
+}
+
+/* 
+    Nearest neighbour of the last view's counts for the pixels of View from (MinX, MinY) to (MaxX, MaxY), 
+    the ones that didn't escape there and the ones it didn't have are as good as inside.
+*/
+static void TileCache_Reproject(tile_cache *Cache, const render_view *View, int MinX, int MinY, int MaxX, int MaxY)
+{
+    const render_view *Last = &Cache->View;
+    double Ratio = View->ScreenToWorldScaleFactor / Last->ScreenToWorldScaleFactor;
+    double LastX = 0, LastY = 0; /* of the view's corner, in pixels of the last view */
+    if (Cache->HasView)
+    {
+        bigfix Left, Bottom, LastLeft, LastBottom, Offset;
+        TileCache_GetCorner(View, &Left, &Bottom);
+        TileCache_GetCorner(Last, &LastLeft, &LastBottom);
+        BigFix_Sub(&Offset, &Left, &LastLeft);
+        LastX = BigFix_ToDouble(&Offset) / Last->ScreenToWorldScaleFactor;
+        BigFix_Sub(&Offset, &Bottom, &LastBottom);
+        LastY = BigFix_ToDouble(&Offset) / Last->ScreenToWorldScaleFactor;
+    }
+    for (int y = MinY; y < MaxY; y++)
+    {
+        double SrcY = floor(LastY + (y + 0.5) * Ratio);
+        bool8 HasRow = Cache->HasView && IN_RANGE(0, SrcY, Last->Height - 1);
+        for (int x = MinX; x < MaxX; x++)
+        {
+            double SrcX = floor(LastX + (x + 0.5) * Ratio);
+            u32 Count = View->IterationCount;
+            if (HasRow && IN_RANGE(0, SrcX, Last->Width - 1))
+            {
+                u32 LastCount = Cache->LastIterations[(size_t)SrcY * Last->Width + (size_t)SrcX];
+                Count = LastCount < (u32)Last->IterationCount? LastCount : Count;
+            }
+            Cache->Iterations[(size_t)y * View->Width + x] = Count;
+        }
+    }
+}
+
+render_stats TileCache_Render(tile_cache *Cache, const render_view *View, int FocusX, int FocusY, double BudgetMs)
+{
+    ASSERT(TileCache_CanRender(View), "No tiles for this tier");
+    double StartTimeMs = Platform_GetElapsedTimeMs();
+    render_stats Stats = { 0 };
+    size_t PixelCount = (size_t)View->Width * View->Height;
+    if (Cache->IterationCapacity < PixelCount)
+    {
+        /* the last view's counts move along, the other buffer only ever gets overwritten */
+        Cache->Iterations = realloc(Cache->Iterations, PixelCount * sizeof(u32));
+        free(Cache->LastIterations);
+        Cache->LastIterations = malloc(PixelCount * sizeof(u32));
+        Cache->IterationCapacity = PixelCount;
+        ASSERT(Cache->Iterations && Cache->LastIterations, "Out of memory");
+    }
+    /* this view goes in the other buffer, skipped tiles reproject the last one from there */
+    u32 *LastIterations = Cache->Iterations;
+    Cache->Iterations = Cache->LastIterations;
+    Cache->LastIterations = LastIterations;
+
+    double Scale = View->ScreenToWorldScaleFactor;
+    bigfix Left, Bottom;
+    TileCache_GetCorner(View, &Left, &Bottom);
+    int Exponent;
+    frexp(Scale * TILE_CACHE_ANCHOR_PIXELS, &Exponent);
+    tile_key Key = {
+        .ScreenToWorldScaleFactor = Scale,
+        .PeriodicityTolerance = View->PeriodicityTolerance,
+        .AnchorLeft = Left,
+        .AnchorBottom = Bottom,
+    };
+    BigFix_RoundDown(&Key.AnchorLeft, Exponent);
+    BigFix_RoundDown(&Key.AnchorBottom, Exponent);
+
+    /* less than 2*TILE_CACHE_ANCHOR_PIXELS from the anchor, a double has all of it */
+    bigfix Offset;
+    BigFix_Sub(&Offset, &Left, &Key.AnchorLeft);
+    int ViewX = floor(BigFix_ToDouble(&Offset) / Scale + 0.5);
+    BigFix_Sub(&Offset, &Bottom, &Key.AnchorBottom);
+    int ViewY = floor(BigFix_ToDouble(&Offset) / Scale + 0.5);
+
+    int MinTileX = ViewX / TILE_CACHE_TILE_SIZE, MaxTileX = (ViewX + View->Width - 1) / TILE_CACHE_TILE_SIZE;
+    int MinTileY = ViewY / TILE_CACHE_TILE_SIZE, MaxTileY = (ViewY + View->Height - 1) / TILE_CACHE_TILE_SIZE;
+
+    /* 
+        The cheapest tier that resolves the view goes back and forth between ones of about the same cost.
+        Any tier above it does too, the view keeps the one its center tile already has, every tile of it in one tier.
+    */
+    render_view TileView = *View;
+    Key.TileX = (MinTileX + MaxTileX) / 2;
+    Key.TileY = (MinTileY + MaxTileY) / 2;
+    for (render_precision Precision = View->Precision; Precision < RENDER_PRECISION_PERTURBATION; Precision++)
+    {
+        Key.Formula = TileCache_GetFormula(Precision, View);
+        if (TileCache_Find(Cache, &Key))
+        {
+            TileView.Precision = Precision;
+            break;
+        }
+    }
+    Key.Formula = TileCache_GetFormula(TileView.Precision, View);
+    Stats.Precision = TileView.Precision;
+
+    TileView.WorldLeft = BigFix_ToDouble(&Key.AnchorLeft);
+    TileView.WorldBottom = BigFix_ToDouble(&Key.AnchorBottom);
+    TileView.ExactWorldLeft = Key.AnchorLeft;
+    TileView.ExactWorldBottom = Key.AnchorBottom;
+    TileView.Width = TILE_CACHE_TILE_SIZE;
+    TileView.Height = TILE_CACHE_TILE_SIZE;
+
+    /* square rings of tiles around the focus, the ones nearest to it get the frame's time first */
+    int FocusTileX = (ViewX + MIN(MAX(FocusX, 0), View->Width - 1)) / TILE_CACHE_TILE_SIZE;
+    int FocusTileY = (ViewY + MIN(MAX(FocusY, 0), View->Height - 1)) / TILE_CACHE_TILE_SIZE;
+    int RingCount = 1 + MAX(
+        MAX(FocusTileX - MinTileX, MaxTileX - FocusTileX), 
+        MAX(FocusTileY - MinTileY, MaxTileY - FocusTileY)
+    );
+    for (int Ring = 0; Ring < RingCount; Ring++)
+    {
+        for (Key.TileY = MinTileY; Key.TileY <= MaxTileY; Key.TileY++)
+        {
+            for (Key.TileX = MinTileX; Key.TileX <= MaxTileX; Key.TileX++)
+            {
+                if (MAX(ABSI(Key.TileX - FocusTileX), ABSI(Key.TileY - FocusTileY)) != Ring)
+                    continue;
+
+                /* the part of the tile in view */
+                int TileLeft = Key.TileX * TILE_CACHE_TILE_SIZE - ViewX;
+                int TileBottom = Key.TileY * TILE_CACHE_TILE_SIZE - ViewY;
+                int MinX = MAX(TileLeft, 0), MaxX = MIN(TileLeft + TILE_CACHE_TILE_SIZE, View->Width);
+                int MinY = MAX(TileBottom, 0), MaxY = MIN(TileBottom + TILE_CACHE_TILE_SIZE, View->Height);
+
+                tile_cache_entry *Entry = TileCache_Find(Cache, &Key);
+                bool8 IsHit = Entry && Entry->Buffer.IsValid 
+                    && Entry->Buffer.View.IterationCount >= View->IterationCount 
+                    && Entry->Buffer.View.SampleShift <= View->SampleShift;
+                bool8 IsOutOfTime = BudgetMs > 0 && Stats.TileMissCount > 0 
+                    && Platform_GetElapsedTimeMs() - StartTimeMs > BudgetMs;
+                if (!IsHit && IsOutOfTime)
+                {
+                    TileCache_Reproject(Cache, View, MinX, MinY, MaxX, MaxY);
+                    Stats.TileSkipCount++;
+                    continue;
+                }
+
+                Entry = TileCache_Get(Cache, &Key);
+                if (IsHit)
+                {
+                    Stats.TileHitCount++;
+                }
+                else
+                {
+                    TileView.PixelOffsetX = Key.TileX * TILE_CACHE_TILE_SIZE;
+                    TileView.PixelOffsetY = Key.TileY * TILE_CACHE_TILE_SIZE;
+                    Renderer_RenderIterations(&Entry->Buffer, &TileView);
+                    render_stats TileStats = Renderer_GetStats();
+                    Stats.IterationCount += TileStats.IterationCount;
+                    Stats.PixelCount += TileStats.PixelCount;
+                    Stats.EarlyExitCount += TileStats.EarlyExitCount;
+                    Stats.TileMissCount++;
+
+                    size_t Bytes = TileCache_GetBufferBytes(&Entry->Buffer);
+                    Cache->UsedBytes += Bytes - Entry->Bytes;
+                    Entry->Bytes = Bytes;
+                    TileCache_EvictOverBudget(Cache, Entry);
+                }
+
+                /* counts past the iteration count are just as much inside */
+                for (int y = MinY; y < MaxY; y++)
+                {
+                    memcpy(
+                        Cache->Iterations + (size_t)y * View->Width + MinX,
+                        Entry->Buffer.Iterations + (size_t)(y - TileBottom) * TILE_CACHE_TILE_SIZE + (MinX - TileLeft),
+                        (MaxX - MinX) * sizeof(u32)
+                    );
+                }
+            }
+        }
+    }
+
+    Cache->View = *View;
+    Cache->HasView = true;
+    Cache->HitCount += Stats.TileHitCount;
+    Cache->MissCount += Stats.TileMissCount;
+    Stats.TimeMs = Platform_GetElapsedTimeMs() - StartTimeMs;
+    Stats.NsPerIteration = Stats.IterationCount? Stats.TimeMs * 1e6 / Stats.IterationCount : 0;
+    return Stats;
+}
+
+void TileCache_SetBudget(tile_cache *Cache, size_t BudgetBytes)
+{
+    Cache->BudgetBytes = BudgetBytes;
+    TileCache_EvictOverBudget(Cache, NULL);
+}
+
+void TileCache_Free(tile_cache *Cache)
+{
+    TileCache_SetBudget(Cache, 0);
+    free(Cache->Buckets);
+    free(Cache->Iterations);
+    free(Cache->LastIterations);
+    *Cache = (tile_cache) { 0 };
+}
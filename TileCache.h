@@ -0,0 +1,69 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include "Common.h"
+#include "BigFix.h"
+#include "Renderer.h"
+
+/* 4x4 of the renderer's tiles, enough for every thread to have some */
+#define TILE_CACHE_TILE_SIZE 256
+#define TILE_CACHE_BUCKET_COUNT 4096
+#define TILE_CACHE_DEFAULT_BUDGET_MB 256
+/* 
+    Tiles are counted from an anchor, the view's corner rounded down to a power of 2 
+    of at least this many pixels, so that views around the same place at the same zoom share their tiles.
+*/
+#define TILE_CACHE_ANCHOR_PIXELS (1 << 20)
+
+
+/* what makes a tile's counts, aside from the iteration count, which the entry keeps */
+typedef struct tile_key
+{
+    double ScreenToWorldScaleFactor; /* the zoom level */
+    i32 TileX, TileY; /* from the anchor, y goes up */
+    u32 Formula; /* Precision, SkipsInterior and Method of render_view */
+    float PeriodicityTolerance;
+    bigfix AnchorLeft, AnchorBottom;
+} tile_key;
+
+typedef struct tile_cache_entry tile_cache_entry;
+
+/* 
+    Iteration buffers of TILE_CACHE_TILE_SIZE square tiles, least recently used ones go first 
+    when they take more than BudgetBytes. A tile with a higher iteration count 
+    answers for a lower one, one with a lower count is continued from where it stopped.
+    Same with render_view's SampleShift, the tiles start on multiples of every sample size.
+*/
+typedef struct tile_cache
+{
+    size_t BudgetBytes;
+    size_t UsedBytes;
+    int EntryCount;
+    tile_cache_entry **Buckets; /* TILE_CACHE_BUCKET_COUNT, allocated by the first render */
+    tile_cache_entry *MostRecent, *LeastRecent;
+    u64 HitCount, MissCount; /* ever */
+    u32 *Iterations; /* of the last view, see TileCache_Render() */
+    u32 *LastIterations; /* of the view before, what a new view's placeholder is reprojected from */
+    size_t IterationCapacity;
+    render_view View; /* of Iterations */
+    bool8 HasView;
+} tile_cache;
+
+
+/* every tier but perturbation, which would need a reference orbit for every tile */
+bool8 TileCache_CanRender(const render_view *View);
+/* 
+    Counts of View into Cache->Iterations, Width*Height, bottom row first like iteration_buffer, 
+    at most half a pixel off View so that its pixels line up with the tiles.
+    The tiles it doesn't have are iterated from the one under pixel (FocusX, FocusY) outward, 
+    once BudgetMs is spent (0 never is) the rest are skipped, after at least one was iterated.
+    Skipped tiles keep the counts of the last view reprojected onto them, 
+    or as many as the iteration count where that view didn't reach, until a later call iterates them.
+    The stats add up every tile the frame iterated.
+*/
+render_stats TileCache_Render(tile_cache *Cache, const render_view *View, int FocusX, int FocusY, double BudgetMs);
+/* evicts down to the new budget right away */
+void TileCache_SetBudget(tile_cache *Cache, size_t BudgetBytes);
+void TileCache_Free(tile_cache *Cache);
+
+#endif /* TILE_CACHE_H */
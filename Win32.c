@@ -6,6 +6,13 @@
 /* TODO: unity build in a different file */
 #include "glad/src/glad.c"
 #include "App.c"
+#include "Renderer.c"
+#include "Kernel.c"
+#include "Perturbation.c"
+#include "BigFix.c"
+#include "Profiler.c"
+#include "TileCache.c"
+#include "WorkQueue.c"
 
 #include <stdio.h>
 #include <windows.h>
@@ -71,8 +78,11 @@ static void Win32_DisplayBufferToWindow(HWND Window)
     platform_window_dimensions WindowDimensions = Platform_GetWindowDimensions();
     HDC WindowDC = GetDC(Window);
     {
+        profiler_phase Phase = Profiler_SetPhase(PROFILER_PHASE_RENDER, Platform_GetElapsedTimeMs());
         App_OnRedrawRequest(&sWin32_AppState, WindowDimensions.Width, WindowDimensions.Height);
+        Profiler_SetPhase(PROFILER_PHASE_SWAP, Platform_GetElapsedTimeMs());
         SwapBuffers(WindowDC);
+        Profiler_SetPhase(Phase, Platform_GetElapsedTimeMs());
     }
     ReleaseDC(Window, WindowDC);
 }
@@ -254,6 +264,13 @@ int WINAPI BogusWinMain(HINSTANCE Instance, HINSTANCE PrevInstance, PCHAR CmdLin
         QueryPerformanceCounter(&sWin32_PerfCountBegin);
     }
 
+    /* the CPU tiers render on every core */
+    {
+        SYSTEM_INFO SystemInfo;
+        GetSystemInfo(&SystemInfo);
+        WorkQueue_StartThreads(MAX((int)SystemInfo.dwNumberOfProcessors, 1));
+    }
+
     /* window creation */
     Platform_SetScreenBufferDimensions(1080, 720);
     sWin32_MainWindow.Handle = CreateWindowExA(
@@ -285,14 +302,40 @@ int WINAPI BogusWinMain(HINSTANCE Instance, HINSTANCE PrevInstance, PCHAR CmdLin
     ShowWindow(sWin32_MainWindow.Handle, SW_SHOW);
     LARGE_INTEGER StartTime, EndTime;
     QueryPerformanceCounter(&StartTime);
+    double LastStatusMs = 0;
     while (Win32_PollInputs())
     {
+        Profiler_SetPhase(PROFILER_PHASE_UPDATE, Platform_GetElapsedTimeMs());
         App_OnLoop(&sWin32_AppState);
-        printf("\rfps: %f", 1000.0f / sWin32_FrameTimeMs);
+        /* printing is a syscall, and the percentiles sort every kept frame */
+        if (Platform_GetElapsedTimeMs() - LastStatusMs > 500.0)
+        {
+            LastStatusMs = Platform_GetElapsedTimeMs();
+            frame_time_stats Frames = Profiler_GetStats();
+            printf("\rt_busy p50|p95|p99: %3.3f|%3.3f|%3.3f, fps: %f, tier: %s%s %3.3fns/iter, early exits: %2.1f%%, tiles hit|miss: %u|%u      ", 
+                Frames.Busy.P50, 
+                Frames.Busy.P95, 
+                Frames.Busy.P99, 
+                1000.0f / sWin32_FrameTimeMs, 
+                Renderer_GetPrecisionName(sWin32_AppState.RenderStats.Precision),
+                sWin32_AppState.RenderStats.OnGpu? " (gpu)" : "",
+                sWin32_AppState.RenderStats.NsPerIteration,
+                sWin32_AppState.RenderStats.PixelCount? 
+                    100.0 * sWin32_AppState.RenderStats.EarlyExitCount / sWin32_AppState.RenderStats.PixelCount : 0.0,
+                sWin32_AppState.RenderStats.TileHitCount, sWin32_AppState.RenderStats.TileMissCount
+            );
+            fflush(stdout);
+        }
 
         QueryPerformanceCounter(&EndTime);
         sWin32_FrameTimeMs = (EndTime.QuadPart - StartTime.QuadPart) * sWin32_MsPerPerfCount;
-        if (sWin32_FrameTimeMs - 1 < sWin32_FrameTimeTargetMs)
+        Profiler_SetPhase(PROFILER_PHASE_IDLE, Platform_GetElapsedTimeMs());
+        if (App_IsIdle(&sWin32_AppState))
+        {
+            /* blocks until there's a message, Win32_PollInputs() takes it from there */
+            WaitMessage();
+        }
+        else if (sWin32_FrameTimeMs - 1 < sWin32_FrameTimeTargetMs)
         {
             LARGE_INTEGER SleepStart, SleepEnd;
             QueryPerformanceCounter(&SleepStart);
@@ -301,6 +344,9 @@ int WINAPI BogusWinMain(HINSTANCE Instance, HINSTANCE PrevInstance, PCHAR CmdLin
             sWin32_FrameTimeMs += (SleepEnd.QuadPart - SleepStart.QuadPart) * sWin32_MsPerPerfCount;
         }
         QueryPerformanceCounter(&StartTime);
+        Profiler_EndFrame(Platform_GetElapsedTimeMs());
+        /* Win32_PollInputs() at the top of the next frame */
+        Profiler_SetPhase(PROFILER_PHASE_INPUT, Platform_GetElapsedTimeMs());
     }
     App_OnExit(&sWin32_AppState);
 
@@ -375,6 +421,46 @@ double Platform_GetFrameTimeMs(void)
     return sWin32_FrameTimeMs;
 }
 
+frame_time_stats Platform_GetFrameTimeStats(void)
+{
+    return Profiler_GetStats();
+}
+
+void Platform_BeginScope(const char *Name)
+{
+    Profiler_BeginScope(Name, Platform_GetElapsedTimeMs());
+}
+
+void Platform_EndScope(void)
+{
+    Profiler_EndScope(Platform_GetElapsedTimeMs());
+}
+
+bool8 Platform_WriteTrace(const char *FileName)
+{
+    return Profiler_WriteTrace(FileName);
+}
+
+platform_framebuffer Platform_GetSoftwareFramebuffer(void)
+{
+    return (platform_framebuffer) { 0 };
+}
+
+int Platform_GetThreadCount(void)
+{
+    return WorkQueue_GetThreadCount();
+}
+
+void Platform_PushWork(platform_work_callback *Callback, void *Data)
+{
+    WorkQueue_Push(Callback, Data);
+}
+
+void Platform_CompleteAllWork(void)
+{
+    WorkQueue_CompleteAll();
+}
+
 
 int Platform_BeginTempMemory(void)
 {
@@ -443,6 +529,10 @@ static uint8_t Win32_KeycodeFromPlatformKey(platform_key Key)
         [PLATFORM_KEY_LEFT_SHIFT] = VK_SHIFT,
         [PLATFORM_KEY_DOWN_ARROW] = VK_DOWN,
         [PLATFORM_KEY_UP_ARROW] = VK_UP,
+        [PLATFORM_KEY_I] = 'I',
+        [PLATFORM_KEY_M] = 'M',
+        [PLATFORM_KEY_T] = 'T',
+        [PLATFORM_KEY_A] = 'A',
     };
     return Lookup[Key];
 }
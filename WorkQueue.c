@@ -0,0 +1,150 @@
+#if defined(_WIN32)
+#  include <windows.h>
+#  include <limits.h>
+#else
+#  include <pthread.h>
+#  include <semaphore.h>
+#endif /* _WIN32 */
+#include "WorkQueue.h"
+
+
+typedef struct work_entry
+{
+    platform_work_callback *Callback;
+    void *Data;
+} work_entry;
+
+/*
+    The counts only ever go up, entry i is in slot i % WORK_QUEUE_SIZE.
+    A worker that read NextEntryToDo and got preempted can't take an entry of a later batch
+    with the same index that way, its compare exchange fails once anyone took the one it read.
+*/
+static work_entry sWorkQueue_Entries[WORK_QUEUE_SIZE];
+static volatile i32 sWorkQueue_EntryCount; /* ever pushed */
+static volatile i32 sWorkQueue_NextEntryToDo;
+static volatile i32 sWorkQueue_CompletionCount;
+static int sWorkQueue_ThreadCount = 1;
+static bool8 sWorkQueue_HasSemaphore;
+#if defined(_WIN32)
+static HANDLE sWorkQueue_Semaphore;
+#else
+static sem_t sWorkQueue_Semaphore;
+#endif /* _WIN32 */
+
+
+/* how far A is past B, the counts wrap around after 2^32 entries */
+static i32 WorkQueue_Distance(i32 A, i32 B)
+{
+    return (i32)((u32)A - (u32)B);
+}
+
+static bool8 WorkQueue_DoNextEntry(void)
+{
+    i32 EntryIndex = sWorkQueue_NextEntryToDo;
+    if (WorkQueue_Distance(sWorkQueue_EntryCount, EntryIndex) <= 0)
+        return false;
+
+    if (AtomicCompareExchangeI32(&sWorkQueue_NextEntryToDo, EntryIndex, (i32)((u32)EntryIndex + 1)))
+    {
+        work_entry *Entry = &sWorkQueue_Entries[(u32)EntryIndex % WORK_QUEUE_SIZE];
+        Entry->Callback(Entry->Data);
+        AtomicAddI32(&sWorkQueue_CompletionCount, 1);
+    }
+    return true;
+}
+
+static void WorkQueue_Work(void)
+{
+    for (;;)
+    {
+        if (!WorkQueue_DoNextEntry())
+        {
+#if defined(_WIN32)
+            WaitForSingleObject(sWorkQueue_Semaphore, INFINITE);
+#else
+            sem_wait(&sWorkQueue_Semaphore);
+#endif /* _WIN32 */
+        }
+    }
+}
+
+#if defined(_WIN32)
+static DWORD WINAPI WorkQueue_ThreadProc(LPVOID Arg)
+{
+    (void)Arg;
+    WorkQueue_Work();
+    return 0;
+}
+#else
+static void *WorkQueue_ThreadProc(void *Arg)
+{
+    (void)Arg;
+    WorkQueue_Work();
+    return NULL;
+}
+#endif /* _WIN32 */
+
+void WorkQueue_Push(platform_work_callback *Callback, void *Data)
+{
+    /* a slot is free again once its entry completed, not just once it was taken */
+    ASSERT(WorkQueue_Distance(sWorkQueue_EntryCount, sWorkQueue_CompletionCount) < WORK_QUEUE_SIZE, "Work queue is full");
+    sWorkQueue_Entries[(u32)sWorkQueue_EntryCount % WORK_QUEUE_SIZE] = (work_entry) {
+        .Callback = Callback,
+        .Data = Data,
+    };
+    /* entry must be visible before the count */
+    AtomicAddI32(&sWorkQueue_EntryCount, 1);
+    if (sWorkQueue_HasSemaphore)
+    {
+#if defined(_WIN32)
+        ReleaseSemaphore(sWorkQueue_Semaphore, 1, NULL);
+#else
+        sem_post(&sWorkQueue_Semaphore);
+#endif /* _WIN32 */
+    }
+}
+
+void WorkQueue_CompleteAll(void)
+{
+    while (sWorkQueue_CompletionCount != sWorkQueue_EntryCount)
+    {
+        WorkQueue_DoNextEntry();
+    }
+}
+
+void WorkQueue_StartThreads(int ThreadCount)
+{
+    ThreadCount = MIN(ThreadCount, WORK_QUEUE_MAX_THREAD_COUNT);
+    if (!sWorkQueue_HasSemaphore)
+    {
+#if defined(_WIN32)
+        sWorkQueue_Semaphore = CreateSemaphoreA(NULL, 0, LONG_MAX, NULL);
+#else
+        sem_init(&sWorkQueue_Semaphore, 0, 0);
+#endif /* _WIN32 */
+        sWorkQueue_HasSemaphore = true;
+    }
+    for (int i = sWorkQueue_ThreadCount; i < ThreadCount; i++)
+    {
+#if defined(_WIN32)
+        HANDLE Thread = CreateThread(NULL, 0, WorkQueue_ThreadProc, NULL, 0, NULL);
+        CloseHandle(Thread);
+#else
+        pthread_t Thread;
+        pthread_create(&Thread, NULL, WorkQueue_ThreadProc, NULL);
+        pthread_detach(Thread);
+#endif /* _WIN32 */
+    }
+    sWorkQueue_ThreadCount = MAX(sWorkQueue_ThreadCount, ThreadCount);
+}
+
+void WorkQueue_ForgetThreads(void)
+{
+    sWorkQueue_ThreadCount = 1;
+}
+
+int WorkQueue_GetThreadCount(void)
+{
+    return sWorkQueue_ThreadCount;
+}
+
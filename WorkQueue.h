@@ -0,0 +1,26 @@
+#ifndef WORK_QUEUE_H
+#define WORK_QUEUE_H
+
+#include "Common.h"
+#include "Platform.h"
+
+#define WORK_QUEUE_MAX_THREAD_COUNT 256
+/* a power of two, entries go in a ring */
+#define WORK_QUEUE_SIZE 1024
+
+
+/*
+    The platforms' work queue, behind Platform_PushWork() and Platform_CompleteAllWork().
+    Only the main thread may push or complete work, the workers sleep on a semaphore while it's empty.
+*/
+void WorkQueue_Push(platform_work_callback *Callback, void *Data);
+/* the main thread helps with the queued work until all of it is done */
+void WorkQueue_CompleteAll(void);
+/* only ever adds threads, the main thread is one of them */
+void WorkQueue_StartThreads(int ThreadCount);
+/* in the child of a fork, only the thread that forked made it over */
+void WorkQueue_ForgetThreads(void);
+int WorkQueue_GetThreadCount(void);
+
+#endif /* WORK_QUEUE_H */
+
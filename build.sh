@@ -1,6 +1,21 @@
 
-gcc -Wextra -Wall \
-    -I"./external/glad/include/" \
-    ./OpenGL.c ./external/glad/src/glad.c ./App.c\
-    -o ./main \
-    -lglfw
+if [ "$1" = "clean" ]; then
+    rm -f ./main ./headless
+elif [ "$1" = "bench" ]; then
+    # JSON on stdout, the rest of the arguments go to headless, like -t or -k
+    shift
+    sh "$0" headless && ./headless -B "$@"
+elif [ "$1" = "headless" ]; then
+    # no FMA contraction: the SIMD kernels must match the scalar ones bit for bit
+    gcc -O2 -ffp-contract=off -Wextra -Wall \
+        -I"./external/glad/include/" \
+        ./Headless.c ./external/glad/src/glad.c ./App.c ./Renderer.c ./Kernel.c ./Perturbation.c ./BigFix.c ./Profiler.c ./Image.c ./TileCache.c ./ExpMap.c ./WorkQueue.c\
+        -o ./headless \
+        -lpthread -ldl -lm -lz
+else
+    gcc -ffp-contract=off -Wextra -Wall \
+        -I"./external/glad/include/" \
+        ./OpenGL.c ./external/glad/src/glad.c ./App.c ./Renderer.c ./Kernel.c ./Perturbation.c ./BigFix.c ./Profiler.c ./TileCache.c ./WorkQueue.c\
+        -o ./main \
+        -lglfw -lpthread -lm
+fi